@@ -1,13 +1,40 @@
 #version 450
 
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec2 fragTexCoords;
 
+#ifdef BINDLESS
+// All textures in single array, indexed by texture id.
+layout (set = 1, binding = 0) uniform sampler2D textureSamplers[];
+
+// Follows ModelData and MeshData pushed for vertex shader.
+layout (push_constant) uniform PushMaterial
+{
+	layout (offset = 112) uint TextureIndex;
+} pushMaterial;
+#else
 layout (set = 1, binding = 0) uniform sampler2D textureSampler;
+#endif
+
+// Set by pipeline variant (ShaderFeature::AlphaTest).
+layout (constant_id = 1) const bool AlphaTest = false;
 
 layout (location = 0) out vec4 outColor;
 
 void main() 
 {
+#ifdef BINDLESS
+	outColor = texture(textureSamplers[pushMaterial.TextureIndex], fragTexCoords);
+#else
 	outColor = texture(textureSampler, fragTexCoords);
+#endif
+
+	if (AlphaTest && outColor.a < 0.5f)
+	{
+		discard;
+	}
 }
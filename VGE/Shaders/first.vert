@@ -1,8 +1,13 @@
 #version 450
 
+// Attributes are quantized according to engine vertex layout, input assembler converts them to float.
 layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 color;
-layout (location = 2) in vec2 texCoords;
+layout (location = 1) in vec2 texCoords;
+#if defined(VERTEX_NORMAL) && defined(VERTEX_NORMAL_FLOAT)
+layout (location = 2) in vec3 normal;
+#elif defined(VERTEX_NORMAL)
+layout (location = 2) in vec2 octNormal;
+#endif
 
 layout (set = 0, binding = 0) uniform UboViewProjection 
 {
@@ -10,23 +15,44 @@ layout (set = 0, binding = 0) uniform UboViewProjection
 	mat4 View;
 } uboViewProjection;
 
-// Left for reference, NOT used.
-layout (set = 0, binding = 1) uniform UboModel 
-{
-	mat4 Model;
-} uboModel;
-
 layout (push_constant) uniform PushModel 
 {
 	mat4 Model;
+	// Per mesh dequantization.
+	vec4 PositionScale;
+	vec4 PositionOffset;
+	vec4 TexCoordScaleOffset;
 } pushModel;
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 fragTexCoords;
+#ifdef VERTEX_NORMAL
+layout (location = 2) out vec3 fragNormal;
+#endif
+
+#if defined(VERTEX_NORMAL) && !defined(VERTEX_NORMAL_FLOAT)
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+#endif
 
 void main() 
 {
-	gl_Position = uboViewProjection.Projection * uboViewProjection.View * pushModel.Model * vec4(position, 1.0);
-	fragColor = color;
-	fragTexCoords = texCoords;
+	vec3 localPosition = position * pushModel.PositionScale.xyz + pushModel.PositionOffset.xyz;
+
+	gl_Position = uboViewProjection.Projection * uboViewProjection.View * pushModel.Model * vec4(localPosition, 1.0);
+	fragColor = vec3(0.0);
+	fragTexCoords = texCoords * pushModel.TexCoordScaleOffset.xy + pushModel.TexCoordScaleOffset.zw;
+
+#if defined(VERTEX_NORMAL) && defined(VERTEX_NORMAL_FLOAT)
+	fragNormal = normalize(mat3(pushModel.Model) * normal);
+#elif defined(VERTEX_NORMAL)
+	fragNormal = normalize(mat3(pushModel.Model) * DecodeOctahedral(octNormal));
+#endif
 }
@@ -3,14 +3,15 @@
 layout (input_attachment_index = 0, binding = 0) uniform subpassInput inputColor; // color output from 1 subpass
 layout (input_attachment_index = 1, binding = 1) uniform subpassInput inputDepth; // depth output from 1 subpass
 
+// Set by pipeline variant (ShaderFeature::DepthViz), disabled branch is removed on pipeline creation.
+layout (constant_id = 0) const bool DepthViz = false;
+
 layout (location = 0) out vec4 outColor;
 
 void main() 
 {
 	// Apply depth visualization.
-	const bool depthViz = false;
-
-	if (depthViz)
+	if (DepthViz)
 	{
 		const float lowerBound = 0.99f;
 		const float upperBound = 1.0f;
@@ -3,20 +3,31 @@
 
 #include "Application.h"
 #include "EngineLoop.h"
+#include "JobSystem.h"
 #include "Renderer/Window.h"
 #include "Renderer/Device.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/ShaderVariant.h"
+#include "Tools/TextureCooker.h"
+#include "Tools/DecodeBenchmark.h"
+#include "Tools/Benchmark.h"
+#include "Tools/MicroBenchmark.h"
 
 vge::Application::Application(const ApplicationSpecs& specs) : Specs(specs)
 {}
 
 void vge::Application::Initialize()
 {
-#if COMPILE_SHADERS_ON_INIT
-	LOG_RAW("\n----- Shader compilation started -----\n");
-	ENSURE(system("compile_shaders.bat") >= 0);
-	LOG_RAW("\n----- Shader compilation finished -----\n\n");
-#endif
+	CreateJobSystem();
+	ENSURE(GJobSystem);
+	GJobSystem->Initialize();
+
+	if (Specs.Benchmark.Scene)
+	{
+		bench::CreateBenchmark();
+		ENSURE(bench::GBenchmark);
+		bench::GBenchmark->Initialize(Specs);
+	}
 
 	CreateEngineLoop();
 	ENSURE(GEngineLoop);
@@ -26,26 +37,172 @@ void vge::Application::Initialize()
 void vge::Application::Run()
 {
 	GEngineLoop->Start();
+
+	if (bench::GBenchmark)
+	{
+		bench::GBenchmark->Finish();
+	}
 }
 
 void vge::Application::Close()
 {
+	bench::DestroyBenchmark();
 	ENSURE(DestroyEngineLoop());
+	ENSURE(DestroyJobSystem());
 }
 
 bool vge::Application::ShouldClose() const
 {
+	if (Specs.Headless.Enabled && Specs.Headless.FrameCount > 0 && GAppFrame >= Specs.Headless.FrameCount)
+	{
+		return true;
+	}
+
 	return GWindow->ShouldClose();
 }
 
+namespace vge
+{
+	namespace
+	{
+		bool ParsePresentMode(const char* str, PresentMode& outMode)
+		{
+			struct PresentModeName
+			{
+				const char* Name;
+				PresentMode Mode;
+			};
+
+			constexpr PresentModeName presentModeNames[] =
+			{
+				{ "immediate", PresentMode::Immediate },
+				{ "mailbox", PresentMode::Mailbox },
+				{ "fifo", PresentMode::Fifo },
+				{ "fifo_relaxed", PresentMode::FifoRelaxed },
+			};
+
+			for (const PresentModeName& presentModeName : presentModeNames)
+			{
+				if (std::strcmp(str, presentModeName.Name) == 0)
+				{
+					outMode = presentModeName.Mode;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Comma separated feature names, e.g. DepthViz,AlphaTest.
+		void ParseShaderFeatures(const char* str, u32& outFeatures)
+		{
+			const std::string features(str);
+
+			for (size_t begin = 0; begin <= features.size();)
+			{
+				const size_t end = std::min(features.find(',', begin), features.size());
+				const std::string name = features.substr(begin, end - begin);
+				begin = end + 1;
+
+				bool found = false;
+				for (u32 i = 0; i < static_cast<u32>(ShaderFeature::Count); ++i)
+				{
+					if (name == ShaderFeatureToString(static_cast<ShaderFeature>(i)))
+					{
+						outFeatures |= GetFeatureBit(static_cast<ShaderFeature>(i));
+						found = true;
+						break;
+					}
+				}
+
+				if (!found)
+				{
+					LOG(Warning, "Unknown shader feature %s is ignored.", name.c_str());
+				}
+			}
+		}
+
+		// Options: -present=immediate|mailbox|fifo|fifo_relaxed -frames=N -images=N -lowlatency -features=Name,Name -headless -headless_frames=N -readback=N
+		void ParseRenderArgs(int argc, const char** argv, ApplicationSpecs& specs)
+		{
+			for (i32 argIndex = 1; argIndex < argc; ++argIndex)
+			{
+				const char* arg = argv[argIndex];
+
+				if (std::strncmp(arg, "-present=", 9) == 0)
+				{
+					if (!ParsePresentMode(arg + 9, specs.Render.PresentMode))
+					{
+						LOG(Warning, "Unknown present mode %s, default one is used.", arg + 9);
+					}
+				}
+				else if (std::strncmp(arg, "-frames=", 8) == 0)
+				{
+					specs.Render.FramesInFlight = static_cast<u32>(std::atoi(arg + 8));
+				}
+				else if (std::strncmp(arg, "-images=", 8) == 0)
+				{
+					specs.Render.SwapchainImageCount = static_cast<u32>(std::atoi(arg + 8));
+				}
+				else if (std::strcmp(arg, "-lowlatency") == 0)
+				{
+					specs.Render.LowLatency = true;
+				}
+				else if (std::strncmp(arg, "-features=", 10) == 0)
+				{
+					ParseShaderFeatures(arg + 10, specs.Render.ShaderFeatures);
+				}
+				else if (std::strcmp(arg, "-headless") == 0)
+				{
+					specs.Headless.Enabled = true;
+				}
+				else if (std::strncmp(arg, "-headless_frames=", 17) == 0)
+				{
+					specs.Headless.FrameCount = static_cast<u32>(std::atoi(arg + 17));
+				}
+				else if (std::strncmp(arg, "-readback=", 10) == 0)
+				{
+					specs.Headless.ReadbackInterval = static_cast<u32>(std::atoi(arg + 10));
+				}
+			}
+		}
+	}
+}
+
 vge::i32 vge::Main(int argc, const char** argv)
 {
+	if (argc > 1 && std::strcmp(argv[1], cook::GCookTexturesArg) == 0)
+	{
+		return cook::CookTexturesMain(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], bench::GBenchDecodeArg) == 0)
+	{
+		return bench::DecodeBenchmarkMain(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], bench::GBenchMicroArg) == 0)
+	{
+		return bench::MicroBenchmarkMain(argc, argv);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], bench::GBenchCompareArg) == 0)
+	{
+		return bench::BenchmarkCompareMain(argc, argv);
+	}
+
 	ApplicationSpecs specs = {};
 	specs.Name = "Vulkan Game Engine";
 	specs.InternalName = "Spicy Cake";
 	specs.Window.Name = "VGE";
 	specs.Window.Width = 800;
 	specs.Window.Height = 600;
+	ParseRenderArgs(argc, argv, specs);
+
+	if (argc > 1 && std::strcmp(argv[1], bench::GBenchSceneArg) == 0 && !bench::ParseBenchmarkArgs(argc, argv, specs))
+	{
+		return EXIT_FAILURE;
+	}
 
 	ENSURE(CreateApplication(specs));
 	GApplication->Initialize();
@@ -8,6 +8,14 @@ namespace vge
 
 	inline u64 GAppFrame = 0;
 
+	enum class PresentMode : u8
+	{
+		Immediate,		// no vsync, may tear
+		Mailbox,		// vsync, newest frame replaces queued one
+		Fifo,			// vsync, always supported
+		FifoRelaxed,	// vsync, late frames are presented right away and may tear
+	};
+
 	struct ApplicationSpecs
 	{
 		struct {
@@ -16,6 +24,28 @@ namespace vge
 			u32 Height = 0;
 		} Window;
 
+		struct {
+			vge::PresentMode PresentMode = vge::PresentMode::Mailbox;	// fifo is used if not supported
+			u32 FramesInFlight = 3;
+			u32 SwapchainImageCount = 0;								// 0 - one more than surface minimum, headless uses at least one per frame in flight
+			bool LowLatency = false;									// wait for previous frame presentation before sampling input
+			u32 ShaderFeatures = 0;										// ShaderFeature bits of initial pipeline variants, toggled at runtime by debug keys
+		} Render;
+
+		// Render to offscreen images without window, surface and present, e.g. for benchmarks and ci on servers without display.
+		struct {
+			bool Enabled = false;
+			u32 FrameCount = 0;											// application closes after this many frames, 0 - never
+			u32 ReadbackInterval = 0;									// read back every n-th frame for image comparison, 0 - never
+			const char* ReadbackDirectory = "Readback";
+		} Headless;
+
+		// Scripted scene benchmark, runs headless and writes per frame statistics on close.
+		struct {
+			const char* Scene = nullptr;								// null - benchmark is disabled
+			const char* Output = "benchmark";							// path of csv and json results without extension
+		} Benchmark;
+
 		const char* Name = "";
 		const char* InternalName = "";
 	};
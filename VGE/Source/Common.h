@@ -2,10 +2,14 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <float.h>
+#include <cstring>
+#include <cassert>
 #include <set>
 #include <queue>
 #include <array>
 #include <vector>
+#include <memory>
 #include <bitset>
 #include <fstream>
 #include <iostream>
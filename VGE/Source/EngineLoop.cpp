@@ -3,8 +3,10 @@
 #include "Profiling.h"
 #include "Game/Camera.h"
 #include "ECS/Coordinator.h"
+#include "Renderer/Window.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/RenderCommon.h"
+#include "Tools/Benchmark.h"
 #include "Components/RenderComponent.h"
 #include "Components/TransformComponent.h"
 
@@ -20,6 +22,12 @@ void vge::EngineLoop::Initialize()
 	m_GameLoop.Initialize();
 	m_RenderLoop.Initialize();
 
+	if (bench::GBenchmark)
+	{
+		bench::GBenchmark->CreateScene(m_GameLoop.GetGameSystem(), m_RenderLoop.GetRenderSystem());
+		return;
+	}
+
 	// Add 1 test entity.
 	const Entity entity = GCoordinator->CreateEntity();
 
@@ -39,7 +47,7 @@ void vge::EngineLoop::Initialize()
 
 void vge::EngineLoop::Start()
 {
-	m_StartTime = static_cast<f32>(glfwGetTime());
+	m_StartTime = static_cast<f32>(GWindow->GetTime());
 
 	while (!GApplication->ShouldClose())
 	{
@@ -59,6 +67,12 @@ void vge::EngineLoop::Start()
 void vge::EngineLoop::Tick()
 {
 	// TODO: make separate threads for game and render.
+	if (bench::GBenchmark)
+	{
+		bench::GBenchmark->Tick();
+	}
+
+	GRenderer->WaitFrameLatency(); // before game loop polls input
 	m_GameLoop.Tick(m_DeltaTime);
 	m_RenderLoop.Tick(m_DeltaTime);
 	// TODO: when separate threads are done - implement their sync.
@@ -77,7 +91,7 @@ void vge::EngineLoop::Destroy()
 
 void vge::EngineLoop::UpdateDeltaTime()
 {
-	const f32 nowTime = static_cast<f32>(glfwGetTime());
+	const f32 nowTime = static_cast<f32>(GWindow->GetTime());
 	m_DeltaTime = nowTime - m_LastTime;
 	m_LastTime = nowTime;
 }
@@ -1,4 +1,5 @@
 #include "File.h"
+#include "Simd.h"
 
 std::vector<char> vge::file::ReadShader(const char* filename)
 {
@@ -21,6 +22,56 @@ std::vector<char> vge::file::ReadShader(const char* filename)
 	return fileBuffer;
 }
 
+bool vge::file::GetTextureInfo(const char* filename, i32& outw, i32& outh, i32& outChannels)
+{
+	if (!stbi_info(filename, &outw, &outh, &outChannels))
+	{
+		LOG(Error, "Failed to read texture info: %s", filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool vge::file::DecodeTexture(const char* filename, u8* dst, size_t dstSize)
+{
+	i32 width = 0, height = 0, channels = 0;
+
+	// Decode rgb sources as is and expand to rgba while writing to destination,
+	// this way we avoid both stb internal conversion and additional copy.
+	stbi_info(filename, &width, &height, &channels);
+	const i32 desiredChannelCount = channels == STBI_rgb ? STBI_rgb : STBI_rgb_alpha;
+
+	stbi_uc* image = stbi_load(filename, &width, &height, &channels, desiredChannelCount);
+
+	if (!image)
+	{
+		LOG(Error, "Failed to load a texture: %s", filename);
+		return false;
+	}
+
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+	if (pixelCount * STBI_rgb_alpha > dstSize)
+	{
+		LOG(Error, "Decoded texture does not fit to given memory: %s", filename);
+		stbi_image_free(image);
+		return false;
+	}
+
+	if (desiredChannelCount == STBI_rgb)
+	{
+		simd::ExpandRgbToRgba(image, dst, pixelCount);
+	}
+	else
+	{
+		memory::Memcopy(dst, image, pixelCount * STBI_rgb_alpha);
+	}
+
+	stbi_image_free(image);
+
+	return true;
+}
+
 stbi_uc* vge::file::LoadTexture(const char* filename, i32& outw, i32& outh, VkDeviceSize& outTextureSize)
 {
 	static constexpr i8 desiredChannelCount = 4; // r g b a
@@ -39,6 +90,125 @@ stbi_uc* vge::file::LoadTexture(const char* filename, i32& outw, i32& outh, VkDe
 	return image;
 }
 
+std::string vge::file::GetCookedTexturePath(const char* filename)
+{
+	std::string path(filename);
+	const size_t extensionPos = path.find_last_of('.');
+	const size_t separatorPos = path.find_last_of("/\\");
+
+	if (extensionPos != std::string::npos && (separatorPos == std::string::npos || extensionPos > separatorPos))
+	{
+		path.erase(extensionPos);
+	}
+
+	path.append(".vtex");
+	return path;
+}
+
+bool vge::file::SaveCookedTexture(const char* filename, const bc::CookedTextureHeader& header, const u8* data)
+{
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOG(Error, "Failed to open a file for writing: %s.", filename);
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(header.DataSize));
+
+	return file.good();
+}
+
+bool vge::file::LoadCookedTextureHeader(const char* filename, bc::CookedTextureHeader& outHeader)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file.read(reinterpret_cast<char*>(&outHeader), sizeof(outHeader));
+
+	if (!file.good() || !outHeader.IsValid())
+	{
+		LOG(Warning, "Invalid cooked texture header: %s.", filename);
+		return false;
+	}
+
+	file.seekg(0, std::ios::end);
+	const u64 fileSize = static_cast<u64>(file.tellg());
+
+	if (fileSize < sizeof(outHeader) + outHeader.DataSize)
+	{
+		LOG(Warning, "Cooked texture data is truncated: %s.", filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool vge::file::LoadCookedTextureData(const char* filename, u8* dst, size_t dstSize)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		LOG(Error, "Failed to open a file: %s.", filename);
+		return false;
+	}
+
+	bc::CookedTextureHeader header = {};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!header.IsValid() || header.DataSize > dstSize)
+	{
+		LOG(Error, "Cooked texture does not fit to given memory: %s.", filename);
+		return false;
+	}
+
+	file.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(header.DataSize));
+
+	if (static_cast<u64>(file.gcount()) != header.DataSize)
+	{
+		LOG(Error, "Cooked texture data is truncated: %s.", filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool vge::file::SaveImagePpm(const char* filename, const u8* rgba, u32 width, u32 height)
+{
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOG(Error, "Failed to open a file for writing: %s.", filename);
+		return false;
+	}
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+
+	std::vector<u8> row(static_cast<size_t>(width) * 3);
+	for (u32 y = 0; y < height; ++y)
+	{
+		const u8* src = rgba + static_cast<size_t>(y) * width * 4;
+		for (u32 x = 0; x < width; ++x)
+		{
+			row[x * 3 + 0] = src[x * 4 + 0];
+			row[x * 3 + 1] = src[x * 4 + 1];
+			row[x * 3 + 2] = src[x * 4 + 2];
+		}
+
+		file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+	}
+
+	return file.good();
+}
+
 const aiScene* vge::file::LoadModel(const char* filename, Assimp::Importer& outImporter)
 {
 	const aiScene* scene = outImporter.ReadFile(filename, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
@@ -52,6 +222,39 @@ const aiScene* vge::file::LoadModel(const char* filename, Assimp::Importer& outI
 	return scene;
 }
 
+bool vge::file::ReadBinaryFile(const char* filename, std::vector<u8>& outData)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	const size_t fileSize = static_cast<size_t>(file.tellg());
+	outData.resize(fileSize);
+
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(outData.data()), static_cast<std::streamsize>(fileSize));
+
+	return file.good();
+}
+
+bool vge::file::WriteBinaryFile(const char* filename, const void* data, size_t size)
+{
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOG(Error, "Failed to open a file for writing: %s.", filename);
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+	return file.good();
+}
+
 bool vge::file::SyncReadFile(const char* filePath, u8* buffer, size_t bufferSize, size_t& outBytesRead)
 {
 #pragma warning(suppress : 4996)
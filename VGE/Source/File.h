@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "Renderer/RenderCommon.h"
+#include "Renderer/BlockCompression.h"
 
 namespace vge::file
 {
@@ -10,7 +11,26 @@ namespace vge::file
 	stbi_uc* LoadTexture(const char* filename, i32& outw, i32& outh, VkDeviceSize& outTextureSize);
 	inline void FreeTexture(stbi_uc* data) { stbi_image_free(data); }
 
+	// Read only image header to know decoded size before allocating destination memory.
+	bool GetTextureInfo(const char* filename, i32& outw, i32& outh, i32& outChannels);
+	// Decode texture as R8G8B8A8 directly to given memory (e.g. mapped stage buffer) of at least w * h * 4 bytes.
+	bool DecodeTexture(const char* filename, u8* dst, size_t dstSize);
+
+	// Path of cooked texture next to the source one, e.g. Textures/wall.png -> Textures/wall.vtex.
+	std::string GetCookedTexturePath(const char* filename);
+	bool SaveCookedTexture(const char* filename, const bc::CookedTextureHeader& header, const u8* data);
+	bool LoadCookedTextureHeader(const char* filename, bc::CookedTextureHeader& outHeader);
+	// Read block data of cooked texture to given memory of at least header.DataSize bytes.
+	bool LoadCookedTextureData(const char* filename, u8* dst, size_t dstSize);
+
+	// Write tightly packed R8G8B8A8 pixels as binary ppm without alpha, lossless and trivial to compare.
+	bool SaveImagePpm(const char* filename, const u8* rgba, u32 width, u32 height);
+
 	const aiScene* LoadModel(const char* filename, Assimp::Importer& outImporter);
 
+	// Whole file read/write for small binary blobs (e.g. pipeline cache).
+	bool ReadBinaryFile(const char* filename, std::vector<u8>& outData);
+	bool WriteBinaryFile(const char* filename, const void* data, size_t size);
+
 	bool SyncReadFile(const char* filePath, u8* buffer, size_t bufferSize, size_t& rBytesRead);
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Common.h"
+#include "ECS/Entity.h"
+#include "ECS/Coordinator.h"
+
+namespace vge
+{
+	// Makes transform of entity relative to its parent, entities without it are roots.
+	// Parent must have transform component, otherwise entity is treated as root.
+	struct HierarchyComponent
+	{
+	public:
+		Entity Parent = GNullEntity;
+	};
+}
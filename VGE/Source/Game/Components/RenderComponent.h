@@ -10,5 +10,6 @@ namespace vge
 	{
 	public:
 		i32 ModelId = INDEX_NONE;
+		u32 LodIndex = 0; // selected by render system each frame
 	};
 }
@@ -17,6 +17,7 @@ namespace vge
 		// Matrix corresponds to Translate * Ry * Rx * Rz * Scale.
 		// Rotations correspond to Tait-bryan angles of Y(1), X(2), Z(3).
 		// https://en.wikipedia.org/wiki/Euler_angles#Rotation_matrix.
+		// TransformBatch computes the same matrix for many transforms at once.
 		glm::mat4 GetMat4() const;
 
 		inline void ClampRotation(f32 degrees)
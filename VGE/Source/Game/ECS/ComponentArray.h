@@ -16,7 +16,8 @@ namespace vge
 	class ComponentArray : public IComponentArray
 	{
 	public:
-		inline void Add(Entity entity, const T& component)
+		// Added component counts as changed at given version.
+		inline void Add(Entity entity, const T& component, u64 version = 0)
 		{
 			ASSERT(m_EntityToIndex.find(entity) == m_EntityToIndex.end());
 
@@ -24,6 +25,8 @@ namespace vge
 			m_EntityToIndex[entity] = newIndex;
 			m_IndexToEntity[newIndex] = entity;
 			m_Components[newIndex] = component;
+			m_Versions[newIndex] = version;
+			m_LastChangeVersion = std::max(m_LastChangeVersion, version);
 
 			++m_Size;
 		}
@@ -35,6 +38,7 @@ namespace vge
 			size_t indexOfRemovedEntity = m_EntityToIndex[entity];
 			size_t indexOfLastElement = m_Size - 1;
 			m_Components[indexOfRemovedEntity] = m_Components[indexOfLastElement];
+			m_Versions[indexOfRemovedEntity] = m_Versions[indexOfLastElement];
 
 			Entity entityOfLastElement = m_IndexToEntity[indexOfLastElement];
 			m_EntityToIndex[entityOfLastElement] = indexOfRemovedEntity;
@@ -56,6 +60,36 @@ namespace vge
 			return nullptr;
 		}
 
+		// Components are modified through pointers from Get, so writer has to mark change explicitly.
+		inline void MarkChanged(Entity entity, u64 version)
+		{
+			const auto it = m_EntityToIndex.find(entity);
+			if (it != m_EntityToIndex.end())
+			{
+				m_Versions[it->second] = version;
+				m_LastChangeVersion = std::max(m_LastChangeVersion, version);
+			}
+		}
+
+		// Call functor(entity, component) for each component added or changed after given version, removed ones are not reported.
+		// Returns right away if nothing has changed, so unchanged components cost nothing.
+		template<typename Functor>
+		inline void ForEachChanged(u64 sinceVersion, Functor functor)
+		{
+			if (m_LastChangeVersion <= sinceVersion)
+			{
+				return;
+			}
+
+			for (size_t index = 0; index < m_Size; ++index)
+			{
+				if (m_Versions[index] > sinceVersion)
+				{
+					functor(m_IndexToEntity[index], m_Components[index]);
+				}
+			}
+		}
+
 		inline void EntityDestroyed(Entity entity) override
 		{
 			if (m_EntityToIndex.find(entity) != m_EntityToIndex.end())
@@ -67,6 +101,8 @@ namespace vge
 	private:
 		size_t m_Size = 0;
 		std::array<T, GMaxEntities> m_Components = {};
+		std::array<u64, GMaxEntities> m_Versions = {};		// change version of component at the same index
+		u64 m_LastChangeVersion = 0;
 		std::unordered_map<Entity, size_t> m_EntityToIndex = {};
 		std::unordered_map<size_t, Entity> m_IndexToEntity = {};
 	};
@@ -33,9 +33,9 @@ namespace vge
 		}
 
 		template<typename T>
-		void Add(Entity entity, const T& component)
+		void Add(Entity entity, const T& component, u64 version)
 		{
-			GetComponentArray<T>()->Add(entity, component);
+			GetComponentArray<T>()->Add(entity, component, version);
 		}
 
 		template<typename T>
@@ -55,6 +55,21 @@ namespace vge
 			return nullptr;
 		}
 
+		template<typename T>
+		void MarkChanged(Entity entity, u64 version)
+		{
+			GetComponentArray<T>()->MarkChanged(entity, version);
+		}
+
+		template<typename T, typename Functor>
+		void ForEachChanged(u64 sinceVersion, Functor functor)
+		{
+			if (auto compArray = GetComponentArray<T>())
+			{
+				compArray->ForEachChanged(sinceVersion, functor);
+			}
+		}
+
 		void EntityDestroyed(Entity entity)
 		{
 			for (const auto& pair : m_ComponentArrays)
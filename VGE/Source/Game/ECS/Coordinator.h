@@ -34,6 +34,7 @@ namespace vge
 			m_EntityManager->Destroy(entity);
 			m_ComponentManager->EntityDestroyed(entity);
 			m_SystemManager->EntityDestroyed(entity);
+			m_StructureVersion = ++m_ChangeVersion;
 		}
 
 	public:
@@ -46,7 +47,7 @@ namespace vge
 		template<typename T>
 		void AddComponent(Entity entity, const T& component)
 		{
-			m_ComponentManager->Add<T>(entity, component);
+			m_ComponentManager->Add<T>(entity, component, ++m_ChangeVersion);
 
 			auto signature = m_EntityManager->GetSignature(entity);
 			signature.set(m_ComponentManager->GetComponentType<T>(), true);
@@ -59,6 +60,7 @@ namespace vge
 		void RemoveComponent(Entity entity)
 		{
 			m_ComponentManager->Remove<T>(entity);
+			m_StructureVersion = ++m_ChangeVersion;
 
 			auto signature = m_EntityManager->GetSignature(entity);
 			signature.set(m_ComponentManager->GetComponentType<T>(), false);
@@ -79,6 +81,25 @@ namespace vge
 			return m_ComponentManager->GetComponentType<T>();
 		}
 
+	public:
+		// Version of the latest component change. System stores it after processing changes and passes it as since version next time.
+		inline u64 GetChangeVersion() const { return m_ChangeVersion; }
+		// Version of the latest component removal or entity destruction, which are not visible through changed components.
+		inline u64 GetStructureVersion() const { return m_StructureVersion; }
+
+		// Call after modifying component got from GetComponent, so systems see the change.
+		template<typename T>
+		void MarkComponentChanged(Entity entity)
+		{
+			m_ComponentManager->MarkChanged<T>(entity, ++m_ChangeVersion);
+		}
+
+		// Call functor(entity, component) for each component of type added or changed after given version.
+		template<typename T, typename Functor>
+		void ForEachChangedComponent(u64 sinceVersion, Functor functor)
+		{
+			m_ComponentManager->ForEachChanged<T>(sinceVersion, functor);
+		}
 
 	public:
 		template<typename T>
@@ -97,6 +118,8 @@ namespace vge
 		std::unique_ptr<ComponentManager> m_ComponentManager = nullptr;
 		std::unique_ptr<EntityManager> m_EntityManager = nullptr;
 		std::unique_ptr<SystemManager> m_SystemManager = nullptr;
+		u64 m_ChangeVersion = 0;	// incremented by every component add or change
+		u64 m_StructureVersion = 0;
 	};
 
 	inline EcsCoordinator* CreateCoordinator()
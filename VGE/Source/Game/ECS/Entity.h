@@ -6,4 +6,5 @@ namespace vge
 {
 	using Entity = u32;
 	inline constexpr u32 GMaxEntities = 2048;
+	inline constexpr Entity GNullEntity = static_cast<Entity>(INDEX_NONE);
 }
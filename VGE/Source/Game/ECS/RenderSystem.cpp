@@ -1,9 +1,10 @@
 #include "RenderSystem.h"
 #include "Coordinator.h"
 #include "Game/Camera.h"
+#include "Game/TransformHierarchy.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/Culling.h"
 #include "Components/RenderComponent.h"
-#include "Components/TransformComponent.h"
 
 namespace vge
 {
@@ -15,23 +16,27 @@ namespace vge
 		ScopeFrameControl(Renderer* renderer) : m_Renderer(renderer)
 		{
 			Cmd = m_Renderer->BeginFrame();
+			m_IndirectBuffer = m_Renderer->GetCurrentIndirectBuffer();
 			Cmd->BeginRecord();
+			m_Renderer->WriteFrameTimestamp(Cmd, FrameTimestamp::Begin);
 			Cmd->BeginRenderPass(m_Renderer->GetRenderPass(), m_Renderer->GetCurrentFrameBuffer());
 		}
 
 		~ScopeFrameControl()
 		{
 			Cmd->EndRenderPass();
+			m_Renderer->WriteFrameTimestamp(Cmd, FrameTimestamp::End);
 			Cmd->EndRecord();
 			m_Renderer->EndFrame();
 		}
 
-		void RecordCmd(const std::unordered_set<Entity>& entities)
+		// Overflow meshlets storage is owned by caller, so it is not reallocated every frame.
+		void RecordCmd(const std::unordered_set<Entity>& entities, const Camera* camera, std::vector<const Meshlet*>& overflowMeshlets)
 		{
 			RecordCmdPreSubpass();
 
 			i32 pipelineIdx = 0;
-			RecordCmdFirstSubpass(pipelineIdx++, entities);
+			RecordCmdFirstSubpass(pipelineIdx++, entities, camera, overflowMeshlets);
 			RecordCmdSecondSubpass(pipelineIdx++);
 		}
 
@@ -39,6 +44,7 @@ namespace vge
 
 	private:
 		vge::Renderer* m_Renderer = nullptr;
+		vge::IndirectBuffer* m_IndirectBuffer = nullptr;
 
 	private:
 		void RecordCmdPreSubpass()
@@ -50,7 +56,7 @@ namespace vge
 			Cmd->SetScissor(m_Renderer->GetSwapchainExtent());
 		}
 
-		void RecordCmdFirstSubpass(i32 pipelineIdx, const std::unordered_set<Entity>& entities)
+		void RecordCmdFirstSubpass(i32 pipelineIdx, const std::unordered_set<Entity>& entities, const Camera* camera, std::vector<const Meshlet*>& overflowMeshlets)
 		{
 			Pipeline* pipeline = m_Renderer->FindPipeline(pipelineIdx);
 			if (!pipeline)
@@ -60,6 +66,14 @@ namespace vge
 
 			Cmd->Bind(pipeline);
 
+			// Bindless textures are indexed by push constant, so descriptor sets are bound once for all draws.
+			const bool bindless = m_Renderer->IsBindless();
+			if (bindless)
+			{
+				std::vector<VkDescriptorSet> descriptorSets = { m_Renderer->GetCurrentUniformDescriptorSet(), m_Renderer->GetBindlessDescriptorSet() };
+				Cmd->Bind(pipeline, static_cast<u32>(descriptorSets.size()), descriptorSets.data());
+			}
+
 			for (const Entity& entity : entities)
 			{
 				const auto* renderComponent = GCoordinator->GetComponent<RenderComponent>(entity);
@@ -74,8 +88,14 @@ namespace vge
 					continue;
 				}
 
-				const ModelData& modelData = model->GetModelData();
-				Cmd->PushConstants(pipeline, pipeline->GetShader(ShaderStage::Vertex), sizeof(ModelData), &modelData);
+				// Instances share model, so matrix is pushed per entity rather than taken from model.
+				ModelData modelData = model->GetModelData();
+				modelData.ModelMatrix = GTransformHierarchy->GetWorldMatrix(entity);
+				Cmd->PushConstants(pipeline, sizeof(ModelData), &modelData);
+
+				// Meshlets are culled in model space, so their bounds do not need to be transformed.
+				const Frustum frustum = Frustum::Create(camera->GetProjectionMatrix() * camera->GetViewMatrix() * modelData.ModelMatrix);
+				const glm::vec3 cameraPosition = glm::vec3(glm::inverse(camera->GetViewMatrix() * modelData.ModelMatrix)[3]);
 
 				for (size_t MeshIndex = 0; MeshIndex < model->GetMeshCount(); ++MeshIndex)
 				{
@@ -91,13 +111,67 @@ namespace vge
 						continue;
 					}
 
+					const MeshLod& lod = mesh->GetLod(renderComponent->LodIndex);
+					const u32 firstDraw = m_IndirectBuffer->GetDrawCount();
+					overflowMeshlets.clear();
+
+					for (u32 meshletIndex = lod.FirstMeshlet; meshletIndex < lod.FirstMeshlet + lod.MeshletCount; ++meshletIndex)
+					{
+						const Meshlet& meshlet = mesh->GetMeshlet(meshletIndex);
+						if (!frustum.IntersectsSphere(meshlet.Center, meshlet.Radius) ||
+							IsConeBackfacing(meshlet.ConeAxis, meshlet.ConeCutoff, meshlet.Center, meshlet.Radius, cameraPosition))
+						{
+							continue;
+						}
+
+						VkDrawIndexedIndirectCommand command = {};
+						command.indexCount = meshlet.IndexCount;
+						command.instanceCount = 1;
+						command.firstIndex = meshlet.FirstIndex;
+
+						if (!m_IndirectBuffer->Push(command))
+						{
+							overflowMeshlets.push_back(&meshlet);
+						}
+					}
+
+					const u32 drawCount = m_IndirectBuffer->GetDrawCount() - firstDraw;
+					if (lod.MeshletCount > 0 && drawCount == 0 && overflowMeshlets.empty())
+					{
+						continue;
+					}
+
+					const MeshData& meshData = mesh->GetMeshData();
+					Cmd->PushConstants(pipeline, sizeof(MeshData), &meshData, sizeof(ModelData));
+
 					std::vector<const VertexBuffer*> vertBuffers = { mesh->GetVertexBuffer() };
-					Cmd->Bind(static_cast<u32>(vertBuffers.size()), vertBuffers.data(), pipeline->GetShader(ShaderStage::Vertex));
+					Cmd->Bind(static_cast<u32>(vertBuffers.size()), vertBuffers.data());
 					Cmd->Bind(mesh->GetIndexBuffer());
 
-					std::vector<VkDescriptorSet> descriptorSets = { m_Renderer->GetCurrentUniformDescriptorSet(), texture->GetDescriptor() };
-					Cmd->Bind(pipeline, static_cast<u32>(descriptorSets.size()), descriptorSets.data());
-					Cmd->DrawIndexed(static_cast<u32>(mesh->GetIndexCount()));
+					if (bindless)
+					{
+						MaterialData materialData = {};
+						materialData.TextureIndex = static_cast<u32>(texture->GetId());
+						Cmd->PushConstants(pipeline, sizeof(MaterialData), &materialData, sizeof(ModelData) + sizeof(MeshData));
+					}
+					else
+					{
+						std::vector<VkDescriptorSet> descriptorSets = { m_Renderer->GetCurrentUniformDescriptorSet(), texture->GetDescriptor() };
+						Cmd->Bind(pipeline, static_cast<u32>(descriptorSets.size()), descriptorSets.data());
+					}
+
+					if (lod.MeshletCount == 0)
+					{
+						Cmd->DrawIndexed(lod.IndexCount, 1, lod.FirstIndex);
+						continue;
+					}
+
+					Cmd->DrawIndexedIndirect(m_IndirectBuffer, firstDraw, drawCount);
+
+					for (const Meshlet* meshlet : overflowMeshlets)
+					{
+						Cmd->DrawIndexed(meshlet->IndexCount, 1, meshlet->FirstIndex);
+					}
 				}
 			}
 		}
@@ -134,25 +208,84 @@ void vge::RenderSystem::Tick(f32 deltaTime)
 	//m_Renderer->SetView(m_Camera->GetViewMatrix());
 	//m_Renderer->SetProjection(m_Camera->GetProjectionMatrix());
 
-	// TODO: transfer model data update to separate system etc.
-	for (const Entity& entity : m_Entities)
+	const f32 viewportHeight = static_cast<f32>(m_Renderer->GetSwapchainExtent().height);
+
+	CollectUpdatedEntities();
+	UpdateLods(viewportHeight);
+
+	ScopeFrameControl scopeFrame(m_Renderer);
+	scopeFrame.RecordCmd(m_Entities, m_Camera, m_OverflowMeshlets);
+	scopeFrame.UpdateUniforms();
+}
+
+void vge::RenderSystem::CollectUpdatedEntities()
+{
+	m_UpdatedEntities.clear();
+	m_UpdatedEntityMask.reset();
+
+	auto collectEntity = [this](Entity entity)
 	{
-		const auto* renderComponent = GCoordinator->GetComponent<RenderComponent>(entity);
-		if (!renderComponent)
+		if (m_UpdatedEntityMask.test(entity) || m_Entities.find(entity) == m_Entities.end())
 		{
-			continue;
+			return;
 		}
 
-		const auto* transformComponent = GCoordinator->GetComponent<TransformComponent>(entity);
-		if (!transformComponent)
+		if (!GCoordinator->GetComponent<RenderComponent>(entity))
 		{
-			continue;
+			return;
 		}
 
-		m_Renderer->UpdateModelMatrix(renderComponent->ModelId, transformComponent->GetMat4());
+		m_UpdatedEntityMask.set(entity);
+		m_UpdatedEntities.push_back(entity);
+	};
+
+	// Hierarchy is updated by game loop, its changed entities include children of moved parents.
+	// New render component means new model, which needs lod even if entity has not moved.
+	for (const Entity entity : GTransformHierarchy->GetChangedEntities())
+	{
+		collectEntity(entity);
 	}
 
-	ScopeFrameControl scopeFrame(m_Renderer);
-	scopeFrame.RecordCmd(m_Entities);
-	scopeFrame.UpdateUniforms();
+	GCoordinator->ForEachChangedComponent<RenderComponent>(m_LastChangeVersion, [&collectEntity](Entity entity, const RenderComponent&) { collectEntity(entity); });
+	m_LastChangeVersion = GCoordinator->GetChangeVersion();
+}
+
+void vge::RenderSystem::UpdateLods(f32 viewportHeight)
+{
+	const glm::mat4& view = m_Camera->GetViewMatrix();
+	const glm::mat4& projection = m_Camera->GetProjectionMatrix();
+
+	auto selectLod = [&](Entity entity)
+	{
+		auto* renderComponent = GCoordinator->GetComponent<RenderComponent>(entity);
+		if (!renderComponent)
+		{
+			return;
+		}
+
+		if (const Model* model = m_Renderer->FindModel(renderComponent->ModelId))
+		{
+			renderComponent->LodIndex = model->SelectLod(GTransformHierarchy->GetWorldMatrix(entity), view, projection, viewportHeight, renderComponent->LodIndex);
+		}
+	};
+
+	// Lod depends on camera too, so all entities are checked only when it has moved, otherwise just the moved ones.
+	if (view != m_LodView || projection != m_LodProjection || viewportHeight != m_LodViewportHeight)
+	{
+		m_LodView = view;
+		m_LodProjection = projection;
+		m_LodViewportHeight = viewportHeight;
+
+		for (const Entity& entity : m_Entities)
+		{
+			selectLod(entity);
+		}
+	}
+	else
+	{
+		for (const Entity entity : m_UpdatedEntities)
+		{
+			selectLod(entity);
+		}
+	}
 }
@@ -8,6 +8,7 @@ namespace vge
 	class Renderer;
 	class Camera;
 	class CommandBuffer;
+	struct Meshlet;
 
 	class RenderSystem : public System
 	{
@@ -16,8 +17,28 @@ namespace vge
 		void Initialize(Renderer* renderer, Camera* camera);
 		void Tick(f32 deltaTime);
 
+	private:
+		// Gather entities moved by transform hierarchy or whose render component was added or changed since last tick, their lods are reselected.
+		// Entity added to system by hand must be added before its components, so that they are seen as changed.
+		void CollectUpdatedEntities();
+		void UpdateLods(f32 viewportHeight);
+
 	private:
 		Renderer* m_Renderer = nullptr;
 		Camera* m_Camera = nullptr;
+
+		u64 m_LastChangeVersion = 0;
+
+		// Rebuilt every tick from changed entities only.
+		std::vector<Entity> m_UpdatedEntities = {};
+		std::bitset<GMaxEntities> m_UpdatedEntityMask = {};
+
+		// Meshlets not fitting to indirect buffer, drawn directly. Reused for every mesh.
+		std::vector<const Meshlet*> m_OverflowMeshlets = {};
+
+		// Camera of the last full lod selection.
+		glm::mat4 m_LodView = glm::mat4(0.0f);
+		glm::mat4 m_LodProjection = glm::mat4(0.0f);
+		f32 m_LodViewportHeight = 0.0f;
 	};
 }
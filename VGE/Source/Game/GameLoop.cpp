@@ -2,12 +2,15 @@
 #include "Application.h"
 #include "ECS/Coordinator.h"
 #include "Renderer/Window.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
 #include "Components/TransformComponent.h"
+#include "Components/HierarchyComponent.h"
 
 void vge::GameLoop::Initialize()
 {
 	const ApplicationSpecs& appSpecs = GApplication->Specs;
-	CreateWindow(appSpecs.Window.Name, appSpecs.Window.Width, appSpecs.Window.Height);
+	CreateWindow(appSpecs.Window.Name, appSpecs.Window.Width, appSpecs.Window.Height, appSpecs.Headless.Enabled);
 	ENSURE(GWindow);
 	GWindow->Initialize();
 
@@ -17,16 +20,24 @@ void vge::GameLoop::Initialize()
 
 	RegisterDefaultComponents();
 	RegisterGameSystem();
+
+	CreateTransformHierarchy();
+	ENSURE(GTransformHierarchy);
+	GTransformHierarchy->Initialize();
 }
 
 void vge::GameLoop::Tick(f32 deltaTime)
 {
 	GWindow->PollEvents();
 	m_GameSystem->Tick(deltaTime);
+
+	// After game logic has moved entities, so render system sees final world matrices.
+	GTransformHierarchy->Update(GJobSystem);
 }
 
 void vge::GameLoop::Destroy()
 {
+	DestroyTransformHierarchy();
 	DestroyCoordinator();
 	DestroyWindow();
 }
@@ -34,6 +45,7 @@ void vge::GameLoop::Destroy()
 void vge::GameLoop::RegisterDefaultComponents() const
 {
 	GCoordinator->RegisterComponent<TransformComponent>();
+	GCoordinator->RegisterComponent<HierarchyComponent>();
 }
 
 void vge::GameLoop::RegisterGameSystem()
@@ -5,32 +5,39 @@
 
 namespace vge
 {
-	void UpdateRotation(vge::TransformComponent* outTransform, f32 deltaTime, f32 speed, const glm::vec3& rotationVector)
+	// Returns whether transform has changed.
+	bool UpdateRotation(vge::TransformComponent* outTransform, f32 deltaTime, f32 speed, const glm::vec3& rotationVector)
 	{
 		if (!outTransform)
 		{
-			return;
+			return false;
 		}
 
 		if (glm::dot(rotationVector, rotationVector) > FLT_EPSILON)
 		{
 			outTransform->Rotation += speed * deltaTime * glm::normalize(rotationVector);
 			LOG_RAW("Rotation = {%.2f, %.2f, %.2f}\n", outTransform->Rotation.x, outTransform->Rotation.y, outTransform->Rotation.z);
+			return true;
 		}
+
+		return false;
 	}
 
-	void UpdateTranslation(vge::TransformComponent* outTransform, f32 deltaTime, f32 speed, const glm::vec3& moveVector)
+	bool UpdateTranslation(vge::TransformComponent* outTransform, f32 deltaTime, f32 speed, const glm::vec3& moveVector)
 	{
 		if (!outTransform)
 		{
-			return;
+			return false;
 		}
 
 		if (glm::dot(moveVector, moveVector) > FLT_EPSILON)
 		{
 			outTransform->Translation += speed * deltaTime * glm::normalize(moveVector);
 			LOG_RAW("Translation = {%.2f, %.2f, %.2f}\n", outTransform->Translation.x, outTransform->Translation.y, outTransform->Translation.z);
+			return true;
 		}
+
+		return false;
 	}
 }
 
@@ -44,6 +51,7 @@ void vge::InputController::MoveInPlaneXZ(f32 deltaTime, const Entity& entity)
 	}
 
 	GLFWwindow* window = m_Window->GetHandle();
+	bool changed = false;
 
 	// Handle rotation.
 	{
@@ -53,7 +61,7 @@ void vge::InputController::MoveInPlaneXZ(f32 deltaTime, const Entity& entity)
 		if (m_Window->IsKeyPressed(m_KeyboardKeys.LookUp))		rotate.x += m_InvertVerticalAxis ? -1.0f : 1.0f;
 		if (m_Window->IsKeyPressed(m_KeyboardKeys.LookDown))	rotate.x -= m_InvertVerticalAxis ? -1.0f : 1.0f;
 
-		UpdateRotation(transformComponent, deltaTime, m_RotateSpeed, rotate);
+		changed |= UpdateRotation(transformComponent, deltaTime, m_RotateSpeed, rotate);
 		transformComponent->ClampRotation(glm::degrees(glm::two_pi<f32>()));
 	}
 
@@ -73,7 +81,12 @@ void vge::InputController::MoveInPlaneXZ(f32 deltaTime, const Entity& entity)
 		if (m_Window->IsKeyPressed(m_KeyboardKeys.MoveUp))			moveDir += upDir;
 		if (m_Window->IsKeyPressed(m_KeyboardKeys.MoveDown))		moveDir -= upDir;
 
-		UpdateTranslation(transformComponent, deltaTime, m_MoveSpeed, moveDir);
+		changed |= UpdateTranslation(transformComponent, deltaTime, m_MoveSpeed, moveDir);
+	}
+
+	if (changed)
+	{
+		GCoordinator->MarkComponentChanged<TransformComponent>(entity);
 	}
 }
 
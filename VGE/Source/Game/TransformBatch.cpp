@@ -0,0 +1,56 @@
+#include "TransformBatch.h"
+#include "JobSystem.h"
+#include "Components/TransformComponent.h"
+
+void vge::TransformBatch::Reset()
+{
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		m_Translation[axis].clear();
+		m_Rotation[axis].clear();
+		m_Scale[axis].clear();
+	}
+
+	m_Matrices.clear();
+}
+
+vge::u32 vge::TransformBatch::Add(const TransformComponent& transform)
+{
+	for (glm::length_t axis = 0; axis < 3; ++axis)
+	{
+		m_Translation[axis].push_back(transform.Translation[axis]);
+		m_Rotation[axis].push_back(transform.Rotation[axis]);
+		m_Scale[axis].push_back(transform.Scale[axis]);
+	}
+
+	m_Matrices.emplace_back();
+
+	return static_cast<u32>(m_Matrices.size() - 1);
+}
+
+void vge::TransformBatch::Compute(JobSystem* jobSystem /*= nullptr*/)
+{
+	simd::TransformArrays transforms = {};
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		transforms.Translation[axis] = m_Translation[axis].data();
+		transforms.Rotation[axis] = m_Rotation[axis].data();
+		transforms.Scale[axis] = m_Scale[axis].data();
+	}
+
+	const u32 count = GetCount();
+	const u32 chunkCount = (count + GTransformBatchChunkSize - 1) / GTransformBatchChunkSize;
+
+	// Single chunk is not worth job overhead.
+	if (!jobSystem || chunkCount < 2)
+	{
+		simd::ComputeTransformMatrices(transforms, 0, count, m_Matrices.data());
+		return;
+	}
+
+	jobSystem->ParallelFor(chunkCount, [this, &transforms, count](u32 chunk)
+	{
+		const u32 first = chunk * GTransformBatchChunkSize;
+		simd::ComputeTransformMatrices(transforms, first, std::min(GTransformBatchChunkSize, count - first), m_Matrices.data());
+	});
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Common.h"
+#include "Simd.h"
+
+namespace vge
+{
+	struct TransformComponent;
+	class JobSystem;
+
+	// Transforms are processed in chunks of this size by job system jobs.
+	inline constexpr u32 GTransformBatchChunkSize = 512;
+
+	// Computes model matrices of many transforms at once. Components are gathered into structure of arrays,
+	// so matrices are computed by simd kernel, split into job system chunks if there are enough transforms.
+	class TransformBatch
+	{
+	public:
+		TransformBatch() = default;
+		NOT_COPYABLE(TransformBatch);
+
+		// Remove all transforms, memory is kept for the next frame.
+		void Reset();
+		// Returns index of transform matrix.
+		u32 Add(const TransformComponent& transform);
+		// Job system is optional, calling thread computes all matrices without it.
+		void Compute(JobSystem* jobSystem = nullptr);
+
+		inline u32 GetCount() const { return static_cast<u32>(m_Matrices.size()); }
+		// Valid after compute.
+		inline const glm::mat4& GetMatrix(u32 index) const { return m_Matrices[index]; }
+		inline const glm::mat4* GetMatrices() const { return m_Matrices.data(); }
+
+	private:
+		std::array<std::vector<f32>, 3> m_Translation = {};
+		std::array<std::vector<f32>, 3> m_Rotation = {};
+		std::array<std::vector<f32>, 3> m_Scale = {};
+		std::vector<glm::mat4> m_Matrices = {};
+	};
+}
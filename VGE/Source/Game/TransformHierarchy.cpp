@@ -0,0 +1,216 @@
+#include "TransformHierarchy.h"
+#include "ECS/Coordinator.h"
+#include "Components/TransformComponent.h"
+#include "Components/HierarchyComponent.h"
+
+namespace
+{
+	// Depth of entity whose ancestors are being resolved, meeting it again means parent cycle.
+	constexpr vge::i32 GDepthVisiting = -2;
+}
+
+void vge::TransformHierarchy::Initialize()
+{
+	m_Order.reserve(GMaxEntities);
+	m_OrderParents.reserve(GMaxEntities);
+	m_WorldMatrices.reserve(GMaxEntities);
+	m_OrderDirty.reserve(GMaxEntities);
+	m_ChangedEntities.reserve(GMaxEntities);
+}
+
+void vge::TransformHierarchy::Destroy()
+{
+	m_Order.clear();
+	m_OrderParents.clear();
+	m_WorldMatrices.clear();
+	m_OrderDirty.clear();
+	m_ChangedEntities.clear();
+	m_Members.reset();
+	m_LocalDirty.reset();
+}
+
+void vge::TransformHierarchy::Update(JobSystem* jobSystem /*= nullptr*/)
+{
+	m_ChangedEntities.clear();
+
+	// Removed components and destroyed entities can detach children or leave stale entries.
+	bool rebuild = GCoordinator->GetStructureVersion() > m_LastStructureVersion;
+	GCoordinator->ForEachChangedComponent<HierarchyComponent>(m_LastChangeVersion, [&rebuild](Entity, const HierarchyComponent&) { rebuild = true; });
+
+	m_TransformBatch.Reset();
+	m_BatchedEntities.clear();
+
+	GCoordinator->ForEachChangedComponent<TransformComponent>(m_LastChangeVersion, [this, &rebuild](Entity entity, const TransformComponent& transform)
+	{
+		// New entity has to be placed in depth order.
+		rebuild |= !m_Members.test(entity);
+		m_Members.set(entity);
+
+		m_BatchedEntities.push_back(entity);
+		m_TransformBatch.Add(transform);
+	});
+
+	m_LastChangeVersion = GCoordinator->GetChangeVersion();
+	m_LastStructureVersion = GCoordinator->GetStructureVersion();
+
+	if (!rebuild && m_BatchedEntities.empty())
+	{
+		return;
+	}
+
+	m_TransformBatch.Compute(jobSystem);
+
+	for (u32 i = 0; i < m_TransformBatch.GetCount(); ++i)
+	{
+		const Entity entity = m_BatchedEntities[i];
+		m_LocalMatrices[entity] = m_TransformBatch.GetMatrix(i);
+		m_LocalDirty.set(entity);
+	}
+
+	if (rebuild)
+	{
+		Rebuild();
+	}
+
+	Propagate();
+}
+
+const glm::mat4& vge::TransformHierarchy::GetWorldMatrix(Entity entity) const
+{
+	static const glm::mat4 identity = glm::mat4(1.0f);
+
+	if (entity >= GMaxEntities || m_OrderIndices[entity] == INDEX_NONE)
+	{
+		return identity;
+	}
+
+	return m_WorldMatrices[m_OrderIndices[entity]];
+}
+
+void vge::TransformHierarchy::Rebuild()
+{
+	std::vector<Entity> parents(GMaxEntities, GNullEntity);
+	std::vector<i32> depths(GMaxEntities, INDEX_NONE);
+	std::vector<Entity> chain;
+
+	for (Entity entity = 0; entity < GMaxEntities; ++entity)
+	{
+		if (m_Members.test(entity) && !GCoordinator->GetComponent<TransformComponent>(entity))
+		{
+			m_Members.reset(entity);
+		}
+	}
+
+	for (Entity entity = 0; entity < GMaxEntities; ++entity)
+	{
+		if (!m_Members.test(entity))
+		{
+			continue;
+		}
+
+		const auto* hierarchyComponent = GCoordinator->GetComponent<HierarchyComponent>(entity);
+		if (hierarchyComponent && hierarchyComponent->Parent < GMaxEntities && m_Members.test(hierarchyComponent->Parent))
+		{
+			parents[entity] = hierarchyComponent->Parent;
+		}
+	}
+
+	// Walk up to the first ancestor with known depth, then assign depths back down the chain.
+	i32 maxDepth = 0;
+	for (Entity entity = 0; entity < GMaxEntities; ++entity)
+	{
+		if (!m_Members.test(entity) || depths[entity] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		chain.clear();
+		Entity current = entity;
+		while (current != GNullEntity && depths[current] == INDEX_NONE)
+		{
+			depths[current] = GDepthVisiting;
+			chain.push_back(current);
+			current = parents[current];
+		}
+
+		if (current != GNullEntity && depths[current] == GDepthVisiting)
+		{
+			LOG(Warning, "Entity %u is its own ancestor, its parent is ignored.", chain.back());
+			parents[chain.back()] = GNullEntity;
+			current = GNullEntity;
+		}
+
+		i32 depth = current == GNullEntity ? -1 : depths[current];
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+		{
+			depths[*it] = ++depth;
+		}
+
+		maxDepth = std::max(maxDepth, depth);
+	}
+
+	// Counting sort by depth, entities of the same depth stay in entity order.
+	std::vector<u32> depthOffsets(static_cast<size_t>(maxDepth) + 2, 0);
+	for (Entity entity = 0; entity < GMaxEntities; ++entity)
+	{
+		if (m_Members.test(entity))
+		{
+			++depthOffsets[depths[entity] + 1];
+		}
+	}
+
+	for (size_t depth = 1; depth < depthOffsets.size(); ++depth)
+	{
+		depthOffsets[depth] += depthOffsets[depth - 1];
+	}
+
+	const size_t memberCount = m_Members.count();
+	m_Order.resize(memberCount);
+	m_OrderParents.resize(memberCount);
+	m_WorldMatrices.resize(memberCount);
+	m_OrderDirty.resize(memberCount);
+
+	for (Entity entity = 0; entity < GMaxEntities; ++entity)
+	{
+		if (!m_Members.test(entity))
+		{
+			m_OrderIndices[entity] = INDEX_NONE;
+			continue;
+		}
+
+		const u32 index = depthOffsets[depths[entity]]++;
+		m_Order[index] = entity;
+		m_OrderIndices[entity] = static_cast<i32>(index);
+	}
+
+	for (size_t index = 0; index < memberCount; ++index)
+	{
+		const Entity parent = parents[m_Order[index]];
+		m_OrderParents[index] = parent == GNullEntity ? INDEX_NONE : m_OrderIndices[parent];
+	}
+
+	m_LocalDirty = m_Members;
+}
+
+void vge::TransformHierarchy::Propagate()
+{
+	// Parent is always processed before its children, so dirty flag and world matrix of parent are final.
+	for (size_t index = 0; index < m_Order.size(); ++index)
+	{
+		const Entity entity = m_Order[index];
+		const i32 parent = m_OrderParents[index];
+
+		const bool dirty = m_LocalDirty.test(entity) || (parent != INDEX_NONE && m_OrderDirty[parent]);
+		m_OrderDirty[index] = dirty;
+
+		if (!dirty)
+		{
+			continue;
+		}
+
+		m_WorldMatrices[index] = parent == INDEX_NONE ? m_LocalMatrices[entity] : m_WorldMatrices[parent] * m_LocalMatrices[entity];
+		m_ChangedEntities.push_back(entity);
+	}
+
+	m_LocalDirty.reset();
+}
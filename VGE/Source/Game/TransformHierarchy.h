@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Common.h"
+#include "ECS/Entity.h"
+#include "TransformBatch.h"
+
+namespace vge
+{
+	class JobSystem;
+
+	inline class TransformHierarchy* GTransformHierarchy = nullptr;
+
+	// World matrices of all entities with transform, transform of entity with hierarchy component is relative to its parent.
+	// Entities are kept in flat arrays sorted by depth, so parents always precede children and propagation is one linear pass.
+	// Only subtrees of changed transforms are recomputed, static scene costs nothing.
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy() = default;
+		NOT_COPYABLE(TransformHierarchy);
+
+		void Initialize();
+		void Destroy();
+
+		// Recompute world matrices of entities whose transform, parent or any ancestor has changed since last update.
+		// Job system is optional and used only for local matrices.
+		void Update(JobSystem* jobSystem = nullptr);
+
+		// Identity for entities without transform.
+		const glm::mat4& GetWorldMatrix(Entity entity) const;
+		// Entities whose world matrix was recomputed by the last update, parents precede children.
+		inline const std::vector<Entity>& GetChangedEntities() const { return m_ChangedEntities; }
+		inline u32 GetEntityCount() const { return static_cast<u32>(m_Order.size()); }
+
+	private:
+		u64 m_LastChangeVersion = 0;
+		u64 m_LastStructureVersion = 0;
+
+		// Indexed by entity.
+		std::vector<glm::mat4> m_LocalMatrices = std::vector<glm::mat4>(GMaxEntities, glm::mat4(1.0f));
+		std::vector<i32> m_OrderIndices = std::vector<i32>(GMaxEntities, INDEX_NONE);
+		std::bitset<GMaxEntities> m_Members = {};		// entities with transform
+		std::bitset<GMaxEntities> m_LocalDirty = {};
+
+		// Indexed by position in depth order.
+		std::vector<Entity> m_Order = {};
+		std::vector<i32> m_OrderParents = {};			// position of parent, INDEX_NONE for roots
+		std::vector<glm::mat4> m_WorldMatrices = {};
+		std::vector<u8> m_OrderDirty = {};
+
+		// Local matrices of changed transforms, rebuilt every update.
+		TransformBatch m_TransformBatch;
+		std::vector<Entity> m_BatchedEntities = {};
+
+		std::vector<Entity> m_ChangedEntities = {};
+
+	private:
+		// Drop entities without transform, resolve parents and sort by depth, all entities are marked dirty.
+		void Rebuild();
+		void Propagate();
+	};
+
+	inline TransformHierarchy* CreateTransformHierarchy()
+	{
+		if (GTransformHierarchy) return GTransformHierarchy;
+		return (GTransformHierarchy = new TransformHierarchy());
+	}
+
+	inline bool DestroyTransformHierarchy()
+	{
+		if (!GTransformHierarchy) return false;
+		GTransformHierarchy->Destroy();
+		delete GTransformHierarchy;
+		GTransformHierarchy = nullptr;
+		return true;
+	}
+}
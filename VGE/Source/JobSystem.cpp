@@ -0,0 +1,125 @@
+#include "JobSystem.h"
+
+void vge::JobSystem::Initialize(u32 workerCount /*= 0*/)
+{
+	if (workerCount == 0)
+	{
+		const u32 hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_Stopping = false;
+	m_Workers.reserve(workerCount);
+	for (u32 i = 0; i < workerCount; ++i)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerMain, this);
+	}
+
+	LOG(Log, "Job system started with %u workers.", workerCount);
+}
+
+void vge::JobSystem::Destroy()
+{
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_JobAvailable.notify_all();
+
+	for (std::thread& worker : m_Workers)
+	{
+		worker.join();
+	}
+
+	m_Workers.clear();
+}
+
+void vge::JobSystem::Submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Jobs.push(std::move(job));
+		++m_PendingJobCount;
+	}
+	m_JobAvailable.notify_one();
+}
+
+void vge::JobSystem::Wait()
+{
+	while (TryExecuteJob()) {}
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_JobsDone.wait(lock, [this]() { return m_PendingJobCount == 0; });
+}
+
+void vge::JobSystem::ParallelFor(u32 count, const std::function<void(u32)>& func)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		Submit([&func, i]() { func(i); });
+	}
+
+	Wait();
+}
+
+void vge::JobSystem::WorkerMain()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_JobAvailable.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+			if (m_Stopping && m_Jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_Jobs.front());
+			m_Jobs.pop();
+		}
+
+		job();
+		FinishJob();
+	}
+}
+
+bool vge::JobSystem::TryExecuteJob()
+{
+	Job job;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Jobs.empty())
+		{
+			return false;
+		}
+
+		job = std::move(m_Jobs.front());
+		m_Jobs.pop();
+	}
+
+	job();
+	FinishJob();
+
+	return true;
+}
+
+void vge::JobSystem::FinishJob()
+{
+	bool allDone = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		allDone = --m_PendingJobCount == 0;
+	}
+
+	if (allDone)
+	{
+		m_JobsDone.notify_all();
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include "Common.h"
+
+namespace vge
+{
+	inline class JobSystem* GJobSystem = nullptr;
+
+	using Job = std::function<void()>;
+
+	// Simple thread pool with single shared queue, suitable for coarse grained jobs like asset loading.
+	class JobSystem
+	{
+	public:
+		JobSystem() = default;
+		NOT_COPYABLE(JobSystem);
+		NOT_MOVABLE(JobSystem);
+
+		// Worker count of 0 means hardware concurrency minus calling thread.
+		void Initialize(u32 workerCount = 0);
+		void Destroy();
+
+		void Submit(Job job);
+
+		// Block until all submitted jobs are finished, calling thread executes jobs while waiting.
+		void Wait();
+
+		// Run func(index) for each index in [0, count) and wait for completion.
+		void ParallelFor(u32 count, const std::function<void(u32)>& func);
+
+		inline u32 GetWorkerCount() const { return static_cast<u32>(m_Workers.size()); }
+		// Threads that execute jobs during Wait, workers and calling one.
+		inline u32 GetThreadCount() const { return GetWorkerCount() + 1; }
+
+	private:
+		void WorkerMain();
+		bool TryExecuteJob();
+		void FinishJob();
+
+	private:
+		std::vector<std::thread> m_Workers = {};
+		std::queue<Job> m_Jobs = {};
+		std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		std::condition_variable m_JobsDone;
+		u32 m_PendingJobCount = 0;
+		bool m_Stopping = false;
+	};
+
+	inline JobSystem* CreateJobSystem()
+	{
+		if (GJobSystem) return GJobSystem;
+		return (GJobSystem = new JobSystem());
+	}
+
+	inline bool DestroyJobSystem()
+	{
+		if (!GJobSystem) return false;
+		GJobSystem->Destroy();
+		delete GJobSystem;
+		GJobSystem = nullptr;
+		return true;
+	}
+}
@@ -1,5 +1,13 @@
 #include "Logging.h"
-#include "Color.h"
+#include <cstdio>
+
+// Console colors are set through windows console api.
+#if USE_COLORED_LOGS && defined(_WIN32)
+	#include "Color.h"
+	#define PAINT_CONSOLE(Color) std::cout << hue::Color
+#else
+	#define PAINT_CONSOLE(Color)
+#endif
 
 #if USE_LOGGING
 void vge::Logger::PrintLog(const LogCategory category, const char* message, ...)
@@ -39,9 +47,9 @@ void vge::Logger::PaintConsoleText(const LogCategory category)
 	switch (category)
 	{
 	case LogCategory::Warning:
-		std::cout << hue::yellow; return;
+		PAINT_CONSOLE(yellow); return;
 	case LogCategory::Error:
-		std::cout << hue::red; return;
+		PAINT_CONSOLE(red); return;
 	default:
 		return;
 	}
@@ -49,7 +57,7 @@ void vge::Logger::PaintConsoleText(const LogCategory category)
 
 void vge::Logger::PaintDefaultConsoleText()
 {
-	std::cout << hue::reset;
+	PAINT_CONSOLE(reset);
 }
 
 std::string vge::Logger::LogCategoryToString(const LogCategory category)
@@ -57,10 +65,10 @@ std::string vge::Logger::LogCategoryToString(const LogCategory category)
 	switch (category)
 	{
 	case LogCategory::Warning:
-		std::cout << hue::yellow;
+		PAINT_CONSOLE(yellow);
 		return "Warning: ";
 	case LogCategory::Error:
-		std::cout << hue::red;
+		PAINT_CONSOLE(red);
 		return "Error: ";
 	default:
 		PaintDefaultConsoleText();
@@ -68,6 +76,7 @@ std::string vge::Logger::LogCategoryToString(const LogCategory category)
 	}
 }
 
+#if WITH_VULKAN
 void vge::NotifyVulkanEnsureFailure(VkResult result, const char* function, const char* filename, u32 line, const char* errMessage)
 {
 	const char* resultString = nullptr;
@@ -116,3 +125,4 @@ void vge::NotifyVulkanEnsureFailure(VkResult result, const char* function, const
 	DEBUG_BREAK();
 }
 #endif
+#endif
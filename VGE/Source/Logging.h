@@ -1,11 +1,14 @@
 #pragma once
 
-#include <vulkan/vulkan.h>
 #include <cstdarg>
 #include <string>
 #include "Types.h"
 #include "Macros.h"
 
+#if WITH_VULKAN
+	#include <vulkan/vulkan.h>
+#endif
+
 #if DEBUG
 	#define USE_LOGGING 1
 #else
@@ -15,8 +18,8 @@
 #define LOG_VK_VERBOSE 0
 
 #if USE_LOGGING
-	#define LOG(Category, Message, ...)	vge::Logger::PrintLog(vge::LogCategory::Category, Message, __FUNCTION__, __LINE__, __VA_ARGS__);
-	#define LOG_RAW(Message, ...)		vge::Logger::PrintLogRaw(Message, __VA_ARGS__);
+	#define LOG(Category, Message, ...)	vge::Logger::PrintLog(vge::LogCategory::Category, Message, __FUNCTION__, __LINE__, ##__VA_ARGS__);
+	#define LOG_RAW(Message, ...)		vge::Logger::PrintLogRaw(Message, ##__VA_ARGS__);
 #else
 	#define LOG(Category, Message, ...)
 	#define LOG_RAW(Message, ...)
@@ -58,6 +61,8 @@ namespace vge
 		static void PrintLogRaw_Implementation(const char* message, va_list args);
 	};
 
+#if WITH_VULKAN
 	extern void NotifyVulkanEnsureFailure(VkResult result, const char* function, const char* filename, u32 line, const char* errMessage = "");
+#endif
 }
 #endif
@@ -8,8 +8,19 @@
 	#define DEBUG 1
 #endif
 
-#ifndef COMPILE_SHADERS_ON_INIT
-	#define COMPILE_SHADERS_ON_INIT 1
+// Shaders are compiled at build time, this only enables watching sources and recompiling changed ones at runtime.
+#ifndef SHADER_HOT_RELOAD
+	#define SHADER_HOT_RELOAD DEBUG
+#endif
+
+// Address textures by index in single descriptor array if device supports descriptor indexing.
+#ifndef BINDLESS_TEXTURES
+	#define BINDLESS_TEXTURES 1
+#endif
+
+// Renderer and logging of vulkan results, disabled for cpu only tools built without Vulkan SDK.
+#ifndef WITH_VULKAN
+	#define WITH_VULKAN 1
 #endif
 
 // Misc
@@ -37,8 +48,11 @@
 #define ASSERT(expr) assert(expr);
 #define ASSERT_MSG(expr, msg) assert(expr && msg);
 
-// TODO: make support for different CPUs.
-#define DEBUG_BREAK() __debugbreak()
+#if defined(_MSC_VER)
+	#define DEBUG_BREAK() __debugbreak()
+#else
+	#define DEBUG_BREAK() __builtin_trap()
+#endif
 
 #ifndef ENSURE_ENABLED
 	#define ENSURE_ENABLED 1
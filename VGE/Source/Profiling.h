@@ -24,12 +24,12 @@ namespace vge
 	public:
 		ScopeTimer(std::string_view logPrefix) : m_LogPrefix(logPrefix)
 		{
-			m_StartTime = std::chrono::high_resolution_clock::now();
+			m_StartTime = std::chrono::steady_clock::now();
 		}
 
 		~ScopeTimer()
 		{
-			const auto endTime = std::chrono::high_resolution_clock::now();
+			const auto endTime = std::chrono::steady_clock::now();
 			const f32 diffTime = std::chrono::duration<f32, std::chrono::milliseconds::period>(endTime - m_StartTime).count();
 			LOG(Log, "%s: %.2fms", m_LogPrefix.data(), diffTime);
 		}
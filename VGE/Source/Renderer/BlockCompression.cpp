@@ -0,0 +1,520 @@
+#include "BlockCompression.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define USE_SSE2_BLOCK_ENCODER 1
+#else
+	#define USE_SSE2_BLOCK_ENCODER 0
+#endif
+
+namespace
+{
+	constexpr vge::u32 BlockDim = 4;
+	constexpr vge::u32 BlockPixelCount = BlockDim * BlockDim;
+
+	// Per channel min and max of 16 rgba pixels.
+	void GetBlockBounds(const vge::u8* rgbaBlock, vge::u8 outMin[4], vge::u8 outMax[4])
+	{
+#if USE_SSE2_BLOCK_ENCODER
+		const __m128i* pixels = reinterpret_cast<const __m128i*>(rgbaBlock);
+		const __m128i p0 = _mm_loadu_si128(pixels + 0);
+		const __m128i p1 = _mm_loadu_si128(pixels + 1);
+		const __m128i p2 = _mm_loadu_si128(pixels + 2);
+		const __m128i p3 = _mm_loadu_si128(pixels + 3);
+
+		__m128i minv = _mm_min_epu8(_mm_min_epu8(p0, p1), _mm_min_epu8(p2, p3));
+		__m128i maxv = _mm_max_epu8(_mm_max_epu8(p0, p1), _mm_max_epu8(p2, p3));
+
+		// Fold 4 pixels into 1 (each pixel is 4 bytes).
+		minv = _mm_min_epu8(minv, _mm_shuffle_epi32(minv, _MM_SHUFFLE(1, 0, 3, 2)));
+		maxv = _mm_max_epu8(maxv, _mm_shuffle_epi32(maxv, _MM_SHUFFLE(1, 0, 3, 2)));
+		minv = _mm_min_epu8(minv, _mm_shuffle_epi32(minv, _MM_SHUFFLE(2, 3, 0, 1)));
+		maxv = _mm_max_epu8(maxv, _mm_shuffle_epi32(maxv, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		const vge::u32 packedMin = static_cast<vge::u32>(_mm_cvtsi128_si32(minv));
+		const vge::u32 packedMax = static_cast<vge::u32>(_mm_cvtsi128_si32(maxv));
+		vge::memory::Memcopy(outMin, (void*)&packedMin, 4);
+		vge::memory::Memcopy(outMax, (void*)&packedMax, 4);
+#else
+		for (vge::u32 c = 0; c < 4; ++c)
+		{
+			outMin[c] = 255;
+			outMax[c] = 0;
+		}
+
+		for (vge::u32 i = 0; i < BlockPixelCount; ++i)
+		{
+			for (vge::u32 c = 0; c < 4; ++c)
+			{
+				outMin[c] = std::min(outMin[c], rgbaBlock[i * 4 + c]);
+				outMax[c] = std::max(outMax[c], rgbaBlock[i * 4 + c]);
+			}
+		}
+#endif
+	}
+
+	// Move bounds slightly inwards, reduces error as endpoints are rarely hit exactly.
+	void InsetBounds(vge::u8 min[4], vge::u8 max[4], vge::u32 channelCount)
+	{
+		for (vge::u32 c = 0; c < channelCount; ++c)
+		{
+			const vge::i32 inset = (max[c] - min[c]) >> 4;
+			min[c] = static_cast<vge::u8>(min[c] + inset);
+			max[c] = static_cast<vge::u8>(max[c] - inset);
+		}
+	}
+
+	// Bounding box gives only main diagonal, swap channels that are anti-correlated with the widest one.
+	void SelectDiagonal(const vge::u8* rgbaBlock, vge::u8 min[4], vge::u8 max[4], vge::u32 channelCount)
+	{
+		vge::u32 mainChannel = 0;
+		for (vge::u32 c = 1; c < channelCount; ++c)
+		{
+			if (max[c] - min[c] > max[mainChannel] - min[mainChannel])
+			{
+				mainChannel = c;
+			}
+		}
+
+		for (vge::u32 c = 0; c < channelCount; ++c)
+		{
+			if (c == mainChannel) continue;
+
+			const vge::i32 mainCenter = (min[mainChannel] + max[mainChannel]) / 2;
+			const vge::i32 center = (min[c] + max[c]) / 2;
+
+			vge::i32 covariance = 0;
+			for (vge::u32 i = 0; i < BlockPixelCount; ++i)
+			{
+				covariance += (rgbaBlock[i * 4 + mainChannel] - mainCenter) * (rgbaBlock[i * 4 + c] - center);
+			}
+
+			if (covariance < 0)
+			{
+				std::swap(min[c], max[c]);
+			}
+		}
+	}
+
+	inline vge::u16 PackRgb565(const vge::u8 rgb[3])
+	{
+		const vge::u32 r = (rgb[0] * 31 + 127) / 255;
+		const vge::u32 g = (rgb[1] * 63 + 127) / 255;
+		const vge::u32 b = (rgb[2] * 31 + 127) / 255;
+		return static_cast<vge::u16>((r << 11) | (g << 5) | b);
+	}
+
+	inline void UnpackRgb565(vge::u16 color, vge::i32 outRgb[3])
+	{
+		const vge::i32 r = (color >> 11) & 31;
+		const vge::i32 g = (color >> 5) & 63;
+		const vge::i32 b = color & 31;
+		outRgb[0] = (r << 3) | (r >> 2);
+		outRgb[1] = (g << 2) | (g >> 4);
+		outRgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// Color part of BC1/BC3 block, always in 4 color mode.
+	void EncodeColorBlock(const vge::u8* rgbaBlock, vge::u8* outBlock)
+	{
+		vge::u8 min[4], max[4];
+		GetBlockBounds(rgbaBlock, min, max);
+		InsetBounds(min, max, 3);
+		SelectDiagonal(rgbaBlock, min, max, 3);
+
+		vge::u16 color0 = PackRgb565(max);
+		vge::u16 color1 = PackRgb565(min);
+
+		vge::u32 indices = 0;
+
+		if (color0 != color1)
+		{
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			vge::i32 palette[4][3];
+			UnpackRgb565(color0, palette[0]);
+			UnpackRgb565(color1, palette[1]);
+			for (vge::u32 c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+
+			for (vge::u32 i = 0; i < BlockPixelCount; ++i)
+			{
+				const vge::u8* pixel = rgbaBlock + i * 4;
+
+				vge::u32 bestIndex = 0;
+				vge::i32 bestError = INT32_MAX;
+				for (vge::u32 p = 0; p < 4; ++p)
+				{
+					const vge::i32 dr = pixel[0] - palette[p][0];
+					const vge::i32 dg = pixel[1] - palette[p][1];
+					const vge::i32 db = pixel[2] - palette[p][2];
+					const vge::i32 error = dr * dr + dg * dg + db * db;
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+
+				indices |= bestIndex << (i * 2);
+			}
+		}
+
+		outBlock[0] = static_cast<vge::u8>(color0 & 0xFF);
+		outBlock[1] = static_cast<vge::u8>(color0 >> 8);
+		outBlock[2] = static_cast<vge::u8>(color1 & 0xFF);
+		outBlock[3] = static_cast<vge::u8>(color1 >> 8);
+		vge::memory::Memcopy(outBlock + 4, &indices, sizeof(indices));
+	}
+
+	// Single channel block (BC4), used for BC3 alpha and BC5 red/green.
+	void EncodeChannelBlock(const vge::u8* rgbaBlock, vge::u32 channel, vge::u8* outBlock)
+	{
+		vge::u8 min = 255, max = 0;
+		for (vge::u32 i = 0; i < BlockPixelCount; ++i)
+		{
+			min = std::min(min, rgbaBlock[i * 4 + channel]);
+			max = std::max(max, rgbaBlock[i * 4 + channel]);
+		}
+
+		// Use 8 value mode (max > min), 0 - max, 1 - min, 2..7 - interpolated.
+		vge::u64 indices = 0;
+		if (max != min)
+		{
+			vge::i32 palette[8];
+			palette[0] = max;
+			palette[1] = min;
+			for (vge::i32 p = 1; p < 7; ++p)
+			{
+				palette[p + 1] = ((7 - p) * max + p * min + 3) / 7;
+			}
+
+			for (vge::u32 i = 0; i < BlockPixelCount; ++i)
+			{
+				const vge::i32 value = rgbaBlock[i * 4 + channel];
+
+				vge::u64 bestIndex = 0;
+				vge::i32 bestError = INT32_MAX;
+				for (vge::u32 p = 0; p < 8; ++p)
+				{
+					const vge::i32 error = std::abs(value - palette[p]);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+
+				indices |= bestIndex << (i * 3);
+			}
+		}
+
+		outBlock[0] = max;
+		outBlock[1] = min;
+		for (vge::u32 i = 0; i < 6; ++i)
+		{
+			outBlock[2 + i] = static_cast<vge::u8>((indices >> (i * 8)) & 0xFF);
+		}
+	}
+
+	struct BitWriter
+	{
+	public:
+		BitWriter(vge::u8* dst) : m_Dst(dst) { vge::memory::Memzero(m_Dst, 16); }
+
+		void Write(vge::u32 value, vge::u32 bitCount)
+		{
+			for (vge::u32 i = 0; i < bitCount; ++i, ++m_BitPos)
+			{
+				if (value & (1u << i))
+				{
+					m_Dst[m_BitPos >> 3] |= static_cast<vge::u8>(1u << (m_BitPos & 7));
+				}
+			}
+		}
+
+	private:
+		vge::u8* m_Dst = nullptr;
+		vge::u32 m_BitPos = 0;
+	};
+
+	// Quantize 8 bit endpoint to 7 bit + p-bit shared by all channels, returns chosen p-bit.
+	vge::u32 QuantizeEndpointBC7(const vge::u8 endpoint[4], vge::u8 outQuantized[4])
+	{
+		vge::i32 bestError = INT32_MAX;
+		vge::u32 bestPBit = 0;
+
+		for (vge::u32 pbit = 0; pbit < 2; ++pbit)
+		{
+			vge::i32 error = 0;
+			vge::u8 quantized[4];
+			for (vge::u32 c = 0; c < 4; ++c)
+			{
+				const vge::i32 q = std::clamp((endpoint[c] - static_cast<vge::i32>(pbit) + 1) >> 1, 0, 127);
+				const vge::i32 reconstructed = (q << 1) | static_cast<vge::i32>(pbit);
+				error += (endpoint[c] - reconstructed) * (endpoint[c] - reconstructed);
+				quantized[c] = static_cast<vge::u8>(q);
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				bestPBit = pbit;
+				vge::memory::Memcopy(outQuantized, quantized, 4);
+			}
+		}
+
+		return bestPBit;
+	}
+}
+
+bool vge::bc::CookedTextureHeader::IsValid() const
+{
+	// Only top level is uploaded, so files with mip chain would be sampled with undefined levels.
+	if (Magic != MagicValue || Version != CurrentVersion || !IsValidFormat(Format) || Width == 0 || Height == 0 || MipCount != 1)
+	{
+		return false;
+	}
+
+	return DataSize == GetCompressedSize(Format, Width, Height, MipCount);
+}
+
+bool vge::bc::IsValidFormat(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::None:
+	case BlockFormat::BC1:
+	case BlockFormat::BC3:
+	case BlockFormat::BC5:
+	case BlockFormat::BC7:	return true;
+	default:				return false;
+	}
+}
+
+const char* vge::bc::FormatToString(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1:	return "BC1";
+	case BlockFormat::BC3:	return "BC3";
+	case BlockFormat::BC5:	return "BC5";
+	case BlockFormat::BC7:	return "BC7";
+	default:				return "RGBA8";
+	}
+}
+
+vge::bc::BlockFormat vge::bc::FormatFromString(const char* str)
+{
+	if (!str) return BlockFormat::None;
+
+	std::string lower(str);
+	std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (lower == "bc1") return BlockFormat::BC1;
+	if (lower == "bc3") return BlockFormat::BC3;
+	if (lower == "bc5") return BlockFormat::BC5;
+	if (lower == "bc7") return BlockFormat::BC7;
+
+	return BlockFormat::None;
+}
+
+VkFormat vge::bc::FormatToVk(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1:	return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	case BlockFormat::BC3:	return VK_FORMAT_BC3_UNORM_BLOCK;
+	case BlockFormat::BC5:	return VK_FORMAT_BC5_UNORM_BLOCK;
+	case BlockFormat::BC7:	return VK_FORMAT_BC7_UNORM_BLOCK;
+	default:				return VK_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
+vge::u32 vge::bc::GetBlockSize(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1:	return 8;
+	case BlockFormat::BC3:	return 16;
+	case BlockFormat::BC5:	return 16;
+	case BlockFormat::BC7:	return 16;
+	default:				return 4;
+	}
+}
+
+size_t vge::bc::GetCompressedSize(BlockFormat format, u32 width, u32 height, u32 mipCount /*= 1*/)
+{
+	size_t size = 0;
+
+	for (u32 mip = 0; mip < mipCount; ++mip)
+	{
+		const size_t mipWidth = std::max(width >> mip, 1u);
+		const size_t mipHeight = std::max(height >> mip, 1u);
+
+		if (format == BlockFormat::None)
+		{
+			size += mipWidth * mipHeight * GetBlockSize(format);
+			continue;
+		}
+
+		const size_t blocksX = (mipWidth + BlockDim - 1) / BlockDim;
+		const size_t blocksY = (mipHeight + BlockDim - 1) / BlockDim;
+		size += blocksX * blocksY * GetBlockSize(format);
+	}
+
+	return size;
+}
+
+void vge::bc::CompressImage(BlockFormat format, const u8* rgba, u32 width, u32 height, std::vector<u8>& outBlocks)
+{
+	outBlocks.resize(GetCompressedSize(format, width, height));
+
+	if (format == BlockFormat::None)
+	{
+		memory::Memcopy(outBlocks.data(), (void*)rgba, outBlocks.size());
+		return;
+	}
+
+	const u32 blockSize = GetBlockSize(format);
+	const u32 blocksX = (width + BlockDim - 1) / BlockDim;
+	const u32 blocksY = (height + BlockDim - 1) / BlockDim;
+
+	alignas(16) u8 block[BlockPixelCount * 4];
+	u8* dst = outBlocks.data();
+
+	for (u32 by = 0; by < blocksY; ++by)
+	{
+		for (u32 bx = 0; bx < blocksX; ++bx)
+		{
+			// Gather 4x4 pixels, clamp to image edge.
+			for (u32 y = 0; y < BlockDim; ++y)
+			{
+				const u32 srcY = std::min(by * BlockDim + y, height - 1);
+				for (u32 x = 0; x < BlockDim; ++x)
+				{
+					const u32 srcX = std::min(bx * BlockDim + x, width - 1);
+					const u8* srcPixel = rgba + (static_cast<size_t>(srcY) * width + srcX) * 4;
+					memory::Memcopy(block + (y * BlockDim + x) * 4, (void*)srcPixel, 4);
+				}
+			}
+
+			switch (format)
+			{
+			case BlockFormat::BC1: EncodeBC1Block(block, dst); break;
+			case BlockFormat::BC3: EncodeBC3Block(block, dst); break;
+			case BlockFormat::BC5: EncodeBC5Block(block, dst); break;
+			case BlockFormat::BC7: EncodeBC7Block(block, dst); break;
+			default: break;
+			}
+
+			dst += blockSize;
+		}
+	}
+}
+
+void vge::bc::EncodeBC1Block(const u8* rgbaBlock, u8* outBlock)
+{
+	EncodeColorBlock(rgbaBlock, outBlock);
+}
+
+void vge::bc::EncodeBC3Block(const u8* rgbaBlock, u8* outBlock)
+{
+	EncodeChannelBlock(rgbaBlock, 3, outBlock);
+	EncodeColorBlock(rgbaBlock, outBlock + 8);
+}
+
+void vge::bc::EncodeBC5Block(const u8* rgbaBlock, u8* outBlock)
+{
+	EncodeChannelBlock(rgbaBlock, 0, outBlock);
+	EncodeChannelBlock(rgbaBlock, 1, outBlock + 8);
+}
+
+// Only mode 6 is used (single subset, rgba 7.7.7.7 endpoints with p-bits and 4 bit indices).
+// It is not the best mode for every block, but gives good quality for its simplicity.
+void vge::bc::EncodeBC7Block(const u8* rgbaBlock, u8* outBlock)
+{
+	static constexpr i32 Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	u8 min[4], max[4];
+	GetBlockBounds(rgbaBlock, min, max);
+	InsetBounds(min, max, 4);
+	SelectDiagonal(rgbaBlock, min, max, 4);
+
+	u8 endpoints[2][4];
+	u32 pbits[2];
+	pbits[0] = QuantizeEndpointBC7(min, endpoints[0]);
+	pbits[1] = QuantizeEndpointBC7(max, endpoints[1]);
+
+	i32 palette[16][4];
+	for (u32 p = 0; p < 16; ++p)
+	{
+		for (u32 c = 0; c < 4; ++c)
+		{
+			const i32 e0 = (endpoints[0][c] << 1) | pbits[0];
+			const i32 e1 = (endpoints[1][c] << 1) | pbits[1];
+			palette[p][c] = ((64 - Weights[p]) * e0 + Weights[p] * e1 + 32) >> 6;
+		}
+	}
+
+	u32 indices[BlockPixelCount];
+	for (u32 i = 0; i < BlockPixelCount; ++i)
+	{
+		const u8* pixel = rgbaBlock + i * 4;
+
+		u32 bestIndex = 0;
+		i32 bestError = INT32_MAX;
+		for (u32 p = 0; p < 16; ++p)
+		{
+			i32 error = 0;
+			for (u32 c = 0; c < 4; ++c)
+			{
+				const i32 d = pixel[c] - palette[p][c];
+				error += d * d;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+
+		indices[i] = bestIndex;
+	}
+
+	// Anchor index (first pixel) is stored without its highest bit, so it must be less than 8.
+	if (indices[0] & 8)
+	{
+		std::swap(endpoints[0], endpoints[1]);
+		std::swap(pbits[0], pbits[1]);
+		for (u32& index : indices)
+		{
+			index = 15 - index;
+		}
+	}
+
+	BitWriter writer(outBlock);
+	writer.Write(1 << 6, 7); // mode 6
+
+	for (u32 c = 0; c < 4; ++c)
+	{
+		writer.Write(endpoints[0][c], 7);
+		writer.Write(endpoints[1][c], 7);
+	}
+
+	writer.Write(pbits[0], 1);
+	writer.Write(pbits[1], 1);
+
+	writer.Write(indices[0], 3);
+	for (u32 i = 1; i < BlockPixelCount; ++i)
+	{
+		writer.Write(indices[i], 4);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge::bc
+{
+	// Block compressed formats that can be produced by the texture cooker.
+	enum class BlockFormat : u32
+	{
+		None = 0,	// raw R8G8B8A8, no compression
+
+		BC1 = 1,	// rgb, 4 bpp
+		BC3 = 3,	// rgba, 8 bpp
+		BC5 = 5,	// rg (normal maps), 8 bpp
+		BC7 = 7,	// rgba high quality, 8 bpp
+	};
+
+	// Header of cooked texture file (*.vtex). Block data for each mip level follows it tightly packed.
+	struct CookedTextureHeader
+	{
+		static constexpr u32 MagicValue = 0x54454756; // "VGET"
+		static constexpr u32 CurrentVersion = 1;
+
+		u32 Magic = MagicValue;
+		u32 Version = CurrentVersion;
+		BlockFormat Format = BlockFormat::None;
+		u32 Width = 0;
+		u32 Height = 0;
+		u32 MipCount = 1;	// only single level is supported
+		u64 DataSize = 0;
+
+		// Data size must match format, dimensions and mip count exactly, as it is uploaded without further checks.
+		bool IsValid() const;
+	};
+
+	bool IsValidFormat(BlockFormat format);
+	const char* FormatToString(BlockFormat format);
+	BlockFormat FormatFromString(const char* str);
+	VkFormat FormatToVk(BlockFormat format);
+
+	// Size in bytes of one 4x4 block, or of one pixel for uncompressed format.
+	u32 GetBlockSize(BlockFormat format);
+	// Sum of all mip levels, each level halves dimensions down to 1.
+	size_t GetCompressedSize(BlockFormat format, u32 width, u32 height, u32 mipCount = 1);
+
+	// Compress tightly packed R8G8B8A8 pixels to given block format.
+	// Edge blocks of images with dimensions not multiple of 4 are padded by clamping.
+	void CompressImage(BlockFormat format, const u8* rgba, u32 width, u32 height, std::vector<u8>& outBlocks);
+
+	// Encode one 4x4 block of R8G8B8A8 pixels (64 bytes) to given output.
+	void EncodeBC1Block(const u8* rgbaBlock, u8* outBlock);
+	void EncodeBC3Block(const u8* rgbaBlock, u8* outBlock);
+	void EncodeBC5Block(const u8* rgbaBlock, u8* outBlock);
+	void EncodeBC7Block(const u8* rgbaBlock, u8* outBlock);
+}
@@ -2,6 +2,7 @@
 #include "Device.h"
 #include "Logging.h"
 #include "CommandBuffer.h"
+#include "VertexLayout.h"
 
 vge::Buffer vge::Buffer::Create(const BufferCreateInfo& data)
 {
@@ -13,6 +14,7 @@ vge::Buffer vge::Buffer::Create(const BufferCreateInfo& data)
 
 	VmaAllocationCreateInfo vmaAllocCreateInfo = {};
 	vmaAllocCreateInfo.usage = data.MemAllocUsage;
+	vmaAllocCreateInfo.flags = data.MemAllocFlags;
 
 	Buffer buffer = {};
 	buffer.m_Allocator = data.Device->GetAllocator();
@@ -82,38 +84,7 @@ vge::ScopeStageBuffer::ScopeStageBuffer(const Device* device, VkDeviceSize size)
 
 vge::VertexInputDescription vge::Vertex::GetDescription()
 {
-	VertexInputDescription description = {};
-
-	VkVertexInputBindingDescription mainDescription = {};
-	mainDescription.binding = 0;
-	mainDescription.stride = sizeof(Vertex);
-	mainDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-	description.Bindings.push_back(mainDescription);
-
-	VkVertexInputAttributeDescription positionAttribute = {};
-	positionAttribute.binding = 0;
-	positionAttribute.location = 0;
-	positionAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-	positionAttribute.offset = offsetof(Vertex, Position);
-
-	VkVertexInputAttributeDescription colorAttribute = {};
-	colorAttribute.binding = 0;
-	colorAttribute.location = 1;
-	colorAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-	colorAttribute.offset = offsetof(Vertex, Color);
-
-	VkVertexInputAttributeDescription textureAttribute = {};
-	textureAttribute.binding = 0;
-	textureAttribute.location = 2;
-	textureAttribute.format = VK_FORMAT_R32G32_SFLOAT;
-	textureAttribute.offset = offsetof(Vertex, TexCoords);
-
-	description.Attributes.push_back(positionAttribute);
-	description.Attributes.push_back(colorAttribute);
-	description.Attributes.push_back(textureAttribute);
-
-	return description;
+	return GVertexLayout.GetDescription();
 }
 
 vge::IndexBuffer vge::IndexBuffer::Create(const Device* device, const std::vector<u32>& indices)
@@ -123,10 +94,21 @@ vge::IndexBuffer vge::IndexBuffer::Create(const Device* device, const std::vecto
 
 vge::IndexBuffer vge::IndexBuffer::Create(const Device* device, size_t indexCount, const u32* indices)
 {
-	const VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
+	const VkIndexType indexType = SelectIndexType(indexCount, indices);
+	const VkDeviceSize bufferSize = static_cast<VkDeviceSize>(GetIndexSize(indexType)) * indexCount;
 
 	ScopeStageBuffer stageBuffer(device, bufferSize);
-	stageBuffer.Get().TransferToGpuMemory(indices, static_cast<size_t>(bufferSize));
+
+	if (indexType == VK_INDEX_TYPE_UINT16)
+	{
+		std::vector<u16> indices16(indexCount);
+		std::transform(indices, indices + indexCount, indices16.begin(), [](u32 index) { return static_cast<u16>(index); });
+		stageBuffer.Get().TransferToGpuMemory(indices16.data(), static_cast<size_t>(bufferSize));
+	}
+	else
+	{
+		stageBuffer.Get().TransferToGpuMemory(indices, static_cast<size_t>(bufferSize));
+	}
 
 	BufferCreateInfo buffCreateInfo = {};
 	buffCreateInfo.Device = device;
@@ -136,7 +118,7 @@ vge::IndexBuffer vge::IndexBuffer::Create(const Device* device, size_t indexCoun
 
 	IndexBuffer idxBuffer = {};
 	idxBuffer.m_IndexCount = indexCount;
-	idxBuffer.m_IndexType = VK_INDEX_TYPE_UINT32;
+	idxBuffer.m_IndexType = indexType;
 	idxBuffer.m_AllocatedBuffer = Buffer::Create(buffCreateInfo);
 
 	BufferCopyInfo buffCopyInfo = {};
@@ -150,14 +132,44 @@ vge::IndexBuffer vge::IndexBuffer::Create(const Device* device, size_t indexCoun
 	return idxBuffer;
 }
 
-vge::VertexBuffer vge::VertexBuffer::Create(const Device* device, const std::vector<Vertex>& vertices)
+VkIndexType vge::IndexBuffer::SelectIndexType(size_t indexCount, const u32* indices)
+{
+	// 0xFFFF is kept free as it is primitive restart value for 16 bit indices.
+	const u32 maxIndex = indexCount > 0 ? *std::max_element(indices, indices + indexCount) : 0;
+	return maxIndex < UINT16_MAX ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+vge::IndirectBuffer vge::IndirectBuffer::Create(const Device* device, u32 maxDrawCount)
+{
+	BufferCreateInfo buffCreateInfo = {};
+	buffCreateInfo.Device = device;
+	buffCreateInfo.Size = static_cast<VkDeviceSize>(maxDrawCount) * sizeof(VkDrawIndexedIndirectCommand);
+	buffCreateInfo.Usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+	buffCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	buffCreateInfo.MemAllocFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	IndirectBuffer indirectBuffer = {};
+	indirectBuffer.m_AllocatedBuffer = Buffer::Create(buffCreateInfo);
+	indirectBuffer.m_Commands = static_cast<VkDrawIndexedIndirectCommand*>(indirectBuffer.m_AllocatedBuffer.AllocInfo.pMappedData);
+	indirectBuffer.m_MaxDrawCount = maxDrawCount;
+
+	return indirectBuffer;
+}
+
+bool vge::IndirectBuffer::Push(const VkDrawIndexedIndirectCommand& command)
 {
-	return Create(device, vertices.size(), vertices.data());
+	if (m_DrawCount >= m_MaxDrawCount)
+	{
+		return false;
+	}
+
+	m_Commands[m_DrawCount++] = command;
+	return true;
 }
 
-vge::VertexBuffer vge::VertexBuffer::Create(const Device* device, size_t vertexCount, const Vertex* vertices)
+vge::VertexBuffer vge::VertexBuffer::Create(const Device* device, size_t vertexCount, size_t vertexStride, const void* vertices)
 {
-	const VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
+	const VkDeviceSize bufferSize = vertexStride * vertexCount;
 
 	ScopeStageBuffer stageBuffer(device, bufferSize);
 	stageBuffer.Get().TransferToGpuMemory(vertices, static_cast<size_t>(bufferSize));
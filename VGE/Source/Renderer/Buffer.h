@@ -13,6 +13,7 @@ namespace vge
 		VkDeviceSize Size = 0;
 		VkBufferUsageFlags Usage = 0;
 		VmaMemoryUsage MemAllocUsage = VmaMemoryUsage::VMA_MEMORY_USAGE_UNKNOWN;
+		VmaAllocationCreateFlags MemAllocFlags = 0;
 	};
 
 	struct BufferCopyInfo
@@ -69,15 +70,20 @@ namespace vge
 	class IndexBuffer
 	{
 	public:
+		// Indices are stored as 16 bit if all of them fit, 32 bit otherwise.
 		static IndexBuffer Create(const Device* device, const std::vector<u32>& indices);
 		static IndexBuffer Create(const Device* device, size_t indexCount, const u32* indices);
 
+		static VkIndexType SelectIndexType(size_t indexCount, const u32* indices);
+		static inline u32 GetIndexSize(VkIndexType indexType) { return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(u16) : sizeof(u32); }
+
 	public:
 		IndexBuffer() = default;
 		inline void Destroy() { m_AllocatedBuffer.Destroy(); m_IndexCount = 0; }
 		inline Buffer Get() const { return m_AllocatedBuffer; }
 		inline size_t GetIndexCount() const { return m_IndexCount; }
 		inline VkIndexType GetIndexType() const { return m_IndexType; }
+		inline u32 GetIndexSize() const { return GetIndexSize(m_IndexType); }
 
 	private:
 		Buffer m_AllocatedBuffer = {};
@@ -85,6 +91,30 @@ namespace vge
 		VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
 	};
 
+	// Host visible buffer of indexed indirect draw commands, filled on CPU while recording frame.
+	class IndirectBuffer
+	{
+	public:
+		static IndirectBuffer Create(const Device* device, u32 maxDrawCount);
+
+	public:
+		IndirectBuffer() = default;
+		inline void Destroy() { m_AllocatedBuffer.Destroy(); m_DrawCount = 0; m_MaxDrawCount = 0; }
+		inline void Reset() { m_DrawCount = 0; }
+		inline Buffer Get() const { return m_AllocatedBuffer; }
+		inline u32 GetDrawCount() const { return m_DrawCount; }
+		inline u32 GetMaxDrawCount() const { return m_MaxDrawCount; }
+
+		// Returns false if buffer is full.
+		bool Push(const VkDrawIndexedIndirectCommand& command);
+
+	private:
+		Buffer m_AllocatedBuffer = {};
+		VkDrawIndexedIndirectCommand* m_Commands = nullptr;
+		u32 m_DrawCount = 0;
+		u32 m_MaxDrawCount = 0;
+	};
+
 	struct VertexInputDescription
 	{
 		std::vector<VkVertexInputBindingDescription> Bindings = {};
@@ -93,20 +123,22 @@ namespace vge
 		VkPipelineVertexInputStateCreateFlags flags = 0;
 	};
 
+	// Full precision vertex as imported, packed to GVertexLayout before upload.
 	struct Vertex
 	{
 		glm::vec3 Position;
-		glm::vec3 Color;
+		glm::vec3 Normal;
 		glm::vec2 TexCoords;
 
+		// Description of GVertexLayout.
 		static VertexInputDescription GetDescription();
 	};
 
 	class VertexBuffer
 	{
 	public:
-		static VertexBuffer Create(const Device* device, const std::vector<Vertex>& vertices);
-		static VertexBuffer Create(const Device* device, size_t vertexCount, const Vertex* vertices);
+		// Vertices are expected to be already packed with stride of vertex layout.
+		static VertexBuffer Create(const Device* device, size_t vertexCount, size_t vertexStride, const void* vertices);
 
 	public:
 		VertexBuffer() = default;
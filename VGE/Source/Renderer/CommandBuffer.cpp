@@ -17,12 +17,12 @@ vge::ScopeCmdBuffer::~ScopeCmdBuffer()
 	CommandBuffer::EndOneTimeSubmit(m_CmdBuffer);
 }
 
-vge::CommandBuffer vge::CommandBuffer::Allocate(const Device* device)
+vge::CommandBuffer vge::CommandBuffer::Allocate(const Device* device, VkCommandPool pool /*= VK_NULL_HANDLE*/)
 {
 	VkCommandBufferAllocateInfo cmdBufferAllocInfo = {};
 	cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	cmdBufferAllocInfo.commandPool = device->GetCommandPool();
+	cmdBufferAllocInfo.commandPool = pool != VK_NULL_HANDLE ? pool : device->GetCommandPool();
 	cmdBufferAllocInfo.commandBufferCount = 1;
 	
 	CommandBuffer cmd = {};
@@ -52,6 +52,7 @@ void vge::CommandBuffer::BeginRecord(VkCommandBufferUsageFlags flags /*= 0*/)
 	cmdBufferBeginInfo.flags = flags;
 
 	vkBeginCommandBuffer(m_Handle, &cmdBufferBeginInfo);
+	m_DrawCallCount = 0;
 }
 
 void vge::CommandBuffer::BeginRenderPass(const RenderPass* renderPass, const FrameBuffer* framebuffer)
@@ -101,10 +102,9 @@ void vge::CommandBuffer::Bind(const Pipeline* pipeline, u32 descriptorSetCount,
 	vkCmdBindDescriptorSets(m_Handle, pipeline->GetBindPoint(), pipeline->GetLayout(), 0, descriptorSetCount, descriptorSets, 0, nullptr);
 }
 
-void vge::CommandBuffer::Bind(u32 vertBufferCount, const VertexBuffer** vertBuffers, const Shader* shader, u32 firstBinding /*= 0*/)
+void vge::CommandBuffer::Bind(u32 vertBufferCount, const VertexBuffer** vertBuffers, u32 firstBinding /*= 0*/)
 {
 	std::vector<VkDeviceSize> offsets(vertBufferCount, 0);
-	const u32 bindingCount = static_cast<u32>(shader->GetDescriptorSetLayout().Bindings.size());
 
 	std::vector<VkBuffer> vkVertBuffers;
 	vkVertBuffers.reserve(vertBufferCount);
@@ -113,7 +113,7 @@ void vge::CommandBuffer::Bind(u32 vertBufferCount, const VertexBuffer** vertBuff
 		vkVertBuffers.push_back(vertBuffers[i]->Get().Handle);
 	}
 
-	vkCmdBindVertexBuffers(m_Handle, firstBinding, bindingCount, vkVertBuffers.data(), offsets.data());
+	vkCmdBindVertexBuffers(m_Handle, firstBinding, vertBufferCount, vkVertBuffers.data(), offsets.data());
 }
 
 void vge::CommandBuffer::Bind(const IndexBuffer* idxBuffer, u32 offset /*= 0*/)
@@ -121,9 +121,9 @@ void vge::CommandBuffer::Bind(const IndexBuffer* idxBuffer, u32 offset /*= 0*/)
 	vkCmdBindIndexBuffer(m_Handle, idxBuffer->Get().Handle, offset, idxBuffer->GetIndexType());
 }
 
-void vge::CommandBuffer::PushConstants(const Pipeline* pipeline, const Shader* shader, u32 constantSize, const void* constants, u32 offset /*= 0*/)
+void vge::CommandBuffer::PushConstants(const Pipeline* pipeline, u32 constantSize, const void* constants, u32 offset /*= 0*/)
 {
-	vkCmdPushConstants(m_Handle, pipeline->GetLayout(), shader->GetStageFlags(), offset, constantSize, constants);
+	vkCmdPushConstants(m_Handle, pipeline->GetLayout(), pipeline->GetPushConstantRange().stageFlags, offset, constantSize, constants);
 }
 
 void vge::CommandBuffer::SetViewport(const glm::vec2& size, const glm::vec2& pos /*= { 0.0f, 0.0f }*/)
@@ -150,9 +150,29 @@ void vge::CommandBuffer::SetScissor(const VkExtent2D& extent, const glm::vec<2,
 void vge::CommandBuffer::Draw(u32 vertCount, u32 instanceCount /*= 1*/, u32 firstVert /*= 0*/, u32 firstInstance /*= 0*/)
 {
 	vkCmdDraw(m_Handle, vertCount, instanceCount, firstVert, firstInstance);
+	m_DrawCallCount++;
 }
 
 void vge::CommandBuffer::DrawIndexed(u32 idxCount, u32 instanceCount /*= 1*/, u32 firstIdx /*= 0*/, i32 vertOffset /*= 0*/, u32 firstInstance /*= 0*/)
 {
 	vkCmdDrawIndexed(m_Handle, idxCount, instanceCount, firstIdx, vertOffset, firstInstance);
+	m_DrawCallCount++;
+}
+
+void vge::CommandBuffer::DrawIndexedIndirect(const IndirectBuffer* buffer, u32 firstDraw, u32 drawCount)
+{
+	constexpr u32 stride = sizeof(VkDrawIndexedIndirectCommand);
+
+	if (m_Device->GetEnabledFeatures().multiDrawIndirect)
+	{
+		vkCmdDrawIndexedIndirect(m_Handle, buffer->Get().Handle, static_cast<VkDeviceSize>(firstDraw) * stride, drawCount, stride);
+		m_DrawCallCount++;
+		return;
+	}
+
+	for (u32 i = 0; i < drawCount; ++i)
+	{
+		vkCmdDrawIndexedIndirect(m_Handle, buffer->Get().Handle, static_cast<VkDeviceSize>(firstDraw + i) * stride, 1, stride);
+	}
+	m_DrawCallCount += drawCount;
 }
@@ -10,13 +10,15 @@ namespace vge
 	class Pipeline;
 	class IndexBuffer;
 	class VertexBuffer;
+	class IndirectBuffer;
 	class Shader;
 	class FrameBuffer;
 
 	class CommandBuffer
 	{
 	public:
-		static CommandBuffer Allocate(const Device* device);
+		// Allocate from given pool or from device one if it is null.
+		static CommandBuffer Allocate(const Device* device, VkCommandPool pool = VK_NULL_HANDLE);
 		
 		static CommandBuffer BeginOneTimeSubmit(const Device* device);
 		static void EndOneTimeSubmit(CommandBuffer& cmd);
@@ -25,6 +27,8 @@ namespace vge
 		CommandBuffer() = default;
 
 		inline VkCommandBuffer GetHandle() const { return m_Handle; }
+		// Draw commands recorded since record began, indirect draw without multi draw support counts once per draw.
+		inline u32 GetDrawCallCount() const { return m_DrawCallCount; }
 		inline void NextSubpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) { vkCmdNextSubpass(m_Handle, contents); }
 
 		void BeginRecord(VkCommandBufferUsageFlags flags = 0);
@@ -36,17 +40,21 @@ namespace vge
 
 		void Bind(const Pipeline* pipeline, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 		void Bind(const IndexBuffer* idxBuffer, u32 offset = 0);
-		void Bind(u32 vertBufferCount, const VertexBuffer** vertBuffers, const Shader* shader, u32 firstBinding = 0);
+		void Bind(u32 vertBufferCount, const VertexBuffer** vertBuffers, u32 firstBinding = 0);
 		void Bind(const Pipeline* pipeline, u32 descriptorSetCount, VkDescriptorSet* descriptorSets);
-		void PushConstants(const Pipeline* pipeline, const Shader* shader, u32 constantSize, const void* constants, u32 offset = 0);
+		// Uses stages of pipeline push constant range, as ranges of all stages are merged into one.
+		void PushConstants(const Pipeline* pipeline, u32 constantSize, const void* constants, u32 offset = 0);
 		void SetViewport(const glm::vec2& size, const glm::vec2& pos = { 0.0f, 0.0f });
 		void SetScissor(const VkExtent2D& extent, const glm::vec<2, i32>& offset = { 0, 0 });
 		void Draw(u32 vertCount, u32 instanceCount = 1, u32 firstVert = 0, u32 firstInstance = 0);
 		void DrawIndexed(u32 idxCount, u32 instanceCount = 1, u32 firstIdx = 0, i32 vertOffset = 0, u32 firstInstance = 0);
+		// Falls back to separate draw calls if multi draw indirect is not supported.
+		void DrawIndexedIndirect(const IndirectBuffer* buffer, u32 firstDraw, u32 drawCount);
 
 	private:
 		const Device* m_Device = nullptr;
 		VkCommandBuffer m_Handle = VK_NULL_HANDLE;
+		u32 m_DrawCallCount = 0;
 	};
 
 	struct ScopeCmdBuffer
@@ -0,0 +1,40 @@
+#include "Culling.h"
+
+vge::Frustum vge::Frustum::Create(const glm::mat4& clipMatrix)
+{
+	const glm::mat4 rows = glm::transpose(clipMatrix);
+
+	Frustum frustum = {};
+	frustum.Planes[0] = rows[3] + rows[0];	// left
+	frustum.Planes[1] = rows[3] - rows[0];	// right
+	frustum.Planes[2] = rows[3] + rows[1];	// bottom
+	frustum.Planes[3] = rows[3] - rows[1];	// top
+	frustum.Planes[4] = rows[2];			// near
+	frustum.Planes[5] = rows[3] - rows[2];	// far
+
+	for (glm::vec4& plane : frustum.Planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return frustum;
+}
+
+bool vge::Frustum::IntersectsSphere(const glm::vec3& center, f32 radius) const
+{
+	for (const glm::vec4& plane : Planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool vge::IsConeBackfacing(const glm::vec3& coneAxis, f32 coneCutoff, const glm::vec3& center, f32 radius, const glm::vec3& cameraPosition)
+{
+	const glm::vec3 toCenter = center - cameraPosition;
+	return glm::dot(toCenter, coneAxis) >= coneCutoff * glm::length(toCenter) + radius;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge
+{
+	// View frustum as 6 normalized planes (xyz - normal pointing inside, w - distance).
+	struct Frustum
+	{
+	public:
+		// Extract planes from clip matrix with Vulkan depth range [0, 1] (Gribb-Hartmann).
+		// Passing projection * view * model gives planes in model space.
+		static Frustum Create(const glm::mat4& clipMatrix);
+
+	public:
+		bool IntersectsSphere(const glm::vec3& center, f32 radius) const;
+
+	public:
+		glm::vec4 Planes[6] = {};
+	};
+
+	// Whether all triangles inside sphere with given normal cone face away from camera.
+	bool IsConeBackfacing(const glm::vec3& coneAxis, f32 coneCutoff, const glm::vec3& center, f32 radius, const glm::vec3& cameraPosition);
+}
@@ -0,0 +1,22 @@
+#include "DeletionQueue.h"
+
+void vge::DeletionQueue::Push(Deleter&& deleter)
+{
+	m_Entries.push_back({ m_FrameValue, std::move(deleter) });
+}
+
+void vge::DeletionQueue::Flush(u64 completedValue)
+{
+	while (!m_Entries.empty() && m_Entries.front().FrameValue <= completedValue)
+	{
+		// Deleter may push new entries, so entry is removed before run.
+		Deleter deleter = std::move(m_Entries.front().Func);
+		m_Entries.pop_front();
+		deleter();
+	}
+}
+
+void vge::DeletionQueue::FlushAll()
+{
+	Flush(UINT64_MAX);
+}
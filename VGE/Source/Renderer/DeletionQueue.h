@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+namespace vge
+{
+	using Deleter = std::function<void()>;
+
+	// Defers resource destruction until gpu frame which could use resource has retired.
+	// Deleters are tagged with frame timeline value of frame being recorded and run once timeline reaches it.
+	class DeletionQueue
+	{
+	public:
+		DeletionQueue() = default;
+		NOT_COPYABLE(DeletionQueue);
+
+		// Value which will be signaled by submit of frame being recorded now.
+		inline void SetFrameValue(u64 value) { m_FrameValue = value; }
+		inline u64 GetFrameValue() const { return m_FrameValue; }
+		inline size_t GetPendingCount() const { return m_Entries.size(); }
+
+		void Push(Deleter&& deleter);
+
+		// Destroy copy of any resource with Destroy function (buffers, images, textures, models...).
+		template<typename T>
+		inline void PushDestroy(T resource)
+		{
+			Push([resource]() mutable { resource.Destroy(); });
+		}
+
+		// Run deleters of frames which gpu has completed.
+		void Flush(u64 completedValue);
+		// Run all deleters, device must be idle.
+		void FlushAll();
+
+	private:
+		struct Entry
+		{
+			u64 FrameValue = 0;
+			Deleter Func = {};
+		};
+
+	private:
+		std::deque<Entry> m_Entries = {};	// ordered by frame value as it only grows
+		u64 m_FrameValue = 0;
+	};
+}
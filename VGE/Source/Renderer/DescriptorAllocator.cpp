@@ -0,0 +1,166 @@
+#include "DescriptorAllocator.h"
+#include "Device.h"
+
+namespace vge
+{
+	namespace
+	{
+		struct DescriptorPoolRatio
+		{
+			VkDescriptorType Type;
+			f32 CountPerSet;
+		};
+
+		// Average amount of descriptors of each type per set.
+		constexpr DescriptorPoolRatio GDescriptorPoolRatios[] =
+		{
+			{ VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0f },
+			{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.0f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 2.0f },
+		};
+	}
+}
+
+void vge::DescriptorAllocator::Initialize(const Device* device, VkDescriptorPoolCreateFlags poolFlags /*= 0*/)
+{
+	m_Device = device;
+	m_PoolFlags = poolFlags;
+}
+
+void vge::DescriptorAllocator::Destroy()
+{
+	for (VkDescriptorPool pool : m_UsedPools)
+	{
+		vkDestroyDescriptorPool(m_Device->GetHandle(), pool, nullptr);
+	}
+
+	for (VkDescriptorPool pool : m_FreePools)
+	{
+		vkDestroyDescriptorPool(m_Device->GetHandle(), pool, nullptr);
+	}
+
+	m_UsedPools.clear();
+	m_FreePools.clear();
+	m_CurrentPool = VK_NULL_HANDLE;
+	m_Stats = {};
+}
+
+VkDescriptorSet vge::DescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	Allocate(1, &layout, &set);
+	return set;
+}
+
+bool vge::DescriptorAllocator::Allocate(u32 setCount, const VkDescriptorSetLayout* layouts, VkDescriptorSet* outSets)
+{
+	// Pool holds at most GDescriptorSetsPerPool sets, so larger batches are split across pools.
+	for (u32 firstSet = 0; firstSet < setCount; firstSet += GDescriptorSetsPerPool)
+	{
+		if (!AllocateFromPool(std::min(GDescriptorSetsPerPool, setCount - firstSet), layouts + firstSet, outSets + firstSet))
+		{
+			return false;
+		}
+	}
+
+	m_Stats.AllocatedSetCount += setCount;
+	m_Stats.PeakSetCount = std::max(m_Stats.PeakSetCount, m_Stats.AllocatedSetCount);
+	m_Stats.TotalAllocationCount += setCount;
+
+	return true;
+}
+
+bool vge::DescriptorAllocator::AllocateFromPool(u32 setCount, const VkDescriptorSetLayout* layouts, VkDescriptorSet* outSets)
+{
+	if (!m_CurrentPool)
+	{
+		m_CurrentPool = GrabPool();
+	}
+
+	VkDescriptorSetAllocateInfo setAllocInfo = {};
+	setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAllocInfo.descriptorPool = m_CurrentPool;
+	setAllocInfo.descriptorSetCount = setCount;
+	setAllocInfo.pSetLayouts = layouts;
+
+	VkResult result = vkAllocateDescriptorSets(m_Device->GetHandle(), &setAllocInfo, outSets);
+
+	// Current pool is exhausted, retry once with fresh pool.
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+	{
+		m_CurrentPool = GrabPool();
+		setAllocInfo.descriptorPool = m_CurrentPool;
+		result = vkAllocateDescriptorSets(m_Device->GetHandle(), &setAllocInfo, outSets);
+	}
+
+	if (result != VK_SUCCESS)
+	{
+		LOG(Error, "Failed to allocate %u descriptor sets, result %d.", setCount, result);
+		return false;
+	}
+
+	return true;
+}
+
+void vge::DescriptorAllocator::Reset()
+{
+	for (VkDescriptorPool pool : m_UsedPools)
+	{
+		vkResetDescriptorPool(m_Device->GetHandle(), pool, 0);
+		m_FreePools.push_back(pool);
+	}
+
+	m_UsedPools.clear();
+	m_CurrentPool = VK_NULL_HANDLE;
+
+	m_Stats.AllocatedSetCount = 0;
+	m_Stats.FreePoolCount = static_cast<u32>(m_FreePools.size());
+}
+
+VkDescriptorPool vge::DescriptorAllocator::GrabPool()
+{
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+
+	if (!m_FreePools.empty())
+	{
+		pool = m_FreePools.back();
+		m_FreePools.pop_back();
+	}
+	else
+	{
+		pool = CreatePool();
+		m_Stats.PoolCount++;
+	}
+
+	m_UsedPools.push_back(pool);
+	m_Stats.FreePoolCount = static_cast<u32>(m_FreePools.size());
+
+	return pool;
+}
+
+VkDescriptorPool vge::DescriptorAllocator::CreatePool() const
+{
+	std::array<VkDescriptorPoolSize, C_ARRAY_NUM(GDescriptorPoolRatios)> poolSizes = {};
+	for (size_t i = 0; i < poolSizes.size(); ++i)
+	{
+		poolSizes[i].type = GDescriptorPoolRatios[i].Type;
+		poolSizes[i].descriptorCount = static_cast<u32>(GDescriptorPoolRatios[i].CountPerSet * GDescriptorSetsPerPool);
+	}
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.flags = m_PoolFlags;
+	poolCreateInfo.maxSets = GDescriptorSetsPerPool;
+	poolCreateInfo.poolSizeCount = static_cast<u32>(poolSizes.size());
+	poolCreateInfo.pPoolSizes = poolSizes.data();
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	VK_ENSURE(vkCreateDescriptorPool(m_Device->GetHandle(), &poolCreateInfo, nullptr, &pool));
+
+	return pool;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+
+namespace vge
+{
+	class Device;
+
+	// Sets per pool, pools are chained so this only affects how often new pool is created.
+	inline constexpr u32 GDescriptorSetsPerPool = 64;
+
+	struct DescriptorAllocatorStats
+	{
+		u32 PoolCount = 0;			// created pools, including free ones
+		u32 FreePoolCount = 0;		// reset pools waiting for reuse
+		u32 AllocatedSetCount = 0;	// sets allocated since last reset
+		u32 PeakSetCount = 0;		// max sets allocated between resets
+		u64 TotalAllocationCount = 0;
+
+		// Allocated sets relative to set capacity of pools in use.
+		inline f32 GetUtilization() const
+		{
+			const u32 usedPoolCount = PoolCount - FreePoolCount;
+			return usedPoolCount > 0 ? static_cast<f32>(AllocatedSetCount) / static_cast<f32>(usedPoolCount * GDescriptorSetsPerPool) : 0.0f;
+		}
+	};
+
+	// Allocates descriptor sets from chain of pools, new pool is taken when current one is exhausted.
+	// Sets are not freed one by one, all of them are released at once by Reset which recycles pools.
+	class DescriptorAllocator
+	{
+	public:
+		DescriptorAllocator() = default;
+
+		void Initialize(const Device* device, VkDescriptorPoolCreateFlags poolFlags = 0);
+		void Destroy();
+
+		VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+		// Any set count, batches larger than pool are allocated from several pools.
+		bool Allocate(u32 setCount, const VkDescriptorSetLayout* layouts, VkDescriptorSet* outSets);
+
+		// Reset all pools with vkResetDescriptorPool, previously allocated sets become invalid.
+		void Reset();
+
+		inline const DescriptorAllocatorStats& GetStats() const { return m_Stats; }
+
+	private:
+		// At most GDescriptorSetsPerPool sets, fresh pool is taken if current one is exhausted.
+		bool AllocateFromPool(u32 setCount, const VkDescriptorSetLayout* layouts, VkDescriptorSet* outSets);
+		VkDescriptorPool GrabPool();
+		VkDescriptorPool CreatePool() const;
+
+	private:
+		const Device* m_Device = nullptr;
+		VkDescriptorPoolCreateFlags m_PoolFlags = 0;
+		VkDescriptorPool m_CurrentPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorPool> m_UsedPools = {};
+		std::vector<VkDescriptorPool> m_FreePools = {};
+		DescriptorAllocatorStats m_Stats = {};
+	};
+}
@@ -0,0 +1,104 @@
+#include "DescriptorLayoutCache.h"
+#include "Device.h"
+
+void vge::DescriptorLayoutCache::Initialize(const Device* device)
+{
+	m_Device = device;
+}
+
+void vge::DescriptorLayoutCache::Destroy()
+{
+	for (const auto& [key, layout] : m_Layouts)
+	{
+		vkDestroyDescriptorSetLayout(m_Device->GetHandle(), layout, nullptr);
+	}
+
+	m_Layouts.clear();
+}
+
+VkDescriptorSetLayout vge::DescriptorLayoutCache::Get(std::vector<VkDescriptorSetLayoutBinding> bindings)
+{
+	std::sort(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b)
+	{
+		return a.binding < b.binding;
+	});
+
+	LayoutKey key = {};
+	key.Bindings = std::move(bindings);
+
+	if (auto it = m_Layouts.find(key); it != m_Layouts.end())
+	{
+		return it->second;
+	}
+
+	std::vector<VkDescriptorSetLayoutBinding> layoutBindings = key.Bindings;
+	std::vector<VkDescriptorBindingFlagsEXT> bindingFlags(layoutBindings.size(), 0);
+	bool bindless = false;
+
+	for (size_t i = 0; i < layoutBindings.size(); ++i)
+	{
+		if (layoutBindings[i].descriptorCount == 0)
+		{
+			ENSURE_MSG(m_Device->IsBindlessSupported(), "Shader declares runtime descriptor array, but descriptor indexing is not supported.");
+
+			layoutBindings[i].descriptorCount = GMaxBindlessDescriptors;
+			// Unused descriptors may be written while set is used by pending command buffers, textures are added that way.
+			bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+			bindless = true;
+		}
+	}
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+	bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsCreateInfo.bindingCount = static_cast<u32>(bindingFlags.size());
+	bindingFlagsCreateInfo.pBindingFlags = bindingFlags.data();
+
+	VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+	layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutCreateInfo.pNext = bindless ? &bindingFlagsCreateInfo : nullptr;
+	layoutCreateInfo.flags = bindless ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0;
+	layoutCreateInfo.bindingCount = static_cast<u32>(layoutBindings.size());
+	layoutCreateInfo.pBindings = layoutBindings.data();
+
+	VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+	VK_ENSURE(vkCreateDescriptorSetLayout(m_Device->GetHandle(), &layoutCreateInfo, nullptr, &layout));
+
+	m_Layouts.emplace(std::move(key), layout);
+
+	return layout;
+}
+
+bool vge::DescriptorLayoutCache::LayoutKey::operator==(const LayoutKey& other) const
+{
+	if (Bindings.size() != other.Bindings.size())
+	{
+		return false;
+	}
+
+	// Immutable samplers are not used, so they are not compared.
+	for (size_t i = 0; i < Bindings.size(); ++i)
+	{
+		const VkDescriptorSetLayoutBinding& a = Bindings[i];
+		const VkDescriptorSetLayoutBinding& b = other.Bindings[i];
+
+		if (a.binding != b.binding || a.descriptorType != b.descriptorType || a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t vge::DescriptorLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const
+{
+	size_t hash = key.Bindings.size();
+
+	for (const VkDescriptorSetLayoutBinding& binding : key.Bindings)
+	{
+		const size_t bindingHash = static_cast<size_t>(binding.binding) | (static_cast<size_t>(binding.descriptorType) << 8) | (static_cast<size_t>(binding.descriptorCount) << 16) | (static_cast<size_t>(binding.stageFlags) << 32);
+		hash ^= std::hash<size_t>()(bindingHash) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+
+	return hash;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+
+namespace vge
+{
+	class Device;
+
+	// Size of descriptor arrays declared as runtime arrays in shaders (bindless), devices with lower update after bind limits fall back to per draw descriptor sets.
+	inline constexpr u32 GMaxBindlessDescriptors = 4096;
+
+	// Deduplicates descriptor set layouts, pipelines with equal set description get the same handle,
+	// so descriptor sets allocated for one of them can be bound to others without rebinding.
+	class DescriptorLayoutCache
+	{
+	public:
+		DescriptorLayoutCache() = default;
+		NOT_COPYABLE(DescriptorLayoutCache);
+
+		void Initialize(const Device* device);
+		void Destroy();
+
+		// Bindings are sorted by binding index before lookup. Layouts are owned by cache.
+		// Bindings with zero descriptor count (runtime arrays) get GMaxBindlessDescriptors partially bound, update after bind and update unused while pending descriptors.
+		VkDescriptorSetLayout Get(std::vector<VkDescriptorSetLayoutBinding> bindings);
+
+		inline size_t GetLayoutCount() const { return m_Layouts.size(); }
+
+	private:
+		struct LayoutKey
+		{
+			std::vector<VkDescriptorSetLayoutBinding> Bindings = {};
+
+			bool operator==(const LayoutKey& other) const;
+		};
+
+		struct LayoutKeyHash
+		{
+			size_t operator()(const LayoutKey& key) const;
+		};
+
+	private:
+		const Device* m_Device = nullptr;
+		std::unordered_map<LayoutKey, VkDescriptorSetLayout, LayoutKeyHash> m_Layouts = {};
+	};
+}
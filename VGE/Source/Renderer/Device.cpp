@@ -2,6 +2,8 @@
 #include "Application.h"
 #include "VulkanGlobals.h"
 #include "Utils.h"
+#include "File.h"
+#include "DescriptorLayoutCache.h"
 
 namespace vge
 {
@@ -108,6 +110,8 @@ namespace vge
 		}
 
 		outExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+		// Dependency of timeline semaphore device extension on Vulkan 1.0.
+		outExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 	}
 
 	bool SupportInstanceExtensions(const std::vector<const char*>& checkExtensions)
@@ -167,6 +171,11 @@ namespace vge
 					indices.PresentFamily = queueFamilyIndex;
 				}
 			}
+			else
+			{
+				// Nothing is presented without surface, present queue is just an alias of graphics one.
+				indices.PresentFamily = indices.GraphicsFamily;
+			}
 
 			if (indices.IsValid())
 			{
@@ -249,9 +258,122 @@ namespace vge
 		std::vector<const char*> deviceExtensions;
 		deviceExtensions.assign(vge::GDeviceExtensions, vge::GDeviceExtensions + C_ARRAY_NUM(vge::GDeviceExtensions));
 
-		vge::SwapchainSupportDetails swapchainDetails = GetSwapchainSupportDetailsInternal(gpu, surface);
+		// Headless device has no surface to present to.
+		bool swapchainSupported = true;
+		if (surface)
+		{
+			deviceExtensions.insert(deviceExtensions.end(), vge::GPresentDeviceExtensions, vge::GPresentDeviceExtensions + C_ARRAY_NUM(vge::GPresentDeviceExtensions));
+			swapchainSupported = GetSwapchainSupportDetailsInternal(gpu, surface).IsValid();
+		}
+
+		return indices.IsValid() && SupportDeviceExtensions(gpu, deviceExtensions) && swapchainSupported && gpuFeatures.samplerAnisotropy;
+	}
+
+	// Descriptor indexing features required for bindless textures, physical device properties 2 instance extension is needed to query them.
+	static bool SupportBindless(VkInstance instance, VkPhysicalDevice gpu, bool properties2Enabled)
+	{
+		std::vector<const char*> bindlessExtensions(vge::GBindlessDeviceExtensions, vge::GBindlessDeviceExtensions + C_ARRAY_NUM(vge::GBindlessDeviceExtensions));
+		if (!properties2Enabled || !SupportDeviceExtensions(gpu, bindlessExtensions))
+		{
+			return false;
+		}
+
+		auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR");
+		if (!getFeatures2)
+		{
+			return false;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2KHR features2 = {};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features2.pNext = &indexingFeatures;
+		getFeatures2(gpu, &features2);
+
+		// Textures are written into the set while command buffers of previous frames using it are still pending.
+		if (!features2.features.shaderSampledImageArrayDynamicIndexing || !indexingFeatures.runtimeDescriptorArray || !indexingFeatures.descriptorBindingPartiallyBound ||
+			!indexingFeatures.descriptorBindingSampledImageUpdateAfterBind || !indexingFeatures.descriptorBindingUpdateUnusedWhilePending)
+		{
+			return false;
+		}
+
+		auto getProperties2 = (PFN_vkGetPhysicalDeviceProperties2KHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties2KHR");
+		if (!getProperties2)
+		{
+			return false;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = {};
+		indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2KHR properties2 = {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+		properties2.pNext = &indexingProperties;
+		getProperties2(gpu, &properties2);
+
+		if (indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages < vge::GMaxBindlessDescriptors ||
+			indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages < vge::GMaxBindlessDescriptors)
+		{
+			LOG(Warning, "Update after bind sampled image limits (%u per stage, %u per set) are below %u bindless descriptors.",
+				indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages, vge::GMaxBindlessDescriptors);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Present id and present wait features are needed together to wait for presentation of tagged frame.
+	static bool SupportPresentWait(VkInstance instance, VkPhysicalDevice gpu)
+	{
+		std::vector<const char*> presentWaitExtensions(vge::GPresentWaitDeviceExtensions, vge::GPresentWaitDeviceExtensions + C_ARRAY_NUM(vge::GPresentWaitDeviceExtensions));
+		if (!SupportDeviceExtensions(gpu, presentWaitExtensions))
+		{
+			return false;
+		}
+
+		auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR");
+		if (!getFeatures2)
+		{
+			return false;
+		}
+
+		VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+		presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+		VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+		presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+		presentIdFeatures.pNext = &presentWaitFeatures;
+
+		VkPhysicalDeviceFeatures2KHR features2 = {};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features2.pNext = &presentIdFeatures;
+		getFeatures2(gpu, &features2);
+
+		return presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+	}
+
+	// Pipeline cache data starts with header (VkPipelineCacheHeaderVersionOne layout) describing device it was created on.
+	static bool IsPipelineCacheCompatible(const std::vector<u8>& data, const VkPhysicalDeviceProperties& gpuProps)
+	{
+		constexpr size_t headerSize = 4 * sizeof(u32) + VK_UUID_SIZE;
+		if (data.size() < headerSize)
+		{
+			return false;
+		}
+
+		u32 header[4] = {};
+		memory::Memcopy(header, data.data(), sizeof(header));
 
-		return indices.IsValid() && SupportDeviceExtensions(gpu, deviceExtensions) && swapchainDetails.IsValid() && gpuFeatures.samplerAnisotropy;
+		const u32 headerLength = header[0];
+		const u32 headerVersion = header[1];
+		const u32 vendorID = header[2];
+		const u32 deviceID = header[3];
+
+		return headerLength >= headerSize && headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			vendorID == gpuProps.vendorID && deviceID == gpuProps.deviceID &&
+			std::memcmp(data.data() + sizeof(header), gpuProps.pipelineCacheUUID, VK_UUID_SIZE) == 0;
 	}
 #pragma endregion Statics
 }
@@ -271,12 +393,16 @@ void vge::Device::Initialize()
 	FindQueues();
 	CreateCustomAllocator();
 	CreateCommandPool();
+	CreatePipelineCache();
+	m_DescriptorLayoutCache.Initialize(this);
 }
 
 void vge::Device::Destroy()
 {
 	WaitIdle();
 
+	m_DescriptorLayoutCache.Destroy();
+	DestroyPipelineCache();
 	vkDestroyCommandPool(m_Handle, m_CommandPool, nullptr);
 	vmaDestroyAllocator(m_Allocator);
 	vkDestroyDevice(m_Handle, nullptr);
@@ -299,6 +425,25 @@ vge::SwapchainSupportDetails vge::Device::GetSwapchainSupportDetails(VkSurfaceKH
 	return GetSwapchainSupportDetailsInternal(m_Gpu, surface);
 }
 
+vge::DeviceMemoryStats vge::Device::GetMemoryStats() const
+{
+	const VkPhysicalDeviceMemoryProperties* memoryProps = nullptr;
+	vmaGetMemoryProperties(m_Allocator, &memoryProps);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+	vmaGetHeapBudgets(m_Allocator, budgets);
+
+	DeviceMemoryStats stats = {};
+	for (u32 heapIndex = 0; heapIndex < memoryProps->memoryHeapCount; ++heapIndex)
+	{
+		stats.AllocationCount += budgets[heapIndex].statistics.allocationCount;
+		stats.AllocationBytes += budgets[heapIndex].statistics.allocationBytes;
+		stats.BlockBytes += budgets[heapIndex].statistics.blockBytes;
+	}
+
+	return stats;
+}
+
 void vge::Device::CreateInstance()
 {
 	if (GEnableValidationLayers)
@@ -319,6 +464,22 @@ void vge::Device::CreateInstance()
 
 	ENSURE_MSG(SupportInstanceExtensions(instanceExtensions), "Instance does not support requried extensions.");
 
+#if BINDLESS_TEXTURES
+	const std::vector<const char*> bindlessExtensions(GBindlessInstanceExtensions, GBindlessInstanceExtensions + C_ARRAY_NUM(GBindlessInstanceExtensions));
+	if (SupportInstanceExtensions(bindlessExtensions))
+	{
+		for (const char* extension : bindlessExtensions)
+		{
+			const auto isSame = [extension](const char* other) { return strcmp(extension, other) == 0; };
+			if (std::find_if(instanceExtensions.begin(), instanceExtensions.end(), isSame) == instanceExtensions.end())
+			{
+				instanceExtensions.push_back(extension);
+			}
+		}
+		m_Properties2Enabled = true;
+	}
+#endif
+
 	VkInstanceCreateInfo createInfo = {};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 	createInfo.pApplicationInfo = &appInfo;
@@ -365,6 +526,11 @@ void vge::Device::SetupDebugMessenger()
 
 void vge::Device::CreateInitialSurface()
 {
+	if (IsHeadless())
+	{
+		return;
+	}
+
 	CreateWindowSurface(m_InitialSurface);
 }
 
@@ -394,6 +560,16 @@ void vge::Device::FindGpu()
 			LOG(Log, " Device type: %s", vge::GpuTypeToString(gpuProps.deviceType));
 			LOG(Log, " Driver version: %u", gpuProps.driverVersion);
 
+			u32 queueFamilyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(m_Gpu, &queueFamilyCount, nullptr);
+			std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(m_Gpu, &queueFamilyCount, queueFamilies.data());
+
+			// Graphics queue may not support timestamps, gpu frame time is not measured then.
+			const bool timestampSupported = queueFamilies[m_QueueIndices.GraphicsFamily].timestampValidBits > 0;
+			m_TimestampPeriod = timestampSupported ? gpuProps.limits.timestampPeriod : 0.0f;
+			LOG(Log, " Timestamp period: %.2fns", m_TimestampPeriod);
+
 			//m_MinUniformBufferOffset = gpuProps.limits.minUniformBufferOffsetAlignment;
 
 			return;
@@ -420,28 +596,155 @@ void vge::Device::CreateDevice()
 		queueCreateInfos.push_back(queueCreateInfo);
 	}
 
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(m_Gpu, &supportedFeatures);
+
 	VkPhysicalDeviceFeatures gpuFeatures = {};
 	gpuFeatures.samplerAnisotropy = VK_TRUE;
+	gpuFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // optional, cooked textures fallback to rgba8 without it
+	gpuFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect; // optional, meshlet draws are issued one by one without it
+
+	std::vector<const char*> deviceExtensions(GDeviceExtensions, GDeviceExtensions + C_ARRAY_NUM(GDeviceExtensions));
+	if (!IsHeadless())
+	{
+		deviceExtensions.insert(deviceExtensions.end(), GPresentDeviceExtensions, GPresentDeviceExtensions + C_ARRAY_NUM(GPresentDeviceExtensions));
+	}
+
+	// Optional, textures are bound one descriptor set per draw without it.
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+#if BINDLESS_TEXTURES
+	m_BindlessSupported = SupportBindless(m_Instance, m_Gpu, m_Properties2Enabled);
+#endif
+	if (m_BindlessSupported)
+	{
+		deviceExtensions.insert(deviceExtensions.end(), GBindlessDeviceExtensions, GBindlessDeviceExtensions + C_ARRAY_NUM(GBindlessDeviceExtensions));
+		gpuFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	}
+
+	void* featuresChain = m_BindlessSupported ? &indexingFeatures : nullptr;
+
+	// Optional, latency is approximated with gpu completion of frame without it.
+	VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+	presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+	presentWaitFeatures.pNext = featuresChain;
+
+	VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+	presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+	presentIdFeatures.pNext = &presentWaitFeatures;
+
+	m_PresentWaitSupported = !IsHeadless() && SupportPresentWait(m_Instance, m_Gpu);
+	if (m_PresentWaitSupported)
+	{
+		deviceExtensions.insert(deviceExtensions.end(), GPresentWaitDeviceExtensions, GPresentWaitDeviceExtensions + C_ARRAY_NUM(GPresentWaitDeviceExtensions));
+		presentIdFeatures.presentId = VK_TRUE;
+		presentWaitFeatures.presentWait = VK_TRUE;
+		featuresChain = &presentIdFeatures;
+	}
+
+	// Frames are paced by single timeline semaphore.
+	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+	timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+	timelineFeatures.pNext = featuresChain;
+	timelineFeatures.timelineSemaphore = VK_TRUE;
 
 	VkDeviceCreateInfo deviceCreateInfo = {};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.pNext = &timelineFeatures;
 	deviceCreateInfo.queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size());
 	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
-	deviceCreateInfo.enabledExtensionCount = static_cast<u32>(C_ARRAY_NUM(GDeviceExtensions));
-	deviceCreateInfo.ppEnabledExtensionNames = GDeviceExtensions;
+	deviceCreateInfo.enabledExtensionCount = static_cast<u32>(deviceExtensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	deviceCreateInfo.pEnabledFeatures = &gpuFeatures;
 
 	{
 		std::string extensionsString;
-		for (i32 i = C_ARRAY_NUM(GDeviceExtensions) - 1; i >= 0; --i)
+		for (const char* extension : deviceExtensions)
 		{
-			extensionsString.append(GDeviceExtensions[i]);
+			extensionsString.append(extension);
 			extensionsString.append(" ");
 		}
 		LOG(Log, "Device extensions enabled: %s", extensionsString.c_str());
 	}
 
+	LOG(Log, "BC texture compression: %s", gpuFeatures.textureCompressionBC ? "enabled" : "not supported");
+	LOG(Log, "Multi draw indirect: %s", gpuFeatures.multiDrawIndirect ? "enabled" : "not supported");
+	LOG(Log, "Bindless textures: %s", m_BindlessSupported ? "enabled" : "not supported");
+	LOG(Log, "Present wait: %s", m_PresentWaitSupported ? "enabled" : "not supported");
+
 	VK_ENSURE(vkCreateDevice(m_Gpu, &deviceCreateInfo, nullptr, &m_Handle));
+
+	m_EnabledFeatures = gpuFeatures;
+
+	m_vkWaitSemaphores = (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(m_Handle, "vkWaitSemaphoresKHR");
+	m_vkGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValueKHR)vkGetDeviceProcAddr(m_Handle, "vkGetSemaphoreCounterValueKHR");
+	ENSURE_MSG(m_vkWaitSemaphores && m_vkGetSemaphoreCounterValue, "Failed to load timeline semaphore functions.");
+
+	if (m_PresentWaitSupported)
+	{
+		m_vkWaitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(m_Handle, "vkWaitForPresentKHR");
+		m_PresentWaitSupported = m_vkWaitForPresent != nullptr;
+	}
+}
+
+VkSemaphore vge::Device::CreateTimelineSemaphore(u64 initialValue /*= 0*/) const
+{
+	VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo = {};
+	semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+	semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+	semaphoreTypeCreateInfo.initialValue = initialValue;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+	VkSemaphore semaphore = VK_NULL_HANDLE;
+	VK_ENSURE(vkCreateSemaphore(m_Handle, &semaphoreCreateInfo, nullptr, &semaphore));
+
+	return semaphore;
+}
+
+bool vge::Device::WaitSemaphore(VkSemaphore semaphore, u64 value, u64 timeout /*= UINT64_MAX*/) const
+{
+	VkSemaphoreWaitInfoKHR waitInfo = {};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &semaphore;
+	waitInfo.pValues = &value;
+
+	const VkResult result = m_vkWaitSemaphores(m_Handle, &waitInfo, timeout);
+	if (result == VK_TIMEOUT)
+	{
+		return false;
+	}
+
+	VK_ENSURE(result);
+	return true;
+}
+
+bool vge::Device::WaitForPresent(VkSwapchainKHR swapchain, u64 presentId, u64 timeout /*= UINT64_MAX*/) const
+{
+	ENSURE(m_PresentWaitSupported);
+
+	const VkResult result = m_vkWaitForPresent(m_Handle, swapchain, presentId, timeout);
+	if (result == VK_TIMEOUT)
+	{
+		return false;
+	}
+
+	// Out of date swapchain is recreated by renderer, presents to it are not waited for anymore.
+	return result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+}
+
+vge::u64 vge::Device::GetSemaphoreValue(VkSemaphore semaphore) const
+{
+	u64 value = 0;
+	VK_ENSURE(m_vkGetSemaphoreCounterValue(m_Handle, semaphore, &value));
+	return value;
 }
 
 void vge::Device::FindQueues()
@@ -469,3 +772,46 @@ void vge::Device::CreateCommandPool()
 
 	VK_ENSURE(vkCreateCommandPool(m_Handle, &cmdPoolCreateInfo, nullptr, &m_CommandPool));
 }
+
+void vge::Device::CreatePipelineCache()
+{
+	VkPhysicalDeviceProperties gpuProps;
+	vkGetPhysicalDeviceProperties(m_Gpu, &gpuProps);
+
+	// Cache of other gpu or driver version is not usable, start from empty one then.
+	std::vector<u8> cacheData;
+	if (file::ReadBinaryFile(GPipelineCacheFilename, cacheData) && !IsPipelineCacheCompatible(cacheData, gpuProps))
+	{
+		LOG(Warning, "Pipeline cache %s was created by different device or driver, ignoring it.", GPipelineCacheFilename);
+		cacheData.clear();
+	}
+
+	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+	pipelineCacheCreateInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+	VK_ENSURE(vkCreatePipelineCache(m_Handle, &pipelineCacheCreateInfo, nullptr, &m_PipelineCache));
+
+	m_PipelineCacheWarm = !cacheData.empty();
+
+	LOG(Log, "Pipeline cache: %s (%zu bytes loaded)", m_PipelineCacheWarm ? "warm" : "cold", cacheData.size());
+}
+
+void vge::Device::DestroyPipelineCache()
+{
+	size_t cacheSize = 0;
+	vkGetPipelineCacheData(m_Handle, m_PipelineCache, &cacheSize, nullptr);
+
+	std::vector<u8> cacheData(cacheSize);
+	if (cacheSize > 0 && vkGetPipelineCacheData(m_Handle, m_PipelineCache, &cacheSize, cacheData.data()) == VK_SUCCESS)
+	{
+		if (file::WriteBinaryFile(GPipelineCacheFilename, cacheData.data(), cacheSize))
+		{
+			LOG(Log, "Pipeline cache saved to %s (%zu bytes).", GPipelineCacheFilename, cacheSize);
+		}
+	}
+
+	vkDestroyPipelineCache(m_Handle, m_PipelineCache, nullptr);
+	m_PipelineCache = VK_NULL_HANDLE;
+}
@@ -3,11 +3,15 @@
 #include "Common.h"
 #include "RenderCommon.h"
 #include "Window.h"
+#include "DescriptorLayoutCache.h"
 
 namespace vge
 {
 	inline class Device* GDevice = nullptr;
 
+	// Pipeline cache is stored next to executable working directory between launches.
+	inline constexpr const char* GPipelineCacheFilename = "pipeline_cache.bin";
+
 	struct QueueFamilyIndices
 	{
 		i32 GraphicsFamily = -1;
@@ -19,6 +23,13 @@ namespace vge
 		}
 	};
 
+	struct DeviceMemoryStats
+	{
+		u32 AllocationCount = 0;
+		u64 AllocationBytes = 0;	// used by resources
+		u64 BlockBytes = 0;			// allocated from driver
+	};
+
 	struct SwapchainSupportDetails
 	{
 		VkSurfaceCapabilitiesKHR SurfaceCapabilities;
@@ -46,13 +57,27 @@ namespace vge
 		inline VkInstance GetInstance() const { return m_Instance; }
 		inline VkPhysicalDevice GetGpu() const { return m_Gpu; }
 		inline VkDevice GetHandle() const { return m_Handle; }
-		inline VkSurfaceKHR GetInitialSurface() const { return m_InitialSurface; }
+		inline VkSurfaceKHR GetInitialSurface() const { return m_InitialSurface; }	// null if headless
 		inline VmaAllocator GetAllocator() const { return m_Allocator; }
 		inline VkCommandPool GetCommandPool() const { return m_CommandPool; }
 		inline VkQueue GetGfxQueue() const { return m_GfxQueue; }
 		inline VkQueue GetPresentQueue() const { return m_PresentQueue; }
 		inline QueueFamilyIndices GetQueueIndices() const { return m_QueueIndices; }
-
+		inline const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return m_EnabledFeatures; }
+		// Whether descriptor indexing is enabled, so textures can be addressed by index in single descriptor array.
+		inline bool IsBindlessSupported() const { return m_BindlessSupported; }
+		// Whether presents can be tagged with id and waited for, so presentation latency can be controlled.
+		inline bool IsPresentWaitSupported() const { return m_PresentWaitSupported; }
+		// Nanoseconds per timestamp tick on graphics queue, 0 if it does not support timestamps.
+		inline f32 GetTimestampPeriod() const { return m_TimestampPeriod; }
+		inline bool IsTimestampSupported() const { return m_TimestampPeriod > 0.0f; }
+		inline VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+		// Whether pipeline cache was filled from disk, so pipelines should be created without compilation.
+		inline bool IsPipelineCacheWarm() const { return m_PipelineCacheWarm; }
+		inline DescriptorLayoutCache* GetDescriptorLayoutCache() { return &m_DescriptorLayoutCache; }
+
+		// No surface and swapchain extension exist then, rendering goes to offscreen images.
+		inline bool IsHeadless() const { return m_Window->IsHeadless(); }
 		inline bool WasWindowResized() const { return m_Window->WasResized(); }
 		inline void ResetWindowResizedFlag() const { m_Window->ResetResizedFlag(); }
 		inline void WaitWindowSizeless() const { m_Window->WaitSizeless(); }
@@ -60,7 +85,17 @@ namespace vge
 
 		inline void WaitIdle() const { vkDeviceWaitIdle(m_Handle); }
 
+		VkSemaphore CreateTimelineSemaphore(u64 initialValue = 0) const;
+		// Block until timeline semaphore reaches given value, returns false on timeout.
+		bool WaitSemaphore(VkSemaphore semaphore, u64 value, u64 timeout = UINT64_MAX) const;
+		u64 GetSemaphoreValue(VkSemaphore semaphore) const;
+
+		// Block until present with given id is displayed, returns false on timeout or if swapchain is out of date. Present wait must be supported.
+		bool WaitForPresent(VkSwapchainKHR swapchain, u64 presentId, u64 timeout = UINT64_MAX) const;
+
 		SwapchainSupportDetails GetSwapchainSupportDetails(VkSurfaceKHR surface) const;
+		// Sum of allocator statistics over all memory heaps, cheap enough to be called every frame.
+		DeviceMemoryStats GetMemoryStats() const;
 
 	private:
 		Window* m_Window = nullptr;
@@ -75,6 +110,21 @@ namespace vge
 		VkQueue m_GfxQueue = VK_NULL_HANDLE;
 		VkQueue m_PresentQueue = VK_NULL_HANDLE;
 		QueueFamilyIndices m_QueueIndices = {};
+		VkPhysicalDeviceFeatures m_EnabledFeatures = {};
+		bool m_Properties2Enabled = false;
+		bool m_BindlessSupported = false;
+		bool m_PresentWaitSupported = false;
+		f32 m_TimestampPeriod = 0.0f;
+
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+		bool m_PipelineCacheWarm = false;
+
+		DescriptorLayoutCache m_DescriptorLayoutCache = {};
+
+		// Timeline semaphore functions come from extension, so they are loaded from device.
+		PFN_vkWaitSemaphoresKHR m_vkWaitSemaphores = nullptr;
+		PFN_vkGetSemaphoreCounterValueKHR m_vkGetSemaphoreCounterValue = nullptr;
+		PFN_vkWaitForPresentKHR m_vkWaitForPresent = nullptr;
 
 	private:
 		void CreateInstance();
@@ -85,6 +135,8 @@ namespace vge
 		void FindQueues();
 		void CreateCustomAllocator();
 		void CreateCommandPool();
+		void CreatePipelineCache();
+		void DestroyPipelineCache();
 	};
 
 	inline Device* CreateDevice(Window* window)
@@ -0,0 +1,161 @@
+#include "FrameContext.h"
+#include "Device.h"
+
+void vge::FrameContext::Initialize(const FrameContextCreateInfo& data)
+{
+	m_Device = data.Device;
+
+	VkCommandPoolCreateInfo cmdPoolCreateInfo = {};
+	cmdPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	cmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // command buffer is re-recorded every frame
+	cmdPoolCreateInfo.queueFamilyIndex = m_Device->GetQueueIndices().GraphicsFamily;
+
+	VK_ENSURE(vkCreateCommandPool(m_Device->GetHandle(), &cmdPoolCreateInfo, nullptr, &m_CommandPool));
+
+	m_CmdBuffer = CommandBuffer::Allocate(m_Device, m_CommandPool);
+
+	m_DescriptorAllocator.Initialize(m_Device);
+
+	BufferCreateInfo buffCreateInfo = {};
+	buffCreateInfo.Device = m_Device;
+	buffCreateInfo.Size = data.UniformBufferSize;
+	buffCreateInfo.Usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+	buffCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+
+	m_UniformBuffer = Buffer::Create(buffCreateInfo);
+	m_IndirectBuffer = IndirectBuffer::Create(m_Device, data.MaxIndirectDraws);
+
+	if (data.ReadbackBufferSize > 0)
+	{
+		m_ReadbackCmdBuffer = CommandBuffer::Allocate(m_Device, m_CommandPool);
+
+		BufferCreateInfo readbackCreateInfo = {};
+		readbackCreateInfo.Device = m_Device;
+		readbackCreateInfo.Size = data.ReadbackBufferSize;
+		readbackCreateInfo.Usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		readbackCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+		readbackCreateInfo.MemAllocFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT; // read every time frame retires
+
+		m_ReadbackBuffer = Buffer::Create(readbackCreateInfo);
+	}
+
+	if (data.Timestamps)
+	{
+		VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolCreateInfo.queryCount = static_cast<u32>(FrameTimestamp::Count);
+
+		VK_ENSURE(vkCreateQueryPool(m_Device->GetHandle(), &queryPoolCreateInfo, nullptr, &m_TimestampQueryPool));
+	}
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	VK_ENSURE(vkCreateSemaphore(m_Device->GetHandle(), &semaphoreCreateInfo, nullptr, &m_ImageAvailableSema));
+}
+
+void vge::FrameContext::Destroy()
+{
+	vkDestroySemaphore(m_Device->GetHandle(), m_ImageAvailableSema, nullptr);
+
+	if (m_TimestampQueryPool)
+	{
+		vkDestroyQueryPool(m_Device->GetHandle(), m_TimestampQueryPool, nullptr);
+	}
+
+	if (HasReadbackBuffer())
+	{
+		m_ReadbackBuffer.Destroy();
+	}
+
+	m_IndirectBuffer.Destroy();
+	m_UniformBuffer.Destroy();
+
+	m_DescriptorAllocator.Destroy();
+
+	// Command buffer is freed with its pool.
+	vkDestroyCommandPool(m_Device->GetHandle(), m_CommandPool, nullptr);
+
+	m_ImageAvailableSema = VK_NULL_HANDLE;
+	m_UniformDescriptorSet = VK_NULL_HANDLE;
+	m_InputDescriptorSet = VK_NULL_HANDLE;
+	m_CommandPool = VK_NULL_HANDLE;
+	m_CmdBuffer = {};
+	m_ReadbackCmdBuffer = {};
+	m_ReadbackFrame = INDEX_NONE;
+	m_TimestampQueryPool = VK_NULL_HANDLE;
+	m_Stats = {};
+	m_StatsPending = false;
+	m_TimelineValue = 0;
+}
+
+void vge::FrameContext::Reset()
+{
+	VK_ENSURE(vkResetCommandPool(m_Device->GetHandle(), m_CommandPool, 0));
+	m_IndirectBuffer.Reset();
+
+	m_DescriptorAllocator.Reset();
+	m_UniformDescriptorSet = VK_NULL_HANDLE;
+	m_InputDescriptorSet = VK_NULL_HANDLE;
+}
+
+void vge::FrameContext::AllocateUniformDescriptorSet(VkDescriptorSetLayout layout)
+{
+	m_UniformDescriptorSet = m_DescriptorAllocator.Allocate(layout);
+	ENSURE_MSG(m_UniformDescriptorSet != VK_NULL_HANDLE, "Failed to allocate uniform descriptor set.");
+
+	VkDescriptorBufferInfo descriptorBufferInfo = {};
+	descriptorBufferInfo.buffer = m_UniformBuffer.Handle;
+	descriptorBufferInfo.offset = 0;
+	descriptorBufferInfo.range = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet setWrite = {};
+	setWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	setWrite.dstSet = m_UniformDescriptorSet;
+	setWrite.dstBinding = 0;
+	setWrite.dstArrayElement = 0;
+	setWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	setWrite.descriptorCount = 1;
+	setWrite.pBufferInfo = &descriptorBufferInfo;
+
+	vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &setWrite, 0, nullptr);
+}
+
+void vge::FrameContext::AllocateInputDescriptorSet(VkDescriptorSetLayout layout, VkImageView colorView, VkImageView depthView)
+{
+	m_InputDescriptorSet = m_DescriptorAllocator.Allocate(layout);
+	ENSURE_MSG(m_InputDescriptorSet != VK_NULL_HANDLE, "Failed to allocate input descriptor set.");
+
+	VkDescriptorImageInfo colorInputDescriptorImageInfo = {};
+	colorInputDescriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	colorInputDescriptorImageInfo.imageView = colorView;
+	colorInputDescriptorImageInfo.sampler = VK_NULL_HANDLE;
+
+	VkWriteDescriptorSet colorSetWrite = {};
+	colorSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	colorSetWrite.dstSet = m_InputDescriptorSet;
+	colorSetWrite.dstBinding = 0;
+	colorSetWrite.dstArrayElement = 0;
+	colorSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	colorSetWrite.descriptorCount = 1;
+	colorSetWrite.pImageInfo = &colorInputDescriptorImageInfo;
+
+	VkDescriptorImageInfo depthInputDescriptorImageInfo = {};
+	depthInputDescriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	depthInputDescriptorImageInfo.imageView = depthView;
+	depthInputDescriptorImageInfo.sampler = VK_NULL_HANDLE;
+
+	VkWriteDescriptorSet depthSetWrite = {};
+	depthSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	depthSetWrite.dstSet = m_InputDescriptorSet;
+	depthSetWrite.dstBinding = 1;
+	depthSetWrite.dstArrayElement = 0;
+	depthSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	depthSetWrite.descriptorCount = 1;
+	depthSetWrite.pImageInfo = &depthInputDescriptorImageInfo;
+
+	const std::array<VkWriteDescriptorSet, 2> setWrites = { colorSetWrite, depthSetWrite };
+
+	vkUpdateDescriptorSets(m_Device->GetHandle(), static_cast<u32>(setWrites.size()), setWrites.data(), 0, nullptr);
+}
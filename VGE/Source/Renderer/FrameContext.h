@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "DescriptorAllocator.h"
+
+namespace vge
+{
+	class Device;
+
+	struct FrameContextCreateInfo
+	{
+		const Device* Device = nullptr;
+		u32 MaxIndirectDraws = 0;
+		VkDeviceSize UniformBufferSize = 0;
+		VkDeviceSize ReadbackBufferSize = 0;	// 0 - frames are not read back
+		bool Timestamps = false;				// create queries to measure gpu time of frame
+	};
+
+	// Statistics of submitted frame, gpu time is known only after frame retires.
+	struct FrameStats
+	{
+		u64 AppFrame = 0;
+		u32 DrawCallCount = 0;
+		f64 GpuTimeMs = 0.0;	// 0 if timestamps are not supported
+	};
+
+	enum class FrameTimestamp : u32
+	{
+		Begin,
+		End,
+		Count,
+	};
+
+	// Resources used to record and submit one frame in flight.
+	// They are reused only after frame timeline semaphore reaches value signaled by last submit of this frame.
+	// There is no deletion queue per frame, renderer queue tags resources with frame timeline value instead and frees them once it is reached.
+	class FrameContext
+	{
+	public:
+		FrameContext() = default;
+
+		void Initialize(const FrameContextCreateInfo& data);
+		void Destroy();
+
+		// Recycle command buffer, transient descriptor sets and indirect draws, frame must be completed on gpu.
+		void Reset();
+
+		// Sets below are transient, they have to be allocated again after every reset.
+		void AllocateUniformDescriptorSet(VkDescriptorSetLayout layout);
+		// Scene color and depth of this frame read by composition subpass.
+		void AllocateInputDescriptorSet(VkDescriptorSetLayout layout, VkImageView colorView, VkImageView depthView);
+
+		inline CommandBuffer* GetCmdBuffer() { return &m_CmdBuffer; }
+		inline IndirectBuffer* GetIndirectBuffer() { return &m_IndirectBuffer; }
+		inline Buffer* GetUniformBuffer() { return &m_UniformBuffer; }
+		inline VkDescriptorSet GetUniformDescriptorSet() const { return m_UniformDescriptorSet; }
+		inline VkDescriptorSet GetInputDescriptorSet() const { return m_InputDescriptorSet; }
+		inline VkSemaphore GetImageAvailableSemaphore() const { return m_ImageAvailableSema; }
+
+		// Rendered image is copied to host visible buffer by separate command buffer, submitted after the frame one.
+		inline bool HasReadbackBuffer() const { return m_ReadbackBuffer.Handle != VK_NULL_HANDLE; }
+		inline CommandBuffer* GetReadbackCmdBuffer() { return &m_ReadbackCmdBuffer; }
+		inline const Buffer* GetReadbackBuffer() const { return &m_ReadbackBuffer; }
+		// App frame copied to readback buffer by last submit of this frame, INDEX_NONE if nothing was copied.
+		inline i64 GetReadbackFrame() const { return m_ReadbackFrame; }
+		inline void SetReadbackFrame(i64 appFrame) { m_ReadbackFrame = appFrame; }
+
+		// Null if timestamps were not requested.
+		inline VkQueryPool GetTimestampQueryPool() const { return m_TimestampQueryPool; }
+		// Stats of last submit of this frame, valid if pending.
+		inline FrameStats& GetStats() { return m_Stats; }
+		inline bool HasPendingStats() const { return m_StatsPending; }
+		inline void SetPendingStats(bool pending) { m_StatsPending = pending; }
+
+		// Frame timeline value signaled by last submit of this frame, 0 if never submitted.
+		inline u64 GetTimelineValue() const { return m_TimelineValue; }
+		inline void SetTimelineValue(u64 value) { m_TimelineValue = value; }
+
+	private:
+		const Device* m_Device = nullptr;
+
+		VkCommandPool m_CommandPool = VK_NULL_HANDLE;	// reset as whole instead of separate command buffers
+		CommandBuffer m_CmdBuffer = {};
+
+		DescriptorAllocator m_DescriptorAllocator = {};	// transient sets, reset when frame begins again
+		VkDescriptorSet m_UniformDescriptorSet = VK_NULL_HANDLE;
+		VkDescriptorSet m_InputDescriptorSet = VK_NULL_HANDLE;
+
+		Buffer m_UniformBuffer = {};
+		IndirectBuffer m_IndirectBuffer = {};
+
+		CommandBuffer m_ReadbackCmdBuffer = {};
+		Buffer m_ReadbackBuffer = {};
+		i64 m_ReadbackFrame = INDEX_NONE;
+
+		VkQueryPool m_TimestampQueryPool = VK_NULL_HANDLE;
+		FrameStats m_Stats = {};
+		bool m_StatsPending = false;
+
+		VkSemaphore m_ImageAvailableSema = VK_NULL_HANDLE;	// binary, as acquire and present do not accept timeline semaphores
+		u64 m_TimelineValue = 0;
+	};
+}
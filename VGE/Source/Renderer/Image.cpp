@@ -3,6 +3,7 @@
 #include "File.h"
 #include "Buffer.h"
 #include "CommandBuffer.h"
+#include "JobSystem.h"
 
 namespace 
 {
@@ -14,6 +15,25 @@ namespace
 		VkImageLayout NewLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	};
 
+	VkImageCreateInfo GetImageCreateInfo(const vge::ImageCreateInfo& data)
+	{
+		VkImageCreateInfo imageCreateInfo = {};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.extent.width = data.Extent.width;
+		imageCreateInfo.extent.height = data.Extent.height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.format = data.Format;
+		imageCreateInfo.tiling = data.Tiling;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // dont care
+		imageCreateInfo.usage = data.Usage;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // whether can be shared between queues
+		return imageCreateInfo;
+	}
+
 	void TransitionImageLayout(const ImageTransitionInfo& data)
 	{
 		vge::ScopeCmdBuffer cmdBuffer(data.Device);
@@ -89,48 +109,161 @@ VkFormat vge::Image::GetBestFormat(const Device* device, const std::vector<VkFor
 
 vge::Image vge::Image::Create(const ImageCreateInfo& data)
 {
-	VkImageCreateInfo imageCreateInfo = {};
-	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-	imageCreateInfo.extent.width = data.Extent.width;
-	imageCreateInfo.extent.height = data.Extent.height;
-	imageCreateInfo.extent.depth = 1;
-	imageCreateInfo.mipLevels = 1;
-	imageCreateInfo.arrayLayers = 1;
-	imageCreateInfo.format = data.Format;
-	imageCreateInfo.tiling = data.Tiling;
-	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // dont care
-	imageCreateInfo.usage = data.Usage;
-	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // whether can be shared between queues
+	const VkImageCreateInfo imageCreateInfo = GetImageCreateInfo(data);
 
 	VmaAllocationCreateInfo vmaAllocCreateInfo = {};
 	vmaAllocCreateInfo.usage = data.MemAllocUsage;
 
 	Image image = {};
+	image.m_Format = data.Format;
 	image.m_Allocator = data.Device->GetAllocator();
 	VK_ENSURE(vmaCreateImage(image.m_Allocator, &imageCreateInfo, &vmaAllocCreateInfo, &image.m_Handle, &image.m_Allocation, &image.m_AllocInfo));
 
 	return image;
 }
 
+vge::Image vge::Image::CreateUnbound(const ImageCreateInfo& data)
+{
+	const VkImageCreateInfo imageCreateInfo = GetImageCreateInfo(data);
+
+	Image image = {};
+	image.m_Format = data.Format;
+	image.m_Allocator = data.Device->GetAllocator();
+	VK_ENSURE(vkCreateImage(data.Device->GetHandle(), &imageCreateInfo, nullptr, &image.m_Handle));
+
+	return image;
+}
+
 vge::Image vge::Image::CreateForTexture(const Device* device, const char* filename)
 {
-	i32 width = 0, height = 0;
-	VkDeviceSize textureSize = 0;
-	stbi_uc* textureData = file::LoadTexture(filename, width, height, textureSize);
+	std::vector<Image> images;
+	CreateForTextures(device, { filename }, images);
+	return images[0];
+}
+
+void vge::Image::CreateForTextures(const Device* device, const std::vector<std::string>& filenames, std::vector<Image>& outImages)
+{
+	SCOPE_TIMER("Create textures");
 
-	const VkExtent2D textureExtent = { static_cast<u32>(width), static_cast<u32>(height) };
+	struct TextureUpload
+	{
+		std::string CookedPath;
+		VkExtent2D Extent = {};
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		Buffer StageBuffer = {};
+		bool Cooked = false;
+		bool Decoded = false;
+	};
 
-	ScopeStageBuffer stageBuffer(device, textureSize);
-	stageBuffer.Get().TransferToGpuMemory(textureData, static_cast<size_t>(textureSize));
+	std::vector<TextureUpload> uploads(filenames.size());
 
-	file::FreeTexture(textureData);
+	// Read headers and allocate persistently mapped stage buffers to decode to.
+	for (size_t i = 0; i < filenames.size(); ++i)
+	{
+		TextureUpload& upload = uploads[i];
+		VkDeviceSize dataSize = 0;
+
+		// Prefer cooked block compressed texture if it exists and device can sample it.
+		upload.CookedPath = file::GetCookedTexturePath(filenames[i].c_str());
+
+		bc::CookedTextureHeader header = {};
+		if (file::LoadCookedTextureHeader(upload.CookedPath.c_str(), header))
+		{
+			const VkFormat cookedFormat = bc::FormatToVk(header.Format);
+			const bool supported = device->GetEnabledFeatures().textureCompressionBC &&
+				GetBestFormat(device, { cookedFormat }, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) == cookedFormat;
+
+			if (supported)
+			{
+				upload.Cooked = true;
+				upload.Extent = { header.Width, header.Height };
+				upload.Format = cookedFormat;
+				dataSize = header.DataSize;
+			}
+			else
+			{
+				LOG(Warning, "Cooked texture format %s is not supported by device, loading source %s.", bc::FormatToString(header.Format), filenames[i].c_str());
+			}
+		}
+
+		if (!upload.Cooked)
+		{
+			i32 width = 0, height = 0, channels = 0;
+			if (!file::GetTextureInfo(filenames[i].c_str(), width, height, channels))
+			{
+				// Fallback to 1x1 texture, its pixel is set after decode.
+				width = height = 1;
+			}
+
+			upload.Extent = { static_cast<u32>(width), static_cast<u32>(height) };
+			upload.Format = VK_FORMAT_R8G8B8A8_UNORM;
+			dataSize = static_cast<VkDeviceSize>(width) * height * 4;
+		}
+
+		BufferCreateInfo buffCreateInfo = {};
+		buffCreateInfo.Device = device;
+		buffCreateInfo.Size = dataSize;
+		buffCreateInfo.Usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		buffCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+		buffCreateInfo.MemAllocFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		upload.StageBuffer = Buffer::Create(buffCreateInfo);
+	}
+
+	// Decode straight to mapped stage memory, each texture on its own job.
+	auto decodeTexture = [&](u32 i)
+	{
+		TextureUpload& upload = uploads[i];
+		u8* dst = static_cast<u8*>(upload.StageBuffer.AllocInfo.pMappedData);
+		const size_t dstSize = static_cast<size_t>(upload.StageBuffer.AllocInfo.size);
 
+		if (upload.Cooked)
+		{
+			upload.Decoded = file::LoadCookedTextureData(upload.CookedPath.c_str(), dst, dstSize);
+		}
+		else
+		{
+			upload.Decoded = file::DecodeTexture(filenames[i].c_str(), dst, dstSize);
+		}
+	};
+
+	if (GJobSystem && uploads.size() > 1)
+	{
+		GJobSystem->ParallelFor(static_cast<u32>(uploads.size()), decodeTexture);
+	}
+	else
+	{
+		for (u32 i = 0; i < static_cast<u32>(uploads.size()); ++i)
+		{
+			decodeTexture(i);
+		}
+	}
+
+	// Create images and upload on calling thread, as command pool is not thread safe.
+	outImages.resize(uploads.size());
+	for (size_t i = 0; i < uploads.size(); ++i)
+	{
+		TextureUpload& upload = uploads[i];
+
+		if (!upload.Decoded)
+		{
+			static constexpr u32 MissingTexturePixel = 0xFFFF00FF; // magenta
+			memory::Memcopy(upload.StageBuffer.AllocInfo.pMappedData, (void*)&MissingTexturePixel, sizeof(MissingTexturePixel));
+			upload.Extent = { 1, 1 };
+			upload.Format = VK_FORMAT_R8G8B8A8_UNORM;
+		}
+
+		outImages[i] = CreateForTextureData(device, upload.Extent, upload.Format, upload.StageBuffer);
+		upload.StageBuffer.Destroy();
+	}
+}
+
+vge::Image vge::Image::CreateForTextureData(const Device* device, VkExtent2D extent, VkFormat format, const Buffer& stageBuffer)
+{
 	ImageCreateInfo imageCreateInfo = {};
 	imageCreateInfo.Device = device;
-	imageCreateInfo.Extent = textureExtent;
-	imageCreateInfo.Format = VK_FORMAT_R8G8B8A8_UNORM;
+	imageCreateInfo.Extent = extent;
+	imageCreateInfo.Format = format;
 	imageCreateInfo.Tiling = VK_IMAGE_TILING_OPTIMAL;
 	imageCreateInfo.Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 	imageCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -152,9 +285,9 @@ vge::Image vge::Image::CreateForTexture(const Device* device, const char* filena
 	{
 		BufferImageCopyInfo imageCopyInfo = {};
 		imageCopyInfo.Device = device;
-		imageCopyInfo.SrcBuffer = stageBuffer.Get().Handle;
+		imageCopyInfo.SrcBuffer = stageBuffer.Handle;
 		imageCopyInfo.DstImage = image.m_Handle;
-		imageCopyInfo.Extent = textureExtent;
+		imageCopyInfo.Extent = extent;
 		Buffer::CopyToImage(imageCopyInfo);
 	}
 
@@ -191,6 +324,22 @@ VkImageView vge::Image::CreateView(const ImageViewCreateInfo& data)
 	return view;
 }
 
+VkMemoryRequirements vge::Image::GetMemoryRequirements() const
+{
+	VmaAllocatorInfo allocatorInfo = {};
+	vmaGetAllocatorInfo(m_Allocator, &allocatorInfo);
+
+	VkMemoryRequirements memRequirements = {};
+	vkGetImageMemoryRequirements(allocatorInfo.device, m_Handle, &memRequirements);
+
+	return memRequirements;
+}
+
+void vge::Image::BindMemory(VmaAllocation allocation)
+{
+	VK_ENSURE(vmaBindImageMemory(m_Allocator, allocation, m_Handle));
+}
+
 void vge::Image::Destroy()
 {
 	vmaDestroyImage(m_Allocator, m_Handle, m_Allocation);
@@ -198,4 +347,5 @@ void vge::Image::Destroy()
 	m_Allocation = VK_NULL_HANDLE;
 	memory::Memzero(&m_AllocInfo, sizeof(VmaAllocationInfo));
 	m_Allocator = VK_NULL_HANDLE;
+	m_Format = VK_FORMAT_UNDEFINED;
 }
@@ -6,6 +6,7 @@
 namespace vge
 {
 	class Device;
+	struct Buffer;
 
 	struct ImageCreateInfo
 	{
@@ -29,7 +30,13 @@ namespace vge
 	{
 	public:
 		static Image Create(const ImageCreateInfo& data);
+		// Create image without memory, it must be bound later, e.g. to allocation shared with other images.
+		static Image CreateUnbound(const ImageCreateInfo& data);
 		static Image CreateForTexture(const Device* device, const char* filename);
+		// Decode given textures in parallel (if job system exists) and create sampled images for them.
+		static void CreateForTextures(const Device* device, const std::vector<std::string>& filenames, std::vector<Image>& outImages);
+		// Create sampled image and upload tightly packed data of given format from stage buffer to it.
+		static Image CreateForTextureData(const Device* device, VkExtent2D extent, VkFormat format, const Buffer& stageBuffer);
 		static VkImageView CreateView(const ImageViewCreateInfo& data);
 		static VkFormat GetBestFormat(const Device* device, const std::vector<VkFormat>& formats, VkFormatFeatureFlags features, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
 
@@ -37,12 +44,18 @@ namespace vge
 		Image() = default;
 		void Destroy();
 
+		VkMemoryRequirements GetMemoryRequirements() const;
+		// Bind memory owned by caller, it is not freed on destroy.
+		void BindMemory(VmaAllocation allocation);
+
 		inline VkImage GetHandle() const { return m_Handle; }
+		inline VkFormat GetFormat() const { return m_Format; }
 
 	private:
 		VkImage m_Handle = VK_NULL_HANDLE;
 		VmaAllocation m_Allocation = VK_NULL_HANDLE;
 		VmaAllocationInfo m_AllocInfo = {};
 		VmaAllocator m_Allocator = VK_NULL_HANDLE;
+		VkFormat m_Format = VK_FORMAT_UNDEFINED;
 	};
 }
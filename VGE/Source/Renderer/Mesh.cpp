@@ -4,9 +4,29 @@ vge::Mesh vge::Mesh::Create(const MeshCreateInfo& data)
 {
 	Mesh mesh = {};
 	mesh.m_TextureId = data.TextureId;
-	mesh.m_VertexBuffer = VertexBuffer::Create(data.Device, data.VertexCount, data.Vertices);
+
+	std::vector<u8> packedVertices;
+	GVertexLayout.Pack(data.Vertices, data.VertexCount, packedVertices, mesh.m_MeshData);
+
+	mesh.m_VertexBuffer = VertexBuffer::Create(data.Device, data.VertexCount, GVertexLayout.GetStride(), packedVertices.data());
 	mesh.m_IndexBuffer = IndexBuffer::Create(data.Device, data.IndexCount, data.Indices);
 
+	if (data.Lods && data.LodCount > 0)
+	{
+		mesh.m_Lods.assign(data.Lods, data.Lods + data.LodCount);
+	}
+	else
+	{
+		MeshLod lod = {};
+		lod.IndexCount = static_cast<u32>(data.IndexCount);
+		mesh.m_Lods.push_back(lod);
+	}
+
+	if (data.Meshlets && data.MeshletCount > 0)
+	{
+		mesh.m_Meshlets.assign(data.Meshlets, data.Meshlets + data.MeshletCount);
+	}
+
 	return mesh;
 }
 
@@ -2,6 +2,8 @@
 
 #include "Common.h"
 #include "Buffer.h"
+#include "VertexLayout.h"
+#include "MeshOptimizer.h"
 
 namespace vge
 {
@@ -12,6 +14,12 @@ namespace vge
 		alignas(16) glm::mat4 ModelMatrix = glm::mat4(1.0f);
 	};
 
+	// Pushed after ModelData and MeshData when textures are bindless.
+	struct MaterialData
+	{
+		u32 TextureIndex = 0;
+	};
+
 	struct MeshCreateInfo
 	{
 		const Device* Device = nullptr;
@@ -20,6 +28,10 @@ namespace vge
 		size_t IndexCount = 0;
 		const u32* Indices = nullptr;
 		i32 TextureId = INDEX_NONE;
+		size_t LodCount = 0;
+		const MeshLod* Lods = nullptr; // index ranges of LODs, whole index buffer is single LOD if none given
+		size_t MeshletCount = 0;
+		const Meshlet* Meshlets = nullptr; // referenced by LODs
 	};
 
 	class Mesh
@@ -32,21 +44,28 @@ namespace vge
 
 		inline i32 GetTextureId() const { return m_TextureId; }
 		inline size_t GetIndexCount() const { return m_IndexBuffer.GetIndexCount(); }
+		inline VkIndexType GetIndexType() const { return m_IndexBuffer.GetIndexType(); }
 		inline size_t GetVertexCount() const { return m_VertexBuffer.GetVertexCount(); }
 		inline ModelData GetModelData() const { return m_ModelData; }
+		inline const MeshData& GetMeshData() const { return m_MeshData; }
+		inline u32 GetLodCount() const { return static_cast<u32>(m_Lods.size()); }
+		inline const MeshLod& GetLod(u32 index) const { return m_Lods[std::min(index, GetLodCount() - 1)]; }
+		inline const Meshlet& GetMeshlet(u32 index) const { return m_Meshlets[index]; }
 		inline IndexBuffer* GetIndexBuffer() { return &m_IndexBuffer; }
 		inline VertexBuffer* GetVertexBuffer() { return &m_VertexBuffer; }
 		inline const IndexBuffer* GetIndexBuffer() const { return &m_IndexBuffer; }
 		inline const VertexBuffer* GetVertexBuffer() const { return &m_VertexBuffer; }
 
 		inline void SetModelData(const ModelData& data) { m_ModelData = data; }
-		inline void SetModelMatrix(const glm::mat4& model) { m_ModelData.ModelMatrix = model; }
 
 		void Destroy();
 
 	private:
 		i32 m_TextureId = INDEX_NONE;
 		ModelData m_ModelData = {};
+		MeshData m_MeshData = {};
+		std::vector<MeshLod> m_Lods = {};
+		std::vector<Meshlet> m_Meshlets = {};
 		IndexBuffer m_IndexBuffer = {};
 		VertexBuffer m_VertexBuffer = {};
 	};
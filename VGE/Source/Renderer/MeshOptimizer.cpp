@@ -0,0 +1,843 @@
+#include "MeshOptimizer.h"
+
+namespace
+{
+	// Forsyth vertex cache optimisation parameters, see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+	constexpr vge::u32 ForsythCacheSize = 32;
+	constexpr vge::f32 CacheDecayPower = 1.5f;
+	constexpr vge::f32 LastTriangleScore = 0.75f;
+	constexpr vge::f32 ValenceBoostScale = 2.0f;
+	constexpr vge::f32 ValenceBoostPower = 0.5f;
+
+	constexpr vge::u32 InvalidIndex = ~0u;
+
+	vge::f32 GetVertexScore(vge::i32 cachePosition, vge::u32 liveTriangleCount)
+	{
+		if (liveTriangleCount == 0)
+		{
+			// No triangles left, vertex is not needed anymore.
+			return -1.0f;
+		}
+
+		vge::f32 score = 0.0f;
+
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				// Vertex was used in the last triangle, fixed score to not favour any of them.
+				score = LastTriangleScore;
+			}
+			else
+			{
+				const vge::f32 scaler = 1.0f / (ForsythCacheSize - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+			}
+		}
+
+		// Boost vertices with few triangles left, so lone triangles are not left behind.
+		score += ValenceBoostScale * std::pow(static_cast<vge::f32>(liveTriangleCount), -ValenceBoostPower);
+
+		return score;
+	}
+
+	// Count misses of FIFO cache for each triangle, calls onTriangle(triangleIndex, missCount).
+	template<typename Func>
+	void SimulateFifoCache(const vge::u32* indices, size_t indexCount, size_t vertexCount, vge::u32 cacheSize, Func&& onTriangle)
+	{
+		std::vector<vge::u32> cacheTimestamps(vertexCount, 0);
+		vge::u32 timestamp = cacheSize + 1;
+
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			vge::u32 missCount = 0;
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const vge::u32 index = indices[i + j];
+				if (timestamp - cacheTimestamps[index] > cacheSize)
+				{
+					cacheTimestamps[index] = timestamp++;
+					++missCount;
+				}
+			}
+
+			onTriangle(i / 3, missCount);
+		}
+	}
+}
+
+vge::meshopt::VertexCacheStats vge::meshopt::AnalyzeVertexCache(const u32* indices, size_t indexCount, size_t vertexCount, u32 cacheSize /*= GVertexCacheSize*/)
+{
+	VertexCacheStats stats = {};
+
+	if (indexCount < 3 || vertexCount == 0)
+	{
+		return stats;
+	}
+
+	SimulateFifoCache(indices, indexCount, vertexCount, cacheSize, [&stats](size_t, u32 missCount) { stats.TransformedVertexCount += missCount; });
+
+	std::vector<bool> usedVertices(vertexCount, false);
+	size_t usedVertexCount = 0;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		if (!usedVertices[indices[i]])
+		{
+			usedVertices[indices[i]] = true;
+			++usedVertexCount;
+		}
+	}
+
+	stats.Acmr = static_cast<f32>(stats.TransformedVertexCount) / (indexCount / 3);
+	stats.Atvr = static_cast<f32>(stats.TransformedVertexCount) / usedVertexCount;
+
+	return stats;
+}
+
+void vge::meshopt::OptimizeVertexCache(u32* indices, size_t indexCount, size_t vertexCount)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Vertex to triangles adjacency, stored as offsets into single array.
+	std::vector<u32> liveTriangleCounts(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; ++i)
+	{
+		++liveTriangleCounts[indices[i]];
+	}
+
+	std::vector<u32> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangleCounts[v];
+	}
+
+	std::vector<u32> adjacency(triangleCount * 3);
+	{
+		std::vector<u32> fillCounts(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			const u32 v = indices[i];
+			adjacency[adjacencyOffsets[v] + fillCounts[v]++] = static_cast<u32>(i / 3);
+		}
+	}
+
+	std::vector<i32> cachePositions(vertexCount, -1);
+	std::vector<f32> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		vertexScores[v] = GetVertexScore(-1, liveTriangleCounts[v]);
+	}
+
+	std::vector<f32> triangleScores(triangleCount);
+	std::vector<bool> emittedTriangles(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3 + 0]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+	}
+
+	std::vector<u32> result;
+	result.reserve(triangleCount * 3);
+
+	std::vector<u32> cache;
+	std::vector<u32> newCache;
+	cache.reserve(ForsythCacheSize + 3);
+	newCache.reserve(ForsythCacheSize + 3);
+
+	size_t nextUnemittedCursor = 0;
+	u32 bestTriangle = static_cast<u32>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+	while (bestTriangle != InvalidIndex)
+	{
+		emittedTriangles[bestTriangle] = true;
+
+		const u32* triangle = indices + bestTriangle * 3;
+		result.insert(result.end(), triangle, triangle + 3);
+
+		// Remove emitted triangle from adjacency of its vertices.
+		for (u32 j = 0; j < 3; ++j)
+		{
+			const u32 v = triangle[j];
+			u32* begin = adjacency.data() + adjacencyOffsets[v];
+			u32* end = begin + liveTriangleCounts[v];
+			u32* it = std::find(begin, end, bestTriangle);
+			if (it != end)
+			{
+				std::swap(*it, *(end - 1));
+				--liveTriangleCounts[v];
+			}
+		}
+
+		// Move triangle vertices to front of LRU cache.
+		newCache.assign(triangle, triangle + 3);
+		for (u32 v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+		std::swap(cache, newCache);
+
+		// Update scores of cached (and just evicted) vertices and their triangles, pick best of them.
+		bestTriangle = InvalidIndex;
+		f32 bestScore = -1.0f;
+
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			const u32 v = cache[i];
+			const i32 cachePosition = i < ForsythCacheSize ? static_cast<i32>(i) : -1;
+			cachePositions[v] = cachePosition;
+
+			const f32 newScore = GetVertexScore(cachePosition, liveTriangleCounts[v]);
+			const f32 scoreDelta = newScore - vertexScores[v];
+			vertexScores[v] = newScore;
+
+			for (u32 a = 0; a < liveTriangleCounts[v]; ++a)
+			{
+				const u32 t = adjacency[adjacencyOffsets[v] + a];
+				triangleScores[t] += scoreDelta;
+
+				if (triangleScores[t] > bestScore)
+				{
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if (cache.size() > ForsythCacheSize)
+		{
+			cache.resize(ForsythCacheSize);
+		}
+
+		// Cached vertices have no triangles left, continue from next not emitted one.
+		if (bestTriangle == InvalidIndex)
+		{
+			while (nextUnemittedCursor < triangleCount && emittedTriangles[nextUnemittedCursor])
+			{
+				++nextUnemittedCursor;
+			}
+
+			if (nextUnemittedCursor < triangleCount)
+			{
+				bestTriangle = static_cast<u32>(nextUnemittedCursor);
+			}
+		}
+	}
+
+	memory::Memcopy(indices, result.data(), result.size() * sizeof(u32));
+}
+
+void vge::meshopt::OptimizeOverdraw(u32* indices, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	auto getPosition = [positions, positionStride](u32 index)
+	{
+		const f32* p = reinterpret_cast<const f32*>(reinterpret_cast<const u8*>(positions) + index * positionStride);
+		return glm::vec3(p[0], p[1], p[2]);
+	};
+
+	// Split to clusters where cache is effectively flushed (all 3 vertices missed),
+	// so reordering clusters does not break cache locality inside them.
+	std::vector<u32> clusterStarts;
+	SimulateFifoCache(indices, indexCount, vertexCount, GVertexCacheSize, [&clusterStarts](size_t t, u32 missCount)
+	{
+		if (t == 0 || missCount == 3)
+		{
+			clusterStarts.push_back(static_cast<u32>(t));
+		}
+	});
+
+	glm::vec3 meshCentroid = glm::vec3(0.0f);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		meshCentroid += getPosition(static_cast<u32>(v));
+	}
+	meshCentroid /= static_cast<f32>(vertexCount);
+
+	struct Cluster
+	{
+		u32 FirstTriangle = 0;
+		u32 TriangleCount = 0;
+		f32 SortKey = 0.0f;
+	};
+
+	std::vector<Cluster> clusters(clusterStarts.size());
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		Cluster& cluster = clusters[c];
+		cluster.FirstTriangle = clusterStarts[c];
+		cluster.TriangleCount = (c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : static_cast<u32>(triangleCount)) - cluster.FirstTriangle;
+
+		// Area weighted centroid and normal of cluster.
+		glm::vec3 centroid = glm::vec3(0.0f);
+		glm::vec3 normal = glm::vec3(0.0f);
+		f32 area = 0.0f;
+
+		for (u32 t = cluster.FirstTriangle; t < cluster.FirstTriangle + cluster.TriangleCount; ++t)
+		{
+			const glm::vec3 p0 = getPosition(indices[t * 3 + 0]);
+			const glm::vec3 p1 = getPosition(indices[t * 3 + 1]);
+			const glm::vec3 p2 = getPosition(indices[t * 3 + 2]);
+
+			const glm::vec3 triangleNormal = glm::cross(p1 - p0, p2 - p0);
+			const f32 triangleArea = glm::length(triangleNormal);
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += triangleNormal;
+			area += triangleArea;
+		}
+
+		if (area > 0.0f)
+		{
+			centroid /= area;
+		}
+
+		const f32 normalLength = glm::length(normal);
+		if (normalLength > 0.0f)
+		{
+			normal /= normalLength;
+		}
+
+		// The more cluster faces outwards from mesh center, the earlier it should be drawn.
+		cluster.SortKey = glm::dot(centroid - meshCentroid, normal);
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.SortKey > b.SortKey; });
+
+	std::vector<u32> result;
+	result.reserve(triangleCount * 3);
+
+	for (const Cluster& cluster : clusters)
+	{
+		const u32* first = indices + cluster.FirstTriangle * 3;
+		result.insert(result.end(), first, first + cluster.TriangleCount * 3);
+	}
+
+	memory::Memcopy(indices, result.data(), result.size() * sizeof(u32));
+}
+
+size_t vge::meshopt::OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, u32* indices, size_t indexCount)
+{
+	std::vector<u32> remap(vertexCount, InvalidIndex);
+	std::vector<u8> reordered(vertexCount * vertexSize);
+
+	u8* src = static_cast<u8*>(vertices);
+	u32 nextVertex = 0;
+
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		const u32 index = indices[i];
+
+		if (remap[index] == InvalidIndex)
+		{
+			remap[index] = nextVertex;
+			memory::Memcopy(reordered.data() + nextVertex * vertexSize, src + index * vertexSize, vertexSize);
+			++nextVertex;
+		}
+
+		indices[i] = remap[index];
+	}
+
+	memory::Memcopy(vertices, reordered.data(), nextVertex * vertexSize);
+
+	return nextVertex;
+}
+
+namespace
+{
+	// Symmetric 4x4 matrix of plane quadric with total weight, error of point p is (p^T A p + 2 b^T p + c) / weight.
+	struct Quadric
+	{
+		vge::f64 A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+		vge::f64 B0 = 0, B1 = 0, B2 = 0;
+		vge::f64 C = 0;
+		vge::f64 Weight = 0;
+
+		void AddPlane(const glm::dvec3& n, vge::f64 d, vge::f64 weight)
+		{
+			A00 += weight * n.x * n.x; A01 += weight * n.x * n.y; A02 += weight * n.x * n.z;
+			A11 += weight * n.y * n.y; A12 += weight * n.y * n.z; A22 += weight * n.z * n.z;
+			B0 += weight * n.x * d; B1 += weight * n.y * d; B2 += weight * n.z * d;
+			C += weight * d * d;
+			Weight += weight;
+		}
+
+		void Add(const Quadric& other)
+		{
+			A00 += other.A00; A01 += other.A01; A02 += other.A02;
+			A11 += other.A11; A12 += other.A12; A22 += other.A22;
+			B0 += other.B0; B1 += other.B1; B2 += other.B2;
+			C += other.C;
+			Weight += other.Weight;
+		}
+
+		vge::f64 Evaluate(const glm::dvec3& p) const
+		{
+			const vge::f64 error =
+				p.x * p.x * A00 + 2.0 * p.x * p.y * A01 + 2.0 * p.x * p.z * A02 +
+				p.y * p.y * A11 + 2.0 * p.y * p.z * A12 + p.z * p.z * A22 +
+				2.0 * (p.x * B0 + p.y * B1 + p.z * B2) + C;
+
+			return Weight > 0.0 ? std::abs(error) / Weight : 0.0;
+		}
+	};
+
+	struct EdgeCollapse
+	{
+		vge::u32 From = 0;
+		vge::u32 To = 0;
+		vge::f64 Error = 0.0;
+	};
+
+	// Map each vertex to first vertex with bitwise equal position.
+	void BuildPositionRemap(const vge::f32* positions, size_t vertexCount, size_t positionStride, std::vector<vge::u32>& outRemap)
+	{
+		auto getPosition = [positions, positionStride](size_t index)
+		{
+			return reinterpret_cast<const vge::f32*>(reinterpret_cast<const vge::u8*>(positions) + index * positionStride);
+		};
+
+		std::vector<vge::u32> order(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			order[i] = static_cast<vge::u32>(i);
+		}
+
+		std::sort(order.begin(), order.end(), [&getPosition](vge::u32 a, vge::u32 b)
+		{
+			const vge::i32 cmp = std::memcmp(getPosition(a), getPosition(b), sizeof(vge::f32) * 3);
+			return cmp != 0 ? cmp < 0 : a < b;
+		});
+
+		outRemap.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const bool samePosition = i > 0 && std::memcmp(getPosition(order[i]), getPosition(order[i - 1]), sizeof(vge::f32) * 3) == 0;
+			outRemap[order[i]] = samePosition ? outRemap[order[i - 1]] : order[i];
+		}
+	}
+}
+
+size_t vge::meshopt::Simplify(u32* dst, const u32* indices, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride,
+	size_t targetIndexCount, f32 targetError, f32* outError /*= nullptr*/)
+{
+	auto getPosition = [positions, positionStride](u32 index)
+	{
+		const f32* p = reinterpret_cast<const f32*>(reinterpret_cast<const u8*>(positions) + index * positionStride);
+		return glm::dvec3(p[0], p[1], p[2]);
+	};
+
+	std::vector<u32> result(indices, indices + indexCount);
+
+	std::vector<u32> positionRemap;
+	BuildPositionRemap(positions, vertexCount, positionStride, positionRemap);
+
+	// Lock seams (several vertices share position) and borders (welded edge used by single triangle).
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::vector<u32> siblingCounts(vertexCount, 0);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			++siblingCounts[positionRemap[v]];
+		}
+
+		std::unordered_map<u64, u32> edgeCounts;
+		edgeCounts.reserve(indexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			for (u32 e = 0; e < 3; ++e)
+			{
+				const u32 a = positionRemap[indices[i + e]];
+				const u32 b = positionRemap[indices[i + (e + 1) % 3]];
+				++edgeCounts[(static_cast<u64>(std::min(a, b)) << 32) | std::max(a, b)];
+			}
+		}
+
+		for (const auto& [edge, count] : edgeCounts)
+		{
+			if (count == 1)
+			{
+				locked[static_cast<u32>(edge >> 32)] = true;
+				locked[static_cast<u32>(edge & 0xFFFFFFFF)] = true;
+			}
+		}
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			if (siblingCounts[v] > 1)
+			{
+				locked[v] = true;
+			}
+		}
+	}
+
+	// Quadrics are accumulated per position, not per vertex.
+	std::vector<Quadric> quadrics(vertexCount);
+	glm::dvec3 boundsMin = glm::dvec3(DBL_MAX);
+	glm::dvec3 boundsMax = glm::dvec3(-DBL_MAX);
+
+	for (size_t i = 0; i < indexCount; i += 3)
+	{
+		const glm::dvec3 p0 = getPosition(indices[i + 0]);
+		const glm::dvec3 p1 = getPosition(indices[i + 1]);
+		const glm::dvec3 p2 = getPosition(indices[i + 2]);
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		const f64 doubleArea = glm::length(normal);
+		if (doubleArea <= 0.0)
+		{
+			continue;
+		}
+
+		normal /= doubleArea;
+		const f64 d = -glm::dot(normal, p0);
+
+		for (u32 j = 0; j < 3; ++j)
+		{
+			quadrics[positionRemap[indices[i + j]]].AddPlane(normal, d, doubleArea * 0.5);
+		}
+	}
+
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		boundsMin = glm::min(boundsMin, getPosition(static_cast<u32>(v)));
+		boundsMax = glm::max(boundsMax, getPosition(static_cast<u32>(v)));
+	}
+
+	const f64 maxError = static_cast<f64>(targetError) * glm::length(boundsMax - boundsMin);
+	const f64 maxErrorSquared = maxError * maxError;
+	f64 resultErrorSquared = 0.0;
+
+	std::vector<u32> collapseTargets(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<u32> adjacencyOffsets(vertexCount + 1);
+	std::vector<u32> adjacency;
+	std::vector<EdgeCollapse> collapses;
+
+	// Each pass collapses independent edges in order of increasing error, then rebuilds triangles.
+	while (result.size() > targetIndexCount)
+	{
+		const size_t triangleCount = result.size() / 3;
+
+		// Vertex to triangles adjacency for flip checks.
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (u32 index : result)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+
+		adjacency.resize(result.size());
+		{
+			std::vector<u32> fillCounts(vertexCount, 0);
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				const u32 v = result[i];
+				adjacency[adjacencyOffsets[v] + fillCounts[v]++] = static_cast<u32>(i / 3);
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (u32 e = 0; e < 3; ++e)
+			{
+				const u32 from = result[i + e];
+				const u32 to = result[i + (e + 1) % 3];
+
+				for (const auto& [a, b] : { std::make_pair(from, to), std::make_pair(to, from) })
+				{
+					if (locked[positionRemap[a]])
+					{
+						continue;
+					}
+
+					Quadric quadric = quadrics[positionRemap[a]];
+					quadric.Add(quadrics[positionRemap[b]]);
+
+					collapses.push_back({ a, b, quadric.Evaluate(getPosition(b)) });
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b) { return a.Error < b.Error; });
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			collapseTargets[v] = static_cast<u32>(v);
+		}
+		std::fill(touched.begin(), touched.end(), false);
+
+		const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3 + 1;
+		size_t removedTriangles = 0;
+
+		for (const EdgeCollapse& collapse : collapses)
+		{
+			if (collapse.Error > maxErrorSquared || removedTriangles >= trianglesToRemove)
+			{
+				break;
+			}
+
+			const u32 fromPosition = positionRemap[collapse.From];
+			const u32 toPosition = positionRemap[collapse.To];
+
+			if (fromPosition == toPosition || touched[fromPosition] || touched[toPosition])
+			{
+				continue;
+			}
+
+			// Reject collapse if any remaining triangle around collapsed vertex flips, count removed ones.
+			const glm::dvec3 fromPos = getPosition(collapse.From);
+			const glm::dvec3 toPos = getPosition(collapse.To);
+
+			bool flips = false;
+			size_t collapsedTriangles = 0;
+
+			for (u32 a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; ++a)
+			{
+				const u32* triangle = result.data() + adjacency[a] * 3;
+
+				u32 corner = 0;
+				bool hasTarget = false;
+				for (u32 j = 0; j < 3; ++j)
+				{
+					corner = triangle[j] == collapse.From ? j : corner;
+					hasTarget |= positionRemap[triangle[j]] == toPosition;
+				}
+
+				if (hasTarget)
+				{
+					++collapsedTriangles;
+					continue;
+				}
+
+				const glm::dvec3 p1 = getPosition(triangle[(corner + 1) % 3]);
+				const glm::dvec3 p2 = getPosition(triangle[(corner + 2) % 3]);
+				const glm::dvec3 oldNormal = glm::cross(p1 - fromPos, p2 - fromPos);
+				const glm::dvec3 newNormal = glm::cross(p1 - toPos, p2 - toPos);
+
+				if (glm::dot(oldNormal, newNormal) <= 0.0)
+				{
+					flips = true;
+					break;
+				}
+			}
+
+			if (flips)
+			{
+				continue;
+			}
+
+			collapseTargets[collapse.From] = collapse.To;
+			quadrics[toPosition].Add(quadrics[fromPosition]);
+			resultErrorSquared = std::max(resultErrorSquared, collapse.Error);
+			removedTriangles += collapsedTriangles;
+
+			// Neighbours are touched as well, so flip checks of this pass stay valid.
+			for (u32 a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; ++a)
+			{
+				const u32* triangle = result.data() + adjacency[a] * 3;
+				touched[positionRemap[triangle[0]]] = true;
+				touched[positionRemap[triangle[1]]] = true;
+				touched[positionRemap[triangle[2]]] = true;
+			}
+		}
+
+		if (removedTriangles == 0)
+		{
+			break;
+		}
+
+		// Apply collapses and drop degenerate triangles.
+		size_t writeIndex = 0;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const u32 v0 = collapseTargets[result[t * 3 + 0]];
+			const u32 v1 = collapseTargets[result[t * 3 + 1]];
+			const u32 v2 = collapseTargets[result[t * 3 + 2]];
+
+			const u32 p0 = positionRemap[v0];
+			const u32 p1 = positionRemap[v1];
+			const u32 p2 = positionRemap[v2];
+
+			if (p0 != p1 && p1 != p2 && p0 != p2)
+			{
+				result[writeIndex++] = v0;
+				result[writeIndex++] = v1;
+				result[writeIndex++] = v2;
+			}
+		}
+
+		result.resize(writeIndex);
+	}
+
+	memory::Memcopy(dst, result.data(), result.size() * sizeof(u32));
+
+	if (outError)
+	{
+		*outError = static_cast<f32>(std::sqrt(resultErrorSquared));
+	}
+
+	return result.size();
+}
+
+void vge::meshopt::GenerateLods(std::vector<u32>& indices, const f32* positions, size_t vertexCount, size_t positionStride, std::vector<MeshLod>& outLods)
+{
+	outLods.clear();
+
+	MeshLod sourceLod = {};
+	sourceLod.FirstIndex = 0;
+	sourceLod.IndexCount = static_cast<u32>(indices.size());
+	sourceLod.Error = 0.0f;
+	outLods.push_back(sourceLod);
+
+	std::vector<u32> lodIndices(sourceLod.IndexCount);
+
+	// Every LOD is simplified from the source one, so its error is measured against source and stays within max error.
+	while (outLods.size() < GMaxLodCount)
+	{
+		const MeshLod previousLod = outLods.back();
+		const size_t targetIndexCount = static_cast<size_t>(previousLod.IndexCount / 3 * GLodTriangleRatio) * 3;
+
+		f32 error = 0.0f;
+		const size_t lodIndexCount = Simplify(lodIndices.data(), indices.data(), sourceLod.IndexCount,
+			positions, vertexCount, positionStride, targetIndexCount, GLodMaxRelativeError, &error);
+
+		// Not worth extra LOD if it saves less than 10% of triangles.
+		if (lodIndexCount == 0 || lodIndexCount > previousLod.IndexCount * 9 / 10)
+		{
+			break;
+		}
+
+		OptimizeVertexCache(lodIndices.data(), lodIndexCount, vertexCount);
+
+		MeshLod lod = {};
+		lod.FirstIndex = static_cast<u32>(indices.size());
+		lod.IndexCount = static_cast<u32>(lodIndexCount);
+		lod.Error = std::max(error, previousLod.Error); // keep errors monotonic for lod selection
+		outLods.push_back(lod);
+
+		indices.insert(indices.end(), lodIndices.begin(), lodIndices.begin() + lodIndexCount);
+	}
+}
+
+void vge::meshopt::BuildMeshlets(const u32* indices, u32 firstIndex, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride,
+	std::vector<Meshlet>& outMeshlets)
+{
+	// Vertex is in current meshlet if its tag equals to current meshlet number.
+	std::vector<u32> meshletTags(vertexCount, InvalidIndex);
+	u32 meshletTag = 0;
+
+	Meshlet meshlet = {};
+	meshlet.FirstIndex = firstIndex;
+	u32 meshletVertexCount = 0;
+
+	auto flushMeshlet = [&]()
+	{
+		ComputeMeshletBounds(indices + (meshlet.FirstIndex - firstIndex), meshlet.IndexCount, positions, positionStride, meshlet);
+		outMeshlets.push_back(meshlet);
+
+		meshlet.FirstIndex += meshlet.IndexCount;
+		meshlet.IndexCount = 0;
+		meshletVertexCount = 0;
+		++meshletTag;
+	};
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		u32 newVertexCount = 0;
+		for (u32 j = 0; j < 3; ++j)
+		{
+			newVertexCount += meshletTags[indices[i + j]] != meshletTag ? 1 : 0;
+		}
+
+		if (meshletVertexCount + newVertexCount > GMeshletMaxVertices || meshlet.IndexCount / 3 >= GMeshletMaxTriangles)
+		{
+			flushMeshlet();
+		}
+
+		for (u32 j = 0; j < 3; ++j)
+		{
+			if (meshletTags[indices[i + j]] != meshletTag)
+			{
+				meshletTags[indices[i + j]] = meshletTag;
+				++meshletVertexCount;
+			}
+		}
+
+		meshlet.IndexCount += 3;
+	}
+
+	if (meshlet.IndexCount > 0)
+	{
+		flushMeshlet();
+	}
+}
+
+void vge::meshopt::ComputeMeshletBounds(const u32* indices, size_t indexCount, const f32* positions, size_t positionStride, Meshlet& outMeshlet)
+{
+	auto getPosition = [positions, positionStride](u32 index)
+	{
+		const f32* p = reinterpret_cast<const f32*>(reinterpret_cast<const u8*>(positions) + index * positionStride);
+		return glm::vec3(p[0], p[1], p[2]);
+	};
+
+	glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+	glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+	glm::vec3 normalSum = glm::vec3(0.0f);
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const glm::vec3 p0 = getPosition(indices[i + 0]);
+		const glm::vec3 p1 = getPosition(indices[i + 1]);
+		const glm::vec3 p2 = getPosition(indices[i + 2]);
+
+		boundsMin = glm::min(boundsMin, glm::min(p0, glm::min(p1, p2)));
+		boundsMax = glm::max(boundsMax, glm::max(p0, glm::max(p1, p2)));
+
+		const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		const f32 length = glm::length(normal);
+		if (length > 0.0f)
+		{
+			normalSum += normal / length;
+		}
+	}
+
+	outMeshlet.Center = (boundsMin + boundsMax) * 0.5f;
+	outMeshlet.Radius = 0.0f;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		outMeshlet.Radius = std::max(outMeshlet.Radius, glm::length(getPosition(indices[i]) - outMeshlet.Center));
+	}
+
+	// Cone axis is average of triangle normals, spread is given by the least aligned normal.
+	const f32 normalSumLength = glm::length(normalSum);
+	outMeshlet.ConeAxis = normalSumLength > 0.0f ? normalSum / normalSumLength : glm::vec3(0.0f, 0.0f, 1.0f);
+
+	f32 minDot = normalSumLength > 0.0f ? 1.0f : -1.0f;
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const glm::vec3 p0 = getPosition(indices[i + 0]);
+		const glm::vec3 normal = glm::cross(getPosition(indices[i + 1]) - p0, getPosition(indices[i + 2]) - p0);
+		const f32 length = glm::length(normal);
+		if (length > 0.0f)
+		{
+			minDot = std::min(minDot, glm::dot(normal / length, outMeshlet.ConeAxis));
+		}
+	}
+
+	outMeshlet.ConeCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+}
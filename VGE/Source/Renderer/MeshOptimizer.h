@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge
+{
+	// Range of mesh index buffer with simplified version of the mesh, all LODs share vertices.
+	struct MeshLod
+	{
+		u32 FirstIndex = 0;
+		u32 IndexCount = 0;
+		f32 Error = 0.0f; // max geometric deviation from source mesh in mesh units
+		u32 FirstMeshlet = 0;
+		u32 MeshletCount = 0;
+	};
+
+	// Small cluster of triangles stored as range of mesh index buffer, culled on its own.
+	struct Meshlet
+	{
+		u32 FirstIndex = 0;
+		u32 IndexCount = 0;
+		glm::vec3 Center = glm::vec3(0.0f);
+		f32 Radius = 0.0f;
+		glm::vec3 ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		f32 ConeCutoff = 1.0f; // sine of normal cone spread angle, 1 when cone covers hemisphere or more and can not be culled
+	};
+}
+
+namespace vge::meshopt
+{
+	// Size of simulated FIFO post-transform cache, conservative for modern GPUs.
+	inline constexpr u32 GVertexCacheSize = 16;
+
+	inline constexpr u32 GMaxLodCount = 4;
+	// Each next LOD targets this fraction of previous LOD triangles.
+	inline constexpr f32 GLodTriangleRatio = 0.5f;
+	// Max error of each LOD relative to mesh bounds diagonal.
+	inline constexpr f32 GLodMaxRelativeError = 0.05f;
+
+	// Meshlet limits, match common mesh shader output limits.
+	inline constexpr u32 GMeshletMaxVertices = 64;
+	inline constexpr u32 GMeshletMaxTriangles = 124;
+
+	struct VertexCacheStats
+	{
+		u32 TransformedVertexCount = 0;
+		f32 Acmr = 0.0f; // average cache miss ratio, transformed vertices per triangle (0.5 - 3.0)
+		f32 Atvr = 0.0f; // average transformed to vertex ratio (1.0 - ...)
+	};
+
+	VertexCacheStats AnalyzeVertexCache(const u32* indices, size_t indexCount, size_t vertexCount, u32 cacheSize = GVertexCacheSize);
+
+	// Reorder triangles for post-transform cache locality (Tom Forsyth, linear-speed vertex cache optimisation).
+	void OptimizeVertexCache(u32* indices, size_t indexCount, size_t vertexCount);
+
+	// Reorder clusters of triangles so outer ones are drawn first to reduce overdraw.
+	// Expects cache optimized indices, clusters are split on cache flushes so ACMR does not get worse.
+	// Positions are read as 3 floats with given byte stride.
+	void OptimizeOverdraw(u32* indices, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride);
+
+	// Reorder vertices in order of first use and remap indices, unused vertices are removed.
+	// Returns new vertex count.
+	size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, u32* indices, size_t indexCount);
+
+	// Simplify mesh with quadric error edge collapse (Garland-Heckbert) keeping original vertices, so result can share vertex buffer.
+	// Vertices on mesh borders and attribute seams (split vertices with equal position) are locked to avoid cracks.
+	// Stops on target index count or when next collapse exceeds target error (relative to bounds diagonal).
+	// Returns index count written to dst (which must hold indexCount indices), outError receives absolute error.
+	size_t Simplify(u32* dst, const u32* indices, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride,
+		size_t targetIndexCount, f32 targetError, f32* outError = nullptr);
+
+	// Append simplified LODs to indices and describe every LOD including source one (LOD 0).
+	// Generation stops when simplification can not reduce triangle count noticeably.
+	void GenerateLods(std::vector<u32>& indices, const f32* positions, size_t vertexCount, size_t positionStride, std::vector<MeshLod>& outLods);
+
+	// Split index range to meshlets in existing triangle order, so cache and overdraw optimizations are preserved.
+	// Meshlets are appended to outMeshlets, their index ranges are absolute (firstIndex included).
+	void BuildMeshlets(const u32* indices, u32 firstIndex, size_t indexCount, const f32* positions, size_t vertexCount, size_t positionStride,
+		std::vector<Meshlet>& outMeshlets);
+
+	// Bounding sphere and normal cone of triangles.
+	void ComputeMeshletBounds(const u32* indices, size_t indexCount, const f32* positions, size_t positionStride, Meshlet& outMeshlet);
+
+	// Run all optimizations on vertices with glm::vec3 Position member, log ACMR/ATVR before and after.
+	template<typename VertexT>
+	void OptimizeMesh(std::vector<VertexT>& vertices, std::vector<u32>& indices, const char* debugName = "")
+	{
+		if (vertices.empty() || indices.size() < 3)
+		{
+			return;
+		}
+
+		const VertexCacheStats before = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+		OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+		OptimizeOverdraw(indices.data(), indices.size(), &vertices[0].Position.x, vertices.size(), sizeof(VertexT));
+		vertices.resize(OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(VertexT), indices.data(), indices.size()));
+
+		const VertexCacheStats after = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+		LOG(Log, "Mesh %s: %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", debugName, indices.size() / 3, before.Acmr, after.Acmr, before.Atvr, after.Atvr);
+	}
+}
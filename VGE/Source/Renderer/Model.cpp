@@ -2,13 +2,23 @@
 #include "Renderer.h"
 #include "File.h"
 #include "Utils.h"
+#include "MeshOptimizer.h"
+
+namespace
+{
+	// Assimp matrices are row major.
+	glm::mat4 ToMat4(const aiMatrix4x4& m)
+	{
+		return glm::mat4(m.a1, m.b1, m.c1, m.d1, m.a2, m.b2, m.c2, m.d2, m.a3, m.b3, m.c3, m.d3, m.a4, m.b4, m.c4, m.d4);
+	}
+}
 
 vge::Model vge::Model::Create(const ModelCreateInfo& data)
 {
 	Assimp::Importer importer;
 	const aiScene* scene = file::LoadModel(data.Filename, importer);
 
-	std::vector<const char*> texturePaths;
+	std::vector<std::string> texturePaths;
 	GetTexturesFromMaterials(scene, texturePaths);
 
 	std::vector<i32> textureToDescriptorSet;
@@ -19,14 +29,27 @@ vge::Model vge::Model::Create(const ModelCreateInfo& data)
 	model.m_Filename = data.Filename;
 	model.m_Device = data.Device;
 
-	model.LoadNode(data.Device, scene, scene->mRootNode, textureToDescriptorSet);
+	model.LoadNode(data.Device, scene, scene->mRootNode, glm::mat4(1.0f), textureToDescriptorSet);
+
+	for (u32 lodIndex = 0; lodIndex < model.GetLodCount(); ++lodIndex)
+	{
+		size_t triangleCount = 0;
+		size_t meshletCount = 0;
+		for (const Mesh& mesh : model.m_Meshes)
+		{
+			triangleCount += mesh.GetLod(lodIndex).IndexCount / 3;
+			meshletCount += mesh.GetLod(lodIndex).MeshletCount;
+		}
+
+		LOG(Log, "LOD %u: %zu triangles, %zu meshlets, error %f", lodIndex, triangleCount, meshletCount, model.m_LodErrors[lodIndex]);
+	}
 
 	LOG(Log, "New - ID: %d, filename: %s", model.GetId(), model.GetFilename());
 
 	return model;
 }
 
-void vge::Model::LoadNode(const Device* device, const aiScene* scene, const aiNode* node, const std::vector<i32>& materialToTextureId)
+void vge::Model::LoadNode(const Device* device, const aiScene* scene, const aiNode* node, const glm::mat4& parentTransform, const std::vector<i32>& materialToTextureId)
 {
 	if (!node)
 	{
@@ -34,31 +57,40 @@ void vge::Model::LoadNode(const Device* device, const aiScene* scene, const aiNo
 		return;
 	}
 
+	const glm::mat4 transform = parentTransform * ToMat4(node->mTransformation);
+
 	for (u32 i = 0; i < node->mNumMeshes; ++i)
 	{
-		LoadMesh(device, scene, scene->mMeshes[node->mMeshes[i]], materialToTextureId);
+		LoadMesh(device, scene, scene->mMeshes[node->mMeshes[i]], transform, materialToTextureId);
 	}
 
 	for (u32 i = 0; i < node->mNumChildren; ++i)
 	{
-		LoadNode(device, scene, node->mChildren[i], materialToTextureId);
+		LoadNode(device, scene, node->mChildren[i], transform, materialToTextureId);
 	}
 }
 
-void vge::Model::LoadMesh(const Device* device, const aiScene* scene, const aiMesh* mesh, const std::vector<i32>& materialToTextureId)
+void vge::Model::LoadMesh(const Device* device, const aiScene* scene, const aiMesh* mesh, const glm::mat4& transform, const std::vector<i32>& materialToTextureId)
 {
-	static constexpr glm::vec3 DontCareColor = glm::vec3(0.0f);
-
 	std::vector<Vertex> vertices(mesh->mNumVertices);
 	std::vector<u32> indices = {};
 
+	const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+	// Mirroring transform turns triangles inside out, so their winding is reversed to keep front faces.
+	const bool flipWinding = glm::determinant(glm::mat3(transform)) < 0.0f;
+
 	for (u32 i = 0; i < mesh->mNumVertices; ++i)
 	{
-		vertices[i].Color = DontCareColor;
+		vertices[i].Position = glm::vec3(transform * glm::vec4(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z, 1.0f));
 
-		vertices[i].Position.x = mesh->mVertices[i].x;
-		vertices[i].Position.y = mesh->mVertices[i].y;
-		vertices[i].Position.z = mesh->mVertices[i].z;
+		if (mesh->mNormals)
+		{
+			vertices[i].Normal = glm::normalize(normalMatrix * glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z));
+		}
+		else
+		{
+			vertices[i].Normal = glm::vec3(0.0f, 0.0f, 1.0f);
+		}
 
 		if (mesh->mTextureCoords[0])
 		{
@@ -68,7 +100,7 @@ void vge::Model::LoadMesh(const Device* device, const aiScene* scene, const aiMe
 		else
 		{
 			vertices[i].TexCoords.x = 0.0f;
-			vertices[i].TexCoords.x = 0.0f;
+			vertices[i].TexCoords.y = 0.0f;
 		}
 	}
 
@@ -77,10 +109,39 @@ void vge::Model::LoadMesh(const Device* device, const aiScene* scene, const aiMe
 		const aiFace face = mesh->mFaces[i];
 		for (u32 j = 0; j < face.mNumIndices; ++j)
 		{
-			indices.push_back(face.mIndices[j]);
+			indices.push_back(face.mIndices[flipWinding ? (face.mNumIndices - j) % face.mNumIndices : j]);
 		}
 	}
 
+	meshopt::OptimizeMesh(vertices, indices, mesh->mName.C_Str());
+
+	std::vector<MeshLod> lods;
+	meshopt::GenerateLods(indices, &vertices[0].Position.x, vertices.size(), sizeof(Vertex), lods);
+
+	std::vector<Meshlet> meshlets;
+	for (MeshLod& lod : lods)
+	{
+		lod.FirstMeshlet = static_cast<u32>(meshlets.size());
+		meshopt::BuildMeshlets(indices.data() + lod.FirstIndex, lod.FirstIndex, lod.IndexCount, &vertices[0].Position.x, vertices.size(), sizeof(Vertex), meshlets);
+		lod.MeshletCount = static_cast<u32>(meshlets.size()) - lod.FirstMeshlet;
+	}
+
+	for (const Vertex& vertex : vertices)
+	{
+		m_BoundsMin = glm::min(m_BoundsMin, vertex.Position);
+		m_BoundsMax = glm::max(m_BoundsMax, vertex.Position);
+	}
+
+	// Meshes with less LODs keep drawing their last one, so it is taken into account for coarser levels too.
+	if (m_LodErrors.size() < lods.size())
+	{
+		m_LodErrors.resize(lods.size(), m_LodErrors.empty() ? 0.0f : m_LodErrors.back());
+	}
+	for (size_t i = 0; i < m_LodErrors.size(); ++i)
+	{
+		m_LodErrors[i] = std::max(m_LodErrors[i], lods[std::min(i, lods.size() - 1)].Error);
+	}
+
 	MeshCreateInfo meshCreateInfo = {};
 	meshCreateInfo.Device = device;
 	meshCreateInfo.VertexCount = vertices.size();
@@ -88,10 +149,57 @@ void vge::Model::LoadMesh(const Device* device, const aiScene* scene, const aiMe
 	meshCreateInfo.IndexCount = indices.size();
 	meshCreateInfo.Indices = indices.data();
 	meshCreateInfo.TextureId = materialToTextureId[mesh->mMaterialIndex];
+	meshCreateInfo.LodCount = lods.size();
+	meshCreateInfo.Lods = lods.data();
+	meshCreateInfo.MeshletCount = meshlets.size();
+	meshCreateInfo.Meshlets = meshlets.data();
 
 	m_Meshes.emplace_back(Mesh::Create(meshCreateInfo));
 }
 
+vge::u32 vge::Model::SelectLod(const glm::mat4& modelMatrix, const glm::mat4& view, const glm::mat4& projection, f32 viewportHeight, u32 currentLod) const
+{
+	if (GetLodCount() <= 1)
+	{
+		return 0;
+	}
+
+	const glm::vec3 center = (m_BoundsMin + m_BoundsMax) * 0.5f;
+	const f32 maxScale = std::sqrt(std::max(
+		std::max(glm::dot(glm::vec3(modelMatrix[0]), glm::vec3(modelMatrix[0])), glm::dot(glm::vec3(modelMatrix[1]), glm::vec3(modelMatrix[1]))),
+		glm::dot(glm::vec3(modelMatrix[2]), glm::vec3(modelMatrix[2]))));
+	const f32 radius = glm::length(m_BoundsMax - center) * maxScale;
+
+	// Clip space w is view depth for perspective projection and 1 for orthographic one.
+	const glm::vec4 viewCenter = view * modelMatrix * glm::vec4(center, 1.0f);
+	const bool perspective = projection[2][3] != 0.0f;
+	const f32 clipW = glm::dot(glm::vec4(projection[0][3], projection[1][3], projection[2][3], projection[3][3]), viewCenter);
+
+	// Camera is inside of bounds, use the most detailed LOD.
+	if (perspective && clipW <= radius)
+	{
+		return 0;
+	}
+
+	// Distance to the closest point of bounding sphere is used, so errors are not underestimated.
+	const f32 depth = perspective ? clipW - radius : clipW;
+	const f32 errorToPixels = maxScale * std::abs(projection[1][1]) / depth * viewportHeight * 0.5f;
+
+	u32 lod = std::min(currentLod, GetLodCount() - 1);
+
+	while (lod > 0 && m_LodErrors[lod] * errorToPixels > GLodErrorThreshold)
+	{
+		--lod;
+	}
+
+	while (lod + 1 < GetLodCount() && m_LodErrors[lod + 1] * errorToPixels <= GLodErrorThreshold * (1.0f - GLodHysteresis))
+	{
+		++lod;
+	}
+
+	return lod;
+}
+
 void vge::Model::Destroy()
 {
 	for (Mesh& mesh : m_Meshes)
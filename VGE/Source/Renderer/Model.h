@@ -6,6 +6,11 @@ namespace vge
 {
 	class Device;
 
+	// Max screen space error of selected LOD in pixels.
+	inline constexpr f32 GLodErrorThreshold = 1.0f;
+	// Coarser LOD is selected only when its error is this fraction below threshold, so LODs do not flicker on boundary.
+	inline constexpr f32 GLodHysteresis = 0.25f;
+
 	struct ModelCreateInfo
 	{
 		i32 Id = INDEX_NONE;
@@ -27,16 +32,20 @@ namespace vge
 		inline size_t GetMeshCount() const { return m_Meshes.size(); }
 		inline ModelData GetModelData() const { return m_ModelData; }
 		inline const char* GetFilename() const { return m_Filename; }
+		inline u32 GetLodCount() const { return static_cast<u32>(m_LodErrors.size()); }
+		inline f32 GetBoundsRadius() const { return glm::length(m_BoundsMax - m_BoundsMin) * 0.5f; }
 
 		inline const Mesh* GetMesh(size_t index) const { return index < GetMeshCount() ? &m_Meshes[index] : nullptr; }
 		inline 		 Mesh* GetMesh(size_t index)	   { return index < GetMeshCount() ? &m_Meshes[index] : nullptr; }
 
-		inline void SetModelMatrix(const glm::mat4& modelMatrix) { m_ModelData.ModelMatrix = modelMatrix; }
+		// Pick LOD by projected error of bounding sphere center, starting from current LOD of the instance.
+		u32 SelectLod(const glm::mat4& modelMatrix, const glm::mat4& view, const glm::mat4& projection, f32 viewportHeight, u32 currentLod) const;
 
 	private:
 		// Recursively load all meshes starting from a given node as root.
-		void LoadNode(const Device*, const aiScene* scene, const aiNode* node, const std::vector<i32>& materialToTextureId);
-		void LoadMesh(const Device*, const aiScene* scene, const aiMesh* mesh, const std::vector<i32>& materialToTextureId);
+		// Node transforms are accumulated and baked into vertices, so parts of the model keep their placement with single model matrix.
+		void LoadNode(const Device*, const aiScene* scene, const aiNode* node, const glm::mat4& parentTransform, const std::vector<i32>& materialToTextureId);
+		void LoadMesh(const Device*, const aiScene* scene, const aiMesh* mesh, const glm::mat4& transform, const std::vector<i32>& materialToTextureId);
 
 	private:
 		i32 m_Id = INDEX_NONE;
@@ -44,5 +53,8 @@ namespace vge
 		const char* m_Filename = nullptr;
 		const Device* m_Device = nullptr;
 		std::vector<Mesh> m_Meshes = {};
+		glm::vec3 m_BoundsMin = glm::vec3(FLT_MAX);
+		glm::vec3 m_BoundsMax = glm::vec3(-FLT_MAX);
+		std::vector<f32> m_LodErrors = {}; // max error of each LOD level over all meshes
 	};
 }
@@ -60,6 +60,56 @@ void vge::Pipeline::DefaultCreateInfo(PipelineCreateInfo& createInfo)
 	createInfo.DynamicStateInfo.pDynamicStates = createInfo.DynamicStates.data();
 }
 
+bool vge::Pipeline::MergeReflections(const std::vector<const ShaderReflection*>& reflections, PipelineLayoutInfo& outLayoutInfo)
+{
+	outLayoutInfo = {};
+
+	u32 pushConstantsEnd = 0;
+	for (const ShaderReflection* reflection : reflections)
+	{
+		for (const ReflectedBinding& reflected : reflection->Bindings)
+		{
+			if (reflected.Set >= outLayoutInfo.SetBindings.size())
+			{
+				outLayoutInfo.SetBindings.resize(reflected.Set + 1);
+			}
+
+			std::vector<VkDescriptorSetLayoutBinding>& setBindings = outLayoutInfo.SetBindings[reflected.Set];
+			auto it = std::find_if(setBindings.begin(), setBindings.end(), [&reflected](const VkDescriptorSetLayoutBinding& binding)
+			{
+				return binding.binding == reflected.Binding.binding;
+			});
+
+			if (it == setBindings.end())
+			{
+				setBindings.push_back(reflected.Binding);
+				continue;
+			}
+
+			if (it->descriptorType != reflected.Binding.descriptorType || it->descriptorCount != reflected.Binding.descriptorCount)
+			{
+				LOG(Error, "Descriptor binding %u of set %u has different type or count in different shader stages.", reflected.Binding.binding, reflected.Set);
+				return false;
+			}
+
+			it->stageFlags |= reflected.Binding.stageFlags;
+		}
+
+		// Single range covering all stages, so constants can be pushed with the same stage flags everywhere.
+		const VkPushConstantRange& pushConstants = reflection->PushConstants;
+		if (pushConstants.size > 0)
+		{
+			const bool first = outLayoutInfo.PushConstants.size == 0;
+			outLayoutInfo.PushConstants.offset = first ? pushConstants.offset : std::min(outLayoutInfo.PushConstants.offset, pushConstants.offset);
+			outLayoutInfo.PushConstants.stageFlags |= pushConstants.stageFlags;
+			pushConstantsEnd = std::max(pushConstantsEnd, pushConstants.offset + pushConstants.size);
+			outLayoutInfo.PushConstants.size = pushConstantsEnd - outLayoutInfo.PushConstants.offset;
+		}
+	}
+
+	return true;
+}
+
 void vge::Pipeline::Initialize(const PipelineCreateInfo& data)
 {
 	ENSURE(data.Device);
@@ -75,10 +125,9 @@ void vge::Pipeline::Initialize(const PipelineCreateInfo& data)
 	// Initialize pipeline shaders.
 	{
 		const size_t shaderFilenameCount = data.ShaderFilenames.size();
-		const size_t bindingsCount = data.DescriptorSetLayoutBindings.size();
-
 		ENSURE(shaderFilenameCount <= (size_t)ShaderStage::Count);
-		ENSURE(shaderFilenameCount == bindingsCount);
+
+		m_ShaderFilenames.assign(data.ShaderFilenames.begin(), data.ShaderFilenames.end());
 
 		for (size_t i = 0; i < shaderFilenameCount; ++i)
 		{
@@ -88,15 +137,16 @@ void vge::Pipeline::Initialize(const PipelineCreateInfo& data)
 			createInfo.Device = m_Device;
 			createInfo.SpirvChar = &shaderCode;
 			createInfo.StageFlags = Shader::GetFlagsFromStage((ShaderStage)i);
-			createInfo.DescriptorSetLayoutBindings = data.DescriptorSetLayoutBindings[i];
 
 			m_Shaders[i].Initialize(createInfo);
 		}
+
+		UpdateFeatureMask();
 	}
 
-	// Create pipeline layout.
+	// Create pipeline layout from shaders reflection.
 	{
-		std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+		std::vector<const ShaderReflection*> reflections;
 		for (size_t i = 0; i < (size_t)ShaderStage::Count; ++i)
 		{
 			if (!m_Shaders[i].IsValid())
@@ -105,46 +155,204 @@ void vge::Pipeline::Initialize(const PipelineCreateInfo& data)
 				continue;
 			}
 
-			if (m_Shaders[i].GetDescriptorSetLayout().Handle != VK_NULL_HANDLE)
-			{
-				descriptorSetLayouts.push_back(m_Shaders[i].GetDescriptorSetLayout().Handle);
-			}
+			reflections.push_back(&m_Shaders[i].GetReflection());
 		}
 
+		PipelineLayoutInfo layoutInfo = {};
+		const bool merged = MergeReflections(reflections, layoutInfo);
+		ENSURE_MSG(merged, "Pipeline shaders declare conflicting descriptor bindings.");
+
+		GetSetLayouts(layoutInfo, m_SetLayouts);
+		m_PushConstantRange = layoutInfo.PushConstants;
+
 		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
 		pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutCreateInfo.setLayoutCount = static_cast<u32>(descriptorSetLayouts.size());
-		pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
-		pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<u32>(data.PushConstants.size());
-		pipelineLayoutCreateInfo.pPushConstantRanges = data.PushConstants.data();
+		pipelineLayoutCreateInfo.setLayoutCount = static_cast<u32>(m_SetLayouts.size());
+		pipelineLayoutCreateInfo.pSetLayouts = m_SetLayouts.data();
+		pipelineLayoutCreateInfo.pushConstantRangeCount = m_PushConstantRange.size > 0 ? 1 : 0;
+		pipelineLayoutCreateInfo.pPushConstantRanges = &m_PushConstantRange;
 
 		VK_ENSURE(vkCreatePipelineLayout(m_Device->GetHandle(), &pipelineLayoutCreateInfo, nullptr, &m_Layout));
 	}
 
-	// Create pipeline.
+#if DEBUG
+	VerifyVertexInputs(data.VertexInfo);
+#endif
+
+	CreateHandle(data);
+}
+
+void vge::Pipeline::Reload(const PipelineCreateInfo& data)
+{
+	std::vector<std::vector<char>> shaderCodes(m_ShaderFilenames.size());
+	for (size_t i = 0; i < m_ShaderFilenames.size(); ++i)
+	{
+		shaderCodes[i] = file::ReadShader(m_ShaderFilenames[i].c_str());
+		if (shaderCodes[i].empty())
+		{
+			LOG(Error, "Failed to reload shader %s, pipeline is kept as is.", m_ShaderFilenames[i].c_str());
+			return;
+		}
+	}
+
+	// Descriptor sets and push constants are recorded against current layout, so it can not change on the fly.
+	{
+		std::vector<ShaderReflection> reflections(shaderCodes.size());
+		std::vector<const ShaderReflection*> reflectionPtrs;
+		for (size_t i = 0; i < shaderCodes.size(); ++i)
+		{
+			if (!spirv::Reflect(shaderCodes[i], Shader::GetFlagsFromStage((ShaderStage)i), reflections[i]))
+			{
+				LOG(Error, "Failed to reflect reloaded shader %s, pipeline is kept as is.", m_ShaderFilenames[i].c_str());
+				return;
+			}
+
+			reflectionPtrs.push_back(&reflections[i]);
+		}
+
+		PipelineLayoutInfo layoutInfo = {};
+		std::vector<VkDescriptorSetLayout> setLayouts;
+		const bool merged = MergeReflections(reflectionPtrs, layoutInfo);
+		if (merged)
+		{
+			GetSetLayouts(layoutInfo, setLayouts);
+		}
+
+		const VkPushConstantRange& pushConstants = layoutInfo.PushConstants;
+		if (!merged || setLayouts != m_SetLayouts || pushConstants.stageFlags != m_PushConstantRange.stageFlags ||
+			pushConstants.offset != m_PushConstantRange.offset || pushConstants.size != m_PushConstantRange.size)
+		{
+			LOG(Error, "Reloaded shaders of subpass %d changed pipeline layout, restart is required to apply them.", m_SubpassIndex);
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < m_ShaderFilenames.size(); ++i)
 	{
-		std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
-		GetShaderStageInfos(shaderStages);
-
-		VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
-		pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		pipelineCreateInfo.stageCount = static_cast<u32>(shaderStages.size());
-		pipelineCreateInfo.pStages = shaderStages.data();
-		pipelineCreateInfo.pVertexInputState = &data.VertexInfo;
-		pipelineCreateInfo.pInputAssemblyState = &data.InputAssemblyInfo;
-		pipelineCreateInfo.pViewportState = &data.ViewportInfo;
-		pipelineCreateInfo.pDynamicState = &data.DynamicStateInfo;
-		pipelineCreateInfo.pRasterizationState = &data.RasterizationInfo;
-		pipelineCreateInfo.pMultisampleState = &data.MultisampleInfo;
-		pipelineCreateInfo.pColorBlendState = &data.ColorBlendInfo;
-		pipelineCreateInfo.pDepthStencilState = &data.DepthStencilInfo;
-		pipelineCreateInfo.layout = m_Layout;
-		pipelineCreateInfo.renderPass = data.RenderPass->GetHandle();
-		pipelineCreateInfo.subpass = data.SubpassIndex;
-		pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-		pipelineCreateInfo.basePipelineIndex = INDEX_NONE;
-
-		VK_ENSURE(vkCreateGraphicsPipelines(m_Device->GetHandle(), nullptr, 1, &pipelineCreateInfo, nullptr, &m_Handle));
+		m_Shaders[i].ReloadModule(&shaderCodes[i]);
+	}
+
+	UpdateFeatureMask();
+
+	// Cached variants are built from old shaders, so all of them are dropped.
+	DestroyVariants();
+
+	CreateHandle(data);
+}
+
+void vge::Pipeline::SelectVariant(const PipelineCreateInfo& data)
+{
+	const ShaderFeatures features = data.Features & m_FeatureMask;
+	if (auto it = m_Variants.find(features); it != m_Variants.end())
+	{
+		m_Handle = it->second;
+		m_Features = features;
+		return;
+	}
+
+	CreateHandle(data);
+}
+
+bool vge::Pipeline::UsesShader(const char* filename) const
+{
+	return std::find(m_ShaderFilenames.begin(), m_ShaderFilenames.end(), filename) != m_ShaderFilenames.end();
+}
+
+void vge::Pipeline::CreateHandle(const PipelineCreateInfo& data)
+{
+	const ShaderFeatures features = data.Features & m_FeatureMask;
+	const ShaderSpecialization specialization(features);
+
+	std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+	GetShaderStageInfos(specialization.GetInfo(), shaderStages);
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+	pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineCreateInfo.stageCount = static_cast<u32>(shaderStages.size());
+	pipelineCreateInfo.pStages = shaderStages.data();
+	pipelineCreateInfo.pVertexInputState = &data.VertexInfo;
+	pipelineCreateInfo.pInputAssemblyState = &data.InputAssemblyInfo;
+	pipelineCreateInfo.pViewportState = &data.ViewportInfo;
+	pipelineCreateInfo.pDynamicState = &data.DynamicStateInfo;
+	pipelineCreateInfo.pRasterizationState = &data.RasterizationInfo;
+	pipelineCreateInfo.pMultisampleState = &data.MultisampleInfo;
+	pipelineCreateInfo.pColorBlendState = &data.ColorBlendInfo;
+	pipelineCreateInfo.pDepthStencilState = &data.DepthStencilInfo;
+	pipelineCreateInfo.layout = m_Layout;
+	pipelineCreateInfo.renderPass = data.RenderPass->GetHandle();
+	pipelineCreateInfo.subpass = data.SubpassIndex;
+	pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+	pipelineCreateInfo.basePipelineIndex = INDEX_NONE;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	VK_ENSURE(vkCreateGraphicsPipelines(m_Device->GetHandle(), m_Device->GetPipelineCache(), 1, &pipelineCreateInfo, nullptr, &m_Handle));
+
+	const auto endTime = std::chrono::high_resolution_clock::now();
+	const f32 creationTime = std::chrono::duration<f32, std::chrono::milliseconds::period>(endTime - startTime).count();
+	LOG(Log, "Pipeline for subpass %u (features 0x%x) created in %.2fms (%s pipeline cache).", data.SubpassIndex, features, creationTime, m_Device->IsPipelineCacheWarm() ? "warm" : "cold");
+
+	m_Features = features;
+	m_Variants[m_Features] = m_Handle;
+}
+
+void vge::Pipeline::GetSetLayouts(const PipelineLayoutInfo& layoutInfo, std::vector<VkDescriptorSetLayout>& outSetLayouts) const
+{
+	DescriptorLayoutCache* layoutCache = m_Device->GetDescriptorLayoutCache();
+
+	outSetLayouts.clear();
+	for (const std::vector<VkDescriptorSetLayoutBinding>& setBindings : layoutInfo.SetBindings)
+	{
+		outSetLayouts.push_back(layoutCache->Get(setBindings));
+	}
+}
+
+void vge::Pipeline::VerifyVertexInputs(const VkPipelineVertexInputStateCreateInfo& vertexInfo) const
+{
+	const Shader& vertexShader = m_Shaders[(size_t)ShaderStage::Vertex];
+	if (!vertexShader.IsValid())
+	{
+		return;
+	}
+
+	// Attribute formats can be quantized, so only presence of each consumed location is checked.
+	for (const ReflectedVertexInput& input : vertexShader.GetReflection().VertexInputs)
+	{
+		const VkVertexInputAttributeDescription* begin = vertexInfo.pVertexAttributeDescriptions;
+		const VkVertexInputAttributeDescription* end = begin + vertexInfo.vertexAttributeDescriptionCount;
+
+		const bool found = begin && std::any_of(begin, end, [&input](const VkVertexInputAttributeDescription& attribute)
+		{
+			return attribute.location == input.Location;
+		});
+
+		if (!found)
+		{
+			LOG(Error, "Vertex shader of subpass %d reads location %u that is not provided by vertex layout.", m_SubpassIndex, input.Location);
+		}
+	}
+}
+
+void vge::Pipeline::DestroyVariants()
+{
+	for (const auto& [features, handle] : m_Variants)
+	{
+		vkDestroyPipeline(m_Device->GetHandle(), handle, nullptr);
+	}
+
+	m_Variants.clear();
+	m_Handle = VK_NULL_HANDLE;
+}
+
+void vge::Pipeline::UpdateFeatureMask()
+{
+	m_FeatureMask = 0;
+	for (const Shader& shader : m_Shaders)
+	{
+		if (shader.IsValid())
+		{
+			m_FeatureMask |= shader.GetReflection().SpecConstantIds;
+		}
 	}
 }
 
@@ -155,11 +363,11 @@ void vge::Pipeline::Destroy()
 		shader.Destroy();
 	}
 
-	vkDestroyPipeline(m_Device->GetHandle(), m_Handle, nullptr);
+	DestroyVariants();
 	vkDestroyPipelineLayout(m_Device->GetHandle(), m_Layout, nullptr);
 }
 
-void vge::Pipeline::GetShaderStageInfos(std::vector<VkPipelineShaderStageCreateInfo>& outStageInfos)
+void vge::Pipeline::GetShaderStageInfos(const VkSpecializationInfo* specialization, std::vector<VkPipelineShaderStageCreateInfo>& outStageInfos)
 {
 	for (size_t i = 0; i < (size_t)ShaderStage::Count; ++i)
 	{
@@ -169,6 +377,6 @@ void vge::Pipeline::GetShaderStageInfos(std::vector<VkPipelineShaderStageCreateI
 			continue;
 		}
 
-		outStageInfos.push_back(m_Shaders[i].GetStageCreateInfo());
+		outStageInfos.push_back(m_Shaders[i].GetStageCreateInfo(specialization));
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "Shader.h"
+#include "ShaderVariant.h"
 
 namespace vge
 {
@@ -11,13 +12,12 @@ namespace vge
 	struct PipelineCreateInfo
 	{
 		vge::Device* Device = nullptr;
-		std::vector<const char*> ShaderFilenames = {};
-		std::vector<std::vector<VkDescriptorSetLayoutBinding>> DescriptorSetLayoutBindings = {};
+		std::vector<const char*> ShaderFilenames = {}; // descriptor sets and push constants are reflected from them
 		std::vector<VkDynamicState> DynamicStates = {};
-		std::vector<VkPushConstantRange> PushConstants = {};
 		u32 SubpassIndex = 0;
 		vge::RenderPass* RenderPass = nullptr;
 		VkPipelineBindPoint BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		ShaderFeatures Features = 0; // variant key, passed to shaders as specialization constants
 
 		// Can be set by DefaultCreateInfo.
 		VkPipelineViewportStateCreateInfo ViewportInfo = {};
@@ -31,12 +31,22 @@ namespace vge
 		VkPipelineDynamicStateCreateInfo DynamicStateInfo = {};
 	};
 
+	// Pipeline layout description merged from reflection of all pipeline shaders.
+	struct PipelineLayoutInfo
+	{
+		std::vector<std::vector<VkDescriptorSetLayoutBinding>> SetBindings = {}; // indexed by set, unused sets are empty
+		VkPushConstantRange PushConstants = {};
+	};
+
 	class Pipeline
 	{
 	public:
 		// NOTE: If you want to use DynamicStates, ensure they are valid before calling this or update dynamic state info manually.
 		static void DefaultCreateInfo(PipelineCreateInfo& createInfo);
 
+		// Combine bindings of equal set and binding index used by several stages, returns false if they conflict.
+		static bool MergeReflections(const std::vector<const ShaderReflection*>& reflections, PipelineLayoutInfo& outLayoutInfo);
+
 	public:
 		Pipeline() = default;
 
@@ -44,21 +54,45 @@ namespace vge
 		void Initialize(const PipelineCreateInfo& data);
 		void Destroy();
 
+		// Recreate shader modules and pipeline from recompiled shaders, rejected if reflected layout changed.
+		void Reload(const PipelineCreateInfo& data);
+
+		// Switch to variant with features of given create info, variants are created once and cached.
+		// Features not declared by pipeline shaders are ignored, so they do not create duplicate variants.
+		void SelectVariant(const PipelineCreateInfo& data);
+
+		bool UsesShader(const char* filename) const;
+
 		inline VkPipeline GetHandle() const { return m_Handle; }
+		// Features of selected variant, limited to ones declared by shaders.
+		inline ShaderFeatures GetFeatures() const { return m_Features; }
 		inline VkPipelineLayout GetLayout() const { return m_Layout; }
+		inline VkDescriptorSetLayout GetDescriptorSetLayout(u32 set) const { return set < m_SetLayouts.size() ? m_SetLayouts[set] : VK_NULL_HANDLE; }
+		inline const VkPushConstantRange& GetPushConstantRange() const { return m_PushConstantRange; }
 		inline const Shader* GetShader(ShaderStage stage) const { return &m_Shaders[(size_t)stage]; }
 		inline VkPipelineBindPoint GetBindPoint() const { return m_BindPoint; }
 
 	private:
-		void GetShaderStageInfos(std::vector<VkPipelineShaderStageCreateInfo>& outStageInfos);
+		void CreateHandle(const PipelineCreateInfo& data);
+		void GetSetLayouts(const PipelineLayoutInfo& layoutInfo, std::vector<VkDescriptorSetLayout>& outSetLayouts) const;
+		void VerifyVertexInputs(const VkPipelineVertexInputStateCreateInfo& vertexInfo) const;
+		void DestroyVariants();
+		void UpdateFeatureMask();
+		void GetShaderStageInfos(const VkSpecializationInfo* specialization, std::vector<VkPipelineShaderStageCreateInfo>& outStageInfos);
 
 	private:
 		Device* m_Device = nullptr;
 		RenderPass* m_RenderPass = nullptr;
-		VkPipeline m_Handle = VK_NULL_HANDLE;
+		VkPipeline m_Handle = VK_NULL_HANDLE; // currently selected variant
+		ShaderFeatures m_Features = 0;
+		ShaderFeatures m_FeatureMask = 0; // features declared by shaders as specialization constants
+		std::unordered_map<ShaderFeatures, VkPipeline> m_Variants = {};
 		VkPipelineLayout m_Layout = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSetLayout> m_SetLayouts = {}; // owned by device descriptor layout cache
+		VkPushConstantRange m_PushConstantRange = {};
 		i32 m_SubpassIndex = INDEX_NONE;
 		Shader m_Shaders[(size_t)ShaderStage::Count];
+		std::vector<std::string> m_ShaderFilenames = {};
 		VkPipelineBindPoint m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 	};
 }
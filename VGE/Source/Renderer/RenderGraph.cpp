@@ -0,0 +1,660 @@
+#include "RenderGraph.h"
+#include "Device.h"
+
+namespace vge
+{
+	namespace
+	{
+		struct AccessInfo
+		{
+			VkPipelineStageFlags Stages = 0;
+			VkAccessFlags Access = 0;		// all accesses made by stages
+			VkAccessFlags WriteAccess = 0;	// accesses which must be made available for next users
+			VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageUsageFlags Usage = 0;
+		};
+
+		AccessInfo GetAccessInfo(RenderGraphAccess access)
+		{
+			AccessInfo info = {};
+
+			switch (access)
+			{
+			case RenderGraphAccess::ColorWrite:
+				info.Stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				info.Access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				info.WriteAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				info.Layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+				info.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+				break;
+
+			case RenderGraphAccess::DepthWrite:
+				info.Stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+				info.Access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+				info.WriteAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+				info.Layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+				info.Usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+				break;
+
+			case RenderGraphAccess::InputRead:
+				info.Stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				info.Access = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+				info.WriteAccess = 0;
+				info.Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				info.Usage = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+				break;
+			}
+
+			return info;
+		}
+
+		bool SupportsLazilyAllocatedMemory(VmaAllocator allocator)
+		{
+			const VkPhysicalDeviceMemoryProperties* memProperties = nullptr;
+			vmaGetMemoryProperties(allocator, &memProperties);
+
+			for (u32 typeIdx = 0; typeIdx < memProperties->memoryTypeCount; ++typeIdx)
+			{
+				if (memProperties->memoryTypes[typeIdx].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		inline bool IsWrite(RenderGraphAccess access)
+		{
+			return access != RenderGraphAccess::InputRead;
+		}
+
+		// Dependencies between the same subpasses are merged, so render pass has at most one per pair.
+		void AddDependency(std::vector<VkSubpassDependency>& dependencies, u32 srcSubpass, u32 dstSubpass, const AccessInfo& src, const AccessInfo& dst, VkDependencyFlags flags)
+		{
+			for (VkSubpassDependency& dependency : dependencies)
+			{
+				if (dependency.srcSubpass == srcSubpass && dependency.dstSubpass == dstSubpass)
+				{
+					dependency.srcStageMask |= src.Stages;
+					dependency.srcAccessMask |= src.WriteAccess;
+					dependency.dstStageMask |= dst.Stages;
+					dependency.dstAccessMask |= dst.Access;
+					dependency.dependencyFlags &= flags;
+					return;
+				}
+			}
+
+			VkSubpassDependency dependency = {};
+			dependency.srcSubpass = srcSubpass;
+			dependency.srcStageMask = src.Stages;
+			dependency.srcAccessMask = src.WriteAccess;	// reads do not need to be made available, execution dependency is enough
+			dependency.dstSubpass = dstSubpass;
+			dependency.dstStageMask = dst.Stages;
+			dependency.dstAccessMask = dst.Access;
+			dependency.dependencyFlags = flags;
+
+			dependencies.push_back(dependency);
+		}
+
+		void DestroyAttachments(VkDevice device, VmaAllocator allocator, std::vector<std::vector<RenderPassAttachment>>& attachments, const std::vector<VmaAllocation>& aliasAllocations)
+		{
+			for (std::vector<RenderPassAttachment>& instanceAttachments : attachments)
+			{
+				for (RenderPassAttachment& attachment : instanceAttachments)
+				{
+					if (attachment.View)
+					{
+						vkDestroyImageView(device, attachment.View, nullptr);
+						attachment.Image.Destroy();
+					}
+				}
+			}
+
+			for (VmaAllocation allocation : aliasAllocations)
+			{
+				vmaFreeMemory(allocator, allocation);
+			}
+		}
+	}
+}
+
+void vge::RenderGraph::Initialize(const Device* device)
+{
+	m_Device = device;
+}
+
+void vge::RenderGraph::Destroy()
+{
+	DestroyImages();
+	m_RenderPass.Destroy();
+
+	m_Images.clear();
+	m_Passes.clear();
+	m_Output = INDEX_NONE;
+}
+
+vge::RenderGraphHandle vge::RenderGraph::CreateImage(const char* name, VkFormat format, const VkClearValue& clearValue)
+{
+	RenderGraphImage image = {};
+	image.Name = name;
+	image.Format = format;
+	image.ClearValue = clearValue;
+
+	m_Images.push_back(image);
+	return static_cast<RenderGraphHandle>(m_Images.size() - 1);
+}
+
+vge::RenderGraphHandle vge::RenderGraph::ImportImage(const char* name, VkFormat format, const VkClearValue& clearValue, VkImageLayout finalLayout)
+{
+	ENSURE_MSG(std::none_of(m_Images.begin(), m_Images.end(), [](const RenderGraphImage& image) { return image.Imported; }), "Render graph supports only one imported image.");
+
+	const RenderGraphHandle handle = CreateImage(name, format, clearValue);
+	m_Images[handle].Imported = true;
+	m_Images[handle].FinalLayout = finalLayout;
+
+	return handle;
+}
+
+vge::RenderGraphHandle vge::RenderGraph::AddPass(const char* name)
+{
+	RenderGraphPass pass = {};
+	pass.Name = name;
+
+	m_Passes.push_back(pass);
+	return static_cast<RenderGraphHandle>(m_Passes.size() - 1);
+}
+
+void vge::RenderGraph::WriteColor(RenderGraphHandle pass, RenderGraphHandle image)
+{
+	ENSURE(pass < m_Passes.size() && image < m_Images.size());
+	m_Passes[pass].Accesses.push_back({ image, RenderGraphAccess::ColorWrite });
+}
+
+void vge::RenderGraph::WriteDepth(RenderGraphHandle pass, RenderGraphHandle image)
+{
+	ENSURE(pass < m_Passes.size() && image < m_Images.size());
+	m_Passes[pass].Accesses.push_back({ image, RenderGraphAccess::DepthWrite });
+}
+
+void vge::RenderGraph::ReadInput(RenderGraphHandle pass, RenderGraphHandle image)
+{
+	ENSURE(pass < m_Passes.size() && image < m_Images.size());
+	m_Passes[pass].Accesses.push_back({ image, RenderGraphAccess::InputRead });
+}
+
+void vge::RenderGraph::SetOutput(RenderGraphHandle image)
+{
+	ENSURE(image < m_Images.size());
+	m_Output = image;
+}
+
+void vge::RenderGraph::Compile()
+{
+	ENSURE_MSG(m_Output != INDEX_NONE, "Render graph output is not set.");
+
+	CullPasses();
+	AssignAttachments();
+	AssignAliasSlots();
+	CreateRenderPass();
+}
+
+void vge::RenderGraph::CullPasses()
+{
+	// Walk passes backwards from output, pass is alive if it writes image needed by alive passes after it.
+	std::vector<bool> neededImages(m_Images.size(), false);
+	neededImages[m_Output] = true;
+
+	std::vector<bool> alivePasses(m_Passes.size(), false);
+
+	for (i32 passIdx = static_cast<i32>(m_Passes.size()) - 1; passIdx >= 0; --passIdx)
+	{
+		const RenderGraphPass& pass = m_Passes[passIdx];
+
+		alivePasses[passIdx] = std::any_of(pass.Accesses.begin(), pass.Accesses.end(), [&neededImages](const RenderGraphPassAccess& access)
+		{
+			return IsWrite(access.Access) && neededImages[access.Image];
+		});
+
+		if (alivePasses[passIdx])
+		{
+			// Written images are needed too, as their content is loaded from previous writers.
+			for (const RenderGraphPassAccess& access : pass.Accesses)
+			{
+				neededImages[access.Image] = true;
+			}
+		}
+	}
+
+	i32 subpassIdx = 0;
+	for (size_t passIdx = 0; passIdx < m_Passes.size(); ++passIdx)
+	{
+		RenderGraphPass& pass = m_Passes[passIdx];
+
+		if (alivePasses[passIdx])
+		{
+			pass.SubpassIndex = subpassIdx++;
+		}
+		else
+		{
+			pass.SubpassIndex = INDEX_NONE;
+			LOG(Log, "Render graph pass \"%s\" is culled, its outputs are not used.", pass.Name.c_str());
+		}
+	}
+}
+
+void vge::RenderGraph::AssignAttachments()
+{
+	for (RenderGraphImage& image : m_Images)
+	{
+		image.Usage = 0;
+		image.AttachmentIndex = INDEX_NONE;
+		image.FirstSubpass = INDEX_NONE;
+		image.LastSubpass = INDEX_NONE;
+	}
+
+	for (const RenderGraphPass& pass : m_Passes)
+	{
+		if (pass.SubpassIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		for (const RenderGraphPassAccess& access : pass.Accesses)
+		{
+			RenderGraphImage& image = m_Images[access.Image];
+			image.Usage |= GetAccessInfo(access.Access).Usage;
+
+			// Content of owned images is not stored, so they can live in tile memory only.
+			if (!image.Imported)
+			{
+				image.Usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			}
+
+			if (image.FirstSubpass == INDEX_NONE)
+			{
+				image.FirstSubpass = pass.SubpassIndex;
+				image.FirstAccess = access.Access;
+			}
+
+			image.LastSubpass = pass.SubpassIndex;
+			image.LastAccess = access.Access;
+		}
+	}
+
+	// Attachments keep image declaration order.
+	i32 attachmentIdx = 0;
+	for (RenderGraphImage& image : m_Images)
+	{
+		if (image.FirstSubpass != INDEX_NONE)
+		{
+			image.AttachmentIndex = attachmentIdx++;
+		}
+	}
+}
+
+void vge::RenderGraph::AssignAliasSlots()
+{
+	std::vector<RenderGraphHandle> ownedImages;
+	for (size_t imageIdx = 0; imageIdx < m_Images.size(); ++imageIdx)
+	{
+		RenderGraphImage& image = m_Images[imageIdx];
+		image.AliasSlot = INDEX_NONE;
+		image.AliasedAfter = INDEX_NONE;
+
+		if (!image.Imported && image.AttachmentIndex != INDEX_NONE)
+		{
+			ownedImages.push_back(static_cast<RenderGraphHandle>(imageIdx));
+		}
+	}
+
+	std::stable_sort(ownedImages.begin(), ownedImages.end(), [this](RenderGraphHandle a, RenderGraphHandle b)
+	{
+		return m_Images[a].FirstSubpass < m_Images[b].FirstSubpass;
+	});
+
+	// Greedy interval packing, image takes memory of image whose last use is before its first one.
+	m_AliasSlotLastImages.clear();
+
+	for (RenderGraphHandle handle : ownedImages)
+	{
+		RenderGraphImage& image = m_Images[handle];
+
+		for (size_t slot = 0; slot < m_AliasSlotLastImages.size(); ++slot)
+		{
+			const RenderGraphHandle lastImage = m_AliasSlotLastImages[slot];
+			if (m_Images[lastImage].LastSubpass < image.FirstSubpass)
+			{
+				image.AliasSlot = static_cast<i32>(slot);
+				image.AliasedAfter = lastImage;
+				m_AliasSlotLastImages[slot] = handle;
+				break;
+			}
+		}
+
+		if (image.AliasSlot == INDEX_NONE)
+		{
+			image.AliasSlot = static_cast<i32>(m_AliasSlotLastImages.size());
+			m_AliasSlotLastImages.push_back(handle);
+		}
+	}
+
+	const size_t aliasedCount = std::count_if(m_Images.begin(), m_Images.end(), [](const RenderGraphImage& image) { return image.AliasedAfter != INDEX_NONE; });
+	LOG(Log, "Render graph compiled: %u subpasses, %zu owned images in %zu memory slots, %zu aliased.",
+		static_cast<u32>(std::count_if(m_Passes.begin(), m_Passes.end(), [](const RenderGraphPass& pass) { return pass.SubpassIndex != INDEX_NONE; })),
+		ownedImages.size(), m_AliasSlotLastImages.size(), aliasedCount);
+}
+
+void vge::RenderGraph::CreateRenderPass()
+{
+	struct SubpassReferences
+	{
+		std::vector<VkAttachmentReference> Colors = {};
+		std::vector<VkAttachmentReference> Inputs = {};
+		std::vector<u32> Preserves = {};
+		VkAttachmentReference Depth = {};
+		bool HasDepth = false;
+	};
+
+	const u32 subpassCount = static_cast<u32>(std::count_if(m_Passes.begin(), m_Passes.end(), [](const RenderGraphPass& pass) { return pass.SubpassIndex != INDEX_NONE; }));
+	ENSURE_MSG(subpassCount > 0, "Render graph has no passes writing to output.");
+
+	std::vector<SubpassReferences> references(subpassCount);
+	std::vector<VkSubpassDependency> dependencies;
+	std::vector<i32> lastSubpasses(m_Images.size(), INDEX_NONE);
+	std::vector<RenderGraphAccess> lastAccesses(m_Images.size(), RenderGraphAccess::ColorWrite);
+
+	for (const RenderGraphPass& pass : m_Passes)
+	{
+		if (pass.SubpassIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const u32 subpassIdx = static_cast<u32>(pass.SubpassIndex);
+		SubpassReferences& subpassRefs = references[subpassIdx];
+
+		for (const RenderGraphPassAccess& access : pass.Accesses)
+		{
+			const RenderGraphImage& image = m_Images[access.Image];
+			const AccessInfo info = GetAccessInfo(access.Access);
+
+			VkAttachmentReference reference = {};
+			reference.attachment = static_cast<u32>(image.AttachmentIndex);
+			reference.layout = info.Layout;
+
+			switch (access.Access)
+			{
+			case RenderGraphAccess::ColorWrite:
+				subpassRefs.Colors.push_back(reference);
+				break;
+
+			case RenderGraphAccess::DepthWrite:
+				ENSURE_MSG(!subpassRefs.HasDepth, "Render graph pass can write only one depth image.");
+				subpassRefs.Depth = reference;
+				subpassRefs.HasDepth = true;
+				break;
+
+			case RenderGraphAccess::InputRead:
+				subpassRefs.Inputs.push_back(reference);
+				break;
+			}
+
+			const i32 prevSubpassIdx = lastSubpasses[access.Image];
+
+			if (prevSubpassIdx == INDEX_NONE)
+			{
+				if (image.AliasedAfter != INDEX_NONE)
+				{
+					// Memory was used by other image earlier in this render pass.
+					const RenderGraphImage& prevImage = m_Images[image.AliasedAfter];
+					AddDependency(dependencies, static_cast<u32>(prevImage.LastSubpass), subpassIdx, GetAccessInfo(prevImage.LastAccess), info, 0);
+				}
+				else if (image.Imported)
+				{
+					// Image is acquired with semaphore waited at the same stages, only layout transition must be ordered.
+					AccessInfo externalInfo = {};
+					externalInfo.Stages = info.Stages;
+					AddDependency(dependencies, VK_SUBPASS_EXTERNAL, subpassIdx, externalInfo, info, 0);
+				}
+				else
+				{
+					// Memory was last used by previous frame rendered to the same instance.
+					const RenderGraphImage& memoryLastImage = m_Images[m_AliasSlotLastImages[image.AliasSlot]];
+					AddDependency(dependencies, VK_SUBPASS_EXTERNAL, subpassIdx, GetAccessInfo(memoryLastImage.LastAccess), info, 0);
+				}
+			}
+			else if (prevSubpassIdx != pass.SubpassIndex && (IsWrite(lastAccesses[access.Image]) || IsWrite(access.Access)))
+			{
+				// Attachments are accessed only at the same pixel, so dependency can be framebuffer local.
+				AddDependency(dependencies, static_cast<u32>(prevSubpassIdx), subpassIdx, GetAccessInfo(lastAccesses[access.Image]), info, VK_DEPENDENCY_BY_REGION_BIT);
+			}
+
+			lastSubpasses[access.Image] = pass.SubpassIndex;
+			lastAccesses[access.Image] = access.Access;
+		}
+	}
+
+	std::vector<VkAttachmentDescription> attachments;
+	std::vector<VkClearValue> clearValues;
+
+	for (size_t imageIdx = 0; imageIdx < m_Images.size(); ++imageIdx)
+	{
+		const RenderGraphImage& image = m_Images[imageIdx];
+		if (image.AttachmentIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		ENSURE_MSG(IsWrite(image.FirstAccess), "Render graph image is read before any pass writes it.");
+
+		// Only owned images get memory slot, so slot is shared if image is not the last one in it or follows other one.
+		const bool aliased = !image.Imported && (image.AliasedAfter != INDEX_NONE || m_AliasSlotLastImages[image.AliasSlot] != static_cast<RenderGraphHandle>(imageIdx));
+
+		VkAttachmentDescription attachment = {};
+		attachment.flags = aliased ? VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT : 0;
+		attachment.format = image.Format;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		// Graph owned images live only within render pass, only imported ones are used after it.
+		attachment.storeOp = image.Imported ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment.finalLayout = image.Imported ? image.FinalLayout : GetAccessInfo(image.LastAccess).Layout;
+
+		attachments.push_back(attachment);
+		clearValues.push_back(image.ClearValue);
+
+		// Keep content in subpasses between first and last use which do not reference image.
+		for (i32 subpassIdx = image.FirstSubpass + 1; subpassIdx < image.LastSubpass; ++subpassIdx)
+		{
+			const RenderGraphHandle passHandle = GetSubpassPass(static_cast<u32>(subpassIdx));
+			const std::vector<RenderGraphPassAccess>& accesses = m_Passes[passHandle].Accesses;
+			const bool referenced = std::any_of(accesses.begin(), accesses.end(), [imageIdx](const RenderGraphPassAccess& access)
+			{
+				return access.Image == static_cast<RenderGraphHandle>(imageIdx);
+			});
+
+			if (!referenced)
+			{
+				references[subpassIdx].Preserves.push_back(static_cast<u32>(image.AttachmentIndex));
+			}
+		}
+
+		if (image.Imported)
+		{
+			AddDependency(dependencies, static_cast<u32>(image.LastSubpass), VK_SUBPASS_EXTERNAL, GetAccessInfo(image.LastAccess), { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT }, 0);
+		}
+	}
+
+	std::vector<VkSubpassDescription> subpasses(subpassCount);
+	for (u32 subpassIdx = 0; subpassIdx < subpassCount; ++subpassIdx)
+	{
+		const SubpassReferences& subpassRefs = references[subpassIdx];
+		VkSubpassDescription& subpass = subpasses[subpassIdx];
+
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = static_cast<u32>(subpassRefs.Colors.size());
+		subpass.pColorAttachments = subpassRefs.Colors.data();
+		subpass.pDepthStencilAttachment = subpassRefs.HasDepth ? &subpassRefs.Depth : nullptr;
+		subpass.inputAttachmentCount = static_cast<u32>(subpassRefs.Inputs.size());
+		subpass.pInputAttachments = subpassRefs.Inputs.data();
+		subpass.preserveAttachmentCount = static_cast<u32>(subpassRefs.Preserves.size());
+		subpass.pPreserveAttachments = subpassRefs.Preserves.data();
+	}
+
+	RenderPassCreateInfo createInfo = {};
+	createInfo.Device = m_Device;
+	createInfo.SubpassCount = subpassCount;
+	createInfo.Subpasses = &subpasses;
+	createInfo.Dependencies = &dependencies;
+	createInfo.Attachments = &attachments;
+	createInfo.ClearValues = &clearValues;
+
+	m_RenderPass.Initialize(createInfo);
+}
+
+void vge::RenderGraph::CreateImages(VkExtent2D extent, u32 instanceCount)
+{
+	m_LazilyAllocated = SupportsLazilyAllocatedMemory(m_Device->GetAllocator());
+	const VmaMemoryUsage memUsage = m_LazilyAllocated ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED : VMA_MEMORY_USAGE_GPU_ONLY;
+
+	m_ImageMemorySize = 0;
+	m_Attachments.resize(instanceCount);
+
+	for (std::vector<RenderPassAttachment>& attachments : m_Attachments)
+	{
+		attachments.resize(m_Images.size());
+
+		for (size_t slot = 0; slot < m_AliasSlotLastImages.size(); ++slot)
+		{
+			std::vector<RenderGraphHandle> slotImages;
+			for (size_t imageIdx = 0; imageIdx < m_Images.size(); ++imageIdx)
+			{
+				if (m_Images[imageIdx].AliasSlot == static_cast<i32>(slot))
+				{
+					slotImages.push_back(static_cast<RenderGraphHandle>(imageIdx));
+				}
+			}
+
+			for (RenderGraphHandle handle : slotImages)
+			{
+				const RenderGraphImage& image = m_Images[handle];
+
+				ImageCreateInfo imageCreateInfo = {};
+				imageCreateInfo.Device = m_Device;
+				imageCreateInfo.Extent = extent;
+				imageCreateInfo.Format = image.Format;
+				imageCreateInfo.Tiling = VK_IMAGE_TILING_OPTIMAL;
+				imageCreateInfo.Usage = image.Usage;
+				imageCreateInfo.MemAllocUsage = memUsage;
+
+				attachments[handle].Image = slotImages.size() > 1 ? Image::CreateUnbound(imageCreateInfo) : Image::Create(imageCreateInfo);
+			}
+
+			if (slotImages.size() == 1)
+			{
+				m_ImageMemorySize += attachments[slotImages[0]].Image.GetMemoryRequirements().size;
+			}
+
+			if (slotImages.size() > 1)
+			{
+				// Single allocation satisfying requirements of all images in slot.
+				VkMemoryRequirements memRequirements = {};
+				memRequirements.memoryTypeBits = ~0u;
+
+				for (RenderGraphHandle handle : slotImages)
+				{
+					const VkMemoryRequirements imageMemRequirements = attachments[handle].Image.GetMemoryRequirements();
+					memRequirements.size = std::max(memRequirements.size, imageMemRequirements.size);
+					memRequirements.alignment = std::max(memRequirements.alignment, imageMemRequirements.alignment);
+					memRequirements.memoryTypeBits &= imageMemRequirements.memoryTypeBits;
+				}
+
+				ENSURE_MSG(memRequirements.memoryTypeBits != 0, "Aliased render graph images have no common memory type.");
+
+				VmaAllocationCreateInfo vmaAllocCreateInfo = {};
+				vmaAllocCreateInfo.usage = memUsage;
+
+				VmaAllocation allocation = VK_NULL_HANDLE;
+				VK_ENSURE(vmaAllocateMemory(m_Device->GetAllocator(), &memRequirements, &vmaAllocCreateInfo, &allocation, nullptr));
+				m_AliasAllocations.push_back(allocation);
+				m_ImageMemorySize += memRequirements.size;
+
+				for (RenderGraphHandle handle : slotImages)
+				{
+					attachments[handle].Image.BindMemory(allocation);
+				}
+			}
+
+			for (RenderGraphHandle handle : slotImages)
+			{
+				const RenderGraphImage& image = m_Images[handle];
+
+				ImageViewCreateInfo viewCreateInfo = {};
+				viewCreateInfo.Device = m_Device;
+				viewCreateInfo.Image = attachments[handle].Image.GetHandle();
+				viewCreateInfo.Format = image.Format;
+				viewCreateInfo.AspectFlags = (image.Usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+
+				attachments[handle].View = Image::CreateView(viewCreateInfo);
+			}
+		}
+	}
+}
+
+void vge::RenderGraph::DestroyImages(DeletionQueue* deletionQueue /*= nullptr*/)
+{
+	if (deletionQueue)
+	{
+		// Images may be still used by frames in flight, so they are destroyed with their memory once frames retire.
+		deletionQueue->Push([device = m_Device->GetHandle(), allocator = m_Device->GetAllocator(), attachments = std::move(m_Attachments), aliasAllocations = std::move(m_AliasAllocations)]() mutable
+		{
+			DestroyAttachments(device, allocator, attachments, aliasAllocations);
+		});
+	}
+	else
+	{
+		DestroyAttachments(m_Device->GetHandle(), m_Device->GetAllocator(), m_Attachments, m_AliasAllocations);
+	}
+
+	m_Attachments.clear();
+	m_AliasAllocations.clear();
+	m_ImageMemorySize = 0;
+}
+
+void vge::RenderGraph::GetAttachmentViews(u32 instance, VkImageView importedView, std::vector<VkImageView>& outViews) const
+{
+	ENSURE(instance < m_Attachments.size());
+
+	outViews.resize(m_RenderPass.GeAttachmentCount());
+
+	for (size_t imageIdx = 0; imageIdx < m_Images.size(); ++imageIdx)
+	{
+		const RenderGraphImage& image = m_Images[imageIdx];
+		if (image.AttachmentIndex != INDEX_NONE)
+		{
+			outViews[image.AttachmentIndex] = image.Imported ? importedView : m_Attachments[instance][imageIdx].View;
+		}
+	}
+}
+
+VkImageView vge::RenderGraph::GetView(RenderGraphHandle image, u32 instance) const
+{
+	ENSURE(instance < m_Attachments.size() && !m_Images[image].Imported);
+	return m_Attachments[instance][image].View;
+}
+
+vge::RenderGraphHandle vge::RenderGraph::GetSubpassPass(u32 subpassIdx) const
+{
+	for (size_t passIdx = 0; passIdx < m_Passes.size(); ++passIdx)
+	{
+		if (m_Passes[passIdx].SubpassIndex == static_cast<i32>(subpassIdx))
+		{
+			return static_cast<RenderGraphHandle>(passIdx);
+		}
+	}
+
+	return INDEX_NONE;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+#include "RenderPass.h"
+#include "DeletionQueue.h"
+
+namespace vge
+{
+	class Device;
+
+	// Index of image or pass in render graph.
+	using RenderGraphHandle = i32;
+
+	enum class RenderGraphAccess : u8
+	{
+		ColorWrite,
+		DepthWrite,
+		InputRead,
+	};
+
+	struct RenderGraphImage
+	{
+		std::string Name = {};
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		VkClearValue ClearValue = {};
+		bool Imported = false;								// owned outside of graph, e.g. swapchain image
+		VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// Filled on compile.
+		VkImageUsageFlags Usage = 0;
+		i32 AttachmentIndex = INDEX_NONE;					// INDEX_NONE if no alive pass uses image
+		i32 FirstSubpass = INDEX_NONE;
+		i32 LastSubpass = INDEX_NONE;
+		RenderGraphAccess FirstAccess = RenderGraphAccess::ColorWrite;
+		RenderGraphAccess LastAccess = RenderGraphAccess::ColorWrite;
+		i32 AliasSlot = INDEX_NONE;							// graph owned images with the same slot share memory
+		RenderGraphHandle AliasedAfter = INDEX_NONE;		// image which used the same memory before
+	};
+
+	struct RenderGraphPassAccess
+	{
+		RenderGraphHandle Image = INDEX_NONE;
+		RenderGraphAccess Access = RenderGraphAccess::ColorWrite;
+	};
+
+	struct RenderGraphPass
+	{
+		std::string Name = {};
+		std::vector<RenderGraphPassAccess> Accesses = {};	// attachment references keep declaration order
+		i32 SubpassIndex = INDEX_NONE;						// INDEX_NONE if pass was culled
+	};
+
+	// Frame described as passes declaring which images they read and write.
+	// On compile passes not contributing to output are culled and the rest become subpasses of single render pass,
+	// attachment load/store ops, layouts and subpass dependencies are derived from declared accesses.
+	class RenderGraph
+	{
+	public:
+		RenderGraph() = default;
+		NOT_COPYABLE(RenderGraph);
+
+		void Initialize(const Device* device);
+		void Destroy();
+
+		RenderGraphHandle CreateImage(const char* name, VkFormat format, const VkClearValue& clearValue);
+		// Only one image can be imported, its view is given when framebuffer attachments are gathered.
+		RenderGraphHandle ImportImage(const char* name, VkFormat format, const VkClearValue& clearValue, VkImageLayout finalLayout);
+		RenderGraphHandle AddPass(const char* name);
+
+		// Color and depth written by pass are loaded if previous alive pass wrote them, cleared otherwise.
+		void WriteColor(RenderGraphHandle pass, RenderGraphHandle image);
+		void WriteDepth(RenderGraphHandle pass, RenderGraphHandle image);
+		void ReadInput(RenderGraphHandle pass, RenderGraphHandle image);
+		// Passes which do not contribute to output image are culled.
+		void SetOutput(RenderGraphHandle image);
+
+		void Compile();
+
+		// Create graph owned images, one copy per instance. Images with disjoint subpass ranges share memory.
+		// Owned images never leave render pass, so they are transient and lazily allocated where device supports it.
+		void CreateImages(VkExtent2D extent, u32 instanceCount);
+		// Destroy right away or once frames which could use images retire, graph can create new images right after that.
+		void DestroyImages(DeletionQueue* deletionQueue = nullptr);
+
+		// Views in attachment order, imported image is replaced by given view.
+		void GetAttachmentViews(u32 instance, VkImageView importedView, std::vector<VkImageView>& outViews) const;
+		VkImageView GetView(RenderGraphHandle image, u32 instance) const;
+		// Pass compiled to given subpass or INDEX_NONE.
+		RenderGraphHandle GetSubpassPass(u32 subpassIdx) const;
+
+		inline const RenderPass* GetRenderPass() const { return &m_RenderPass; }
+		inline u32 GetSubpassCount() const { return m_RenderPass.GeSubpassCount(); }
+		inline i32 GetSubpassIndex(RenderGraphHandle pass) const { return m_Passes[pass].SubpassIndex; }
+		inline const RenderGraphImage& GetImage(RenderGraphHandle image) const { return m_Images[image]; }
+		// Memory requested for owned images of all instances, lazily allocated memory may be not backed at all.
+		inline VkDeviceSize GetImageMemorySize() const { return m_ImageMemorySize; }
+		inline bool IsImageMemoryLazilyAllocated() const { return m_LazilyAllocated; }
+
+	private:
+		void CullPasses();
+		void AssignAttachments();
+		void AssignAliasSlots();
+		void CreateRenderPass();
+
+	private:
+		const Device* m_Device = nullptr;
+		std::vector<RenderGraphImage> m_Images = {};
+		std::vector<RenderGraphPass> m_Passes = {};
+		RenderGraphHandle m_Output = INDEX_NONE;
+		RenderPass m_RenderPass = {};
+		std::vector<RenderGraphHandle> m_AliasSlotLastImages = {};			// last image using memory of each slot
+
+		std::vector<std::vector<RenderPassAttachment>> m_Attachments = {};	// graph owned images per instance
+		std::vector<VmaAllocation> m_AliasAllocations = {};					// memory shared by aliased images
+		VkDeviceSize m_ImageMemorySize = 0;
+		bool m_LazilyAllocated = false;
+	};
+}
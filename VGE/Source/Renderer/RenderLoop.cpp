@@ -21,12 +21,33 @@ void vge::RenderLoop::Initialize()
 
 	RegisterDefaultComponents();
 	RegisterRenderSystem();
+
+#if SHADER_HOT_RELOAD
+	m_ShaderHotReload.Initialize();
+#endif
 }
 
 void vge::RenderLoop::Tick(f32 deltaTime)
 {
 	//GCamera->SetPerspectiveProjection(glm::radians(45.0f), GRenderer->GetSwapchainAspectRatio(), 0.001f, 100000.0f);
 	m_RenderSystem->Tick(deltaTime);
+	PollShaderFeatureKeys();
+
+#if SHADER_HOT_RELOAD
+	m_ShaderHotReloadTimer += deltaTime;
+	if (m_ShaderHotReloadTimer >= GShaderHotReloadInterval)
+	{
+		m_ShaderHotReloadTimer = 0.0f;
+
+		std::vector<const char*> recompiledShaders;
+		m_ShaderHotReload.Poll(recompiledShaders);
+
+		if (!recompiledShaders.empty())
+		{
+			GRenderer->ReloadPipelines(recompiledShaders);
+		}
+	}
+#endif
 }
 
 void vge::RenderLoop::Destroy()
@@ -35,6 +56,21 @@ void vge::RenderLoop::Destroy()
 	DestroyDevice();
 }
 
+void vge::RenderLoop::PollShaderFeatureKeys()
+{
+	// F1 - DepthViz, F2 - AlphaTest and so on in order of features.
+	for (u32 i = 0; i < static_cast<u32>(ShaderFeature::Count); ++i)
+	{
+		const bool down = GWindow->IsKeyPressed(GLFW_KEY_F1 + static_cast<i32>(i));
+		if (down && !m_ShaderFeatureKeysDown[i])
+		{
+			GRenderer->ToggleShaderFeature(static_cast<ShaderFeature>(i));
+		}
+
+		m_ShaderFeatureKeysDown[i] = down;
+	}
+}
+
 void vge::RenderLoop::RegisterDefaultComponents() const
 {
 	GCoordinator->RegisterComponent<RenderComponent>();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ECS/RenderSystem.h"
+#include "ShaderCompiler.h"
+#include "ShaderVariant.h"
 
 namespace vge
 {
@@ -19,7 +21,16 @@ namespace vge
 		void RegisterDefaultComponents() const;
 		void RegisterRenderSystem();
 
+		// Debug keys toggling shader features, feature is switched on key press only.
+		void PollShaderFeatureKeys();
+
 	private:
 		std::shared_ptr<RenderSystem> m_RenderSystem = nullptr;
+		std::array<bool, static_cast<size_t>(ShaderFeature::Count)> m_ShaderFeatureKeysDown = {};
+
+#if SHADER_HOT_RELOAD
+		ShaderHotReload m_ShaderHotReload = {};
+		f32 m_ShaderHotReloadTimer = 0.0f;
+#endif
 	};
 }
@@ -6,7 +6,6 @@
 void vge::RenderPass::Initialize(const RenderPassCreateInfo& data)
 {
 	ENSURE(data.SubpassCount == data.Subpasses->size());
-	ENSURE(data.SubpassCount == data.Dependencies->size() - 1);
 	ENSURE(data.ClearValues->size() == data.Attachments->size())
 
 	m_Device = data.Device;
@@ -38,7 +38,7 @@ namespace vge
 
 	struct RenderPassCreateInfo
 	{
-		vge::Device* Device = nullptr;
+		const vge::Device* Device = nullptr;
 		vge::Swapchain* Swapchain = nullptr;
 		u32 SubpassCount = 0;
 		VkFormat ColorFormat = VK_FORMAT_UNDEFINED;
@@ -4,6 +4,7 @@
 #include "Shader.h"
 #include "Utils.h"
 #include "File.h"
+#include <filesystem>
 
 static inline void IncrementRenderFrame() 
 { 
@@ -16,17 +17,31 @@ vge::Renderer::Renderer(Device* device) : m_Device(device)
 
 void vge::Renderer::Initialize()
 {
+	const ApplicationSpecs& appSpecs = GApplication->Specs;
+	GMaxDrawFrames = std::clamp(static_cast<i32>(appSpecs.Render.FramesInFlight), 1, GMaxDrawFramesLimit);
+	m_LowLatency = appSpecs.Render.LowLatency;
+
+	LOG(Log, "Frames in flight: %d, low latency: %s", GMaxDrawFrames, m_LowLatency ? "on" : "off");
+
+	if (m_Device->IsHeadless() && appSpecs.Headless.ReadbackInterval > 0)
+	{
+		m_ReadbackInterval = appSpecs.Headless.ReadbackInterval;
+		m_ReadbackDirectory = appSpecs.Headless.ReadbackDirectory;
+
+		std::error_code error;
+		std::filesystem::create_directories(m_ReadbackDirectory, error);
+		ENSURE_MSG(!error, "Failed to create readback directory.");
+
+		LOG(Log, "Every %u frame is read back to %s.", m_ReadbackInterval, m_ReadbackDirectory.c_str());
+	}
+
 	CreateSwapchain();
-	CreateRenderPassColorAttachments();
-	CreateRenderPassDepthAttachments();
-	CreateRenderPass();
-	CreatePushConstantRange();
+	CreateRenderGraph();
 	CreatePipelines();
 	CreateFramebuffers();
-	AllocateCommandBuffers();
+	CreateFrameContexts();
 	CreateTextureSampler();
-	CreateUniformBuffers();
-	CreateDescriptorPools();
+	CreateDescriptorAllocators();
 	CreateDescriptorSets();
 	CreateSyncObjects();
 
@@ -37,6 +52,15 @@ void vge::Renderer::Initialize()
 void vge::Renderer::Destroy()
 {
 	m_Device->WaitIdle();
+	m_DeletionQueue.FlushAll();
+
+	for (FrameContext& frame : m_Frames)
+	{
+		if (frame.GetReadbackFrame() != INDEX_NONE)
+		{
+			SaveReadback(&frame);
+		}
+	}
 
 	for (size_t i = 0; i < m_Models.size(); ++i)
 	{
@@ -50,77 +74,168 @@ void vge::Renderer::Destroy()
 		m_Textures[i].Destroy();
 	}
 
-	DestroyRenderPassColorAttachments();
-	DestroyRenderPassDepthAttachments();
+	LOG(Log, "Input to %s latency: %.2fms average, %.2fms max over %llu frames.", m_Device->IsPresentWaitSupported() ? "present" : "gpu completion",
+		m_LatencyStats.GetAverageMs(), m_LatencyStats.MaxMs, static_cast<unsigned long long>(m_LatencyStats.FrameCount));
 
-	vkDestroyDescriptorPool(m_Device->GetHandle(), m_InputDescriptorPool, nullptr);
-	vkDestroyDescriptorPool(m_Device->GetHandle(), m_SamplerDescriptorPool, nullptr);
-	vkDestroyDescriptorPool(m_Device->GetHandle(), m_UniformDescriptorPool, nullptr);
-
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
 	{
-		m_VpUniformBuffers[i].Destroy();
+		const DescriptorAllocatorStats& stats = m_DescriptorAllocator.GetStats();
+		LOG(Log, "Descriptor allocator: %u sets in %u pools (%.1f%% utilization).", stats.AllocatedSetCount, stats.PoolCount, stats.GetUtilization() * 100.0f);
 	}
 
-	for (i32 i = 0; i < GMaxDrawFrames; ++i)
+	m_DescriptorAllocator.Destroy();
+	vkDestroyDescriptorPool(m_Device->GetHandle(), m_BindlessDescriptorPool, nullptr);
+
+	for (FrameContext& frame : m_Frames)
 	{
-		vkDestroyFence(m_Device->GetHandle(), m_DrawFences[i], nullptr);
-		vkDestroySemaphore(m_Device->GetHandle(), m_RenderFinishedSemas[i], nullptr);
-		vkDestroySemaphore(m_Device->GetHandle(), m_ImageAvailableSemas[i], nullptr);
+		frame.Destroy();
 	}
 
+	DestroyRenderFinishedSemaphores();
+	vkDestroySemaphore(m_Device->GetHandle(), m_FrameTimeline, nullptr);
+
 	for (Pipeline& pipeline : m_Pipelines)
 	{
 		pipeline.Destroy();
 	}
 
-	m_RenderPass.Destroy();
+	m_RenderGraph.Destroy();
 
-	m_Swapchain->Destroy(m_SwapchainRecreateInfo.get());
+	m_Swapchain->Destroy();
 }
 
 vge::CommandBuffer* vge::Renderer::BeginFrame()
 {
-	vkWaitForFences(m_Device->GetHandle(), 1, &m_DrawFences[GRenderFrame], VK_TRUE, UINT64_MAX);	// wait till open
-	vkResetFences(m_Device->GetHandle(), 1, &m_DrawFences[GRenderFrame]);						// close after enter
+	FrameContext* frame = GetCurrentFrame();
 
-	if (m_Swapchain->AcquireNextImage(m_ImageAvailableSemas[GRenderFrame]) == VK_ERROR_OUT_OF_DATE_KHR)
+	// Wait only for previous submit of this frame, later frames may still be in flight.
+	m_Device->WaitSemaphore(m_FrameTimeline, frame->GetTimelineValue());
+
+	if (frame->GetReadbackFrame() != INDEX_NONE)
+	{
+		SaveReadback(frame);
+	}
+
+	if (frame->HasPendingStats())
+	{
+		RetireFrameStats(frame);
+	}
+
+	frame->Reset();
+
+	// Other frames may have retired too, not only the waited one.
+	m_DeletionQueue.Flush(m_Device->GetSemaphoreValue(m_FrameTimeline));
+	m_DeletionQueue.SetFrameValue(m_FrameTimelineValue + 1);
+
+	// Semaphore is not signaled if acquire failed, so it can be used again with new swapchain.
+	while (m_Swapchain->AcquireNextImage(frame->GetImageAvailableSemaphore()) == VK_ERROR_OUT_OF_DATE_KHR)
 	{
 		RecreateSwapchain();
 	}
 
-	return GetCurrentCmdBuffer();
+	// Done after acquire, graph images may have been recreated with swapchain.
+	AllocateFrameDescriptorSets(frame);
+
+	return frame->GetCmdBuffer();
 }
 
 void vge::Renderer::EndFrame()
 {
 	const u32 imageIndex = m_Swapchain->GetCurrentImageIndex();
 
+	FrameContext* frame = GetCurrentFrame();
+	const u64 signalValue = ++m_FrameTimelineValue;
+
+	// Offscreen image is neither acquired nor presented, only frame timeline is signaled.
+	const bool offscreen = m_Swapchain->IsOffscreen();
+
+	VkSemaphore waitSemaphores[] = { frame->GetImageAvailableSemaphore() };
 	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	const u64 waitValues[] = { 0 }; // ignored for binary semaphore
+	const u32 waitSemaphoreCount = offscreen ? 0 : static_cast<u32>(C_ARRAY_NUM(waitSemaphores));
+
+	VkSemaphore signalSemaphores[] = { m_FrameTimeline, offscreen ? VK_NULL_HANDLE : m_RenderFinishedSemas[imageIndex] };
+	const u64 signalValues[] = { signalValue, 0 };
+	const u32 signalSemaphoreCount = offscreen ? 1 : static_cast<u32>(C_ARRAY_NUM(signalSemaphores));
+
+	VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo = {};
+	timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+	timelineSubmitInfo.waitSemaphoreValueCount = waitSemaphoreCount;
+	timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+	timelineSubmitInfo.signalSemaphoreValueCount = signalSemaphoreCount;
+	timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+
+	if (m_CollectFrameStats)
+	{
+		FrameStats& stats = frame->GetStats();
+		stats.AppFrame = GAppFrame;
+		stats.DrawCallCount = frame->GetCmdBuffer()->GetDrawCallCount();
+		stats.GpuTimeMs = 0.0;
+		frame->SetPendingStats(true);
+	}
+
+	// Readback is submitted in the same batch, so it is completed with frame timeline value.
+	u32 cmdCount = 1;
+	VkCommandBuffer cmds[] = { frame->GetCmdBuffer()->GetHandle(), VK_NULL_HANDLE };
+	if (frame->HasReadbackBuffer() && (GAppFrame + 1) % m_ReadbackInterval == 0)
+	{
+		RecordReadback(frame, imageIndex);
+		cmds[cmdCount++] = frame->GetReadbackCmdBuffer()->GetHandle();
+	}
 
-	VkCommandBuffer cmd = m_CommandBuffers[imageIndex].GetHandle();
 	VkSubmitInfo submitInfo = {};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = &m_ImageAvailableSemas[GRenderFrame];
+	submitInfo.pNext = &timelineSubmitInfo;
+	submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &cmd;
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = &m_RenderFinishedSemas[GRenderFrame];
+	submitInfo.commandBufferCount = cmdCount;
+	submitInfo.pCommandBuffers = cmds;
+	submitInfo.signalSemaphoreCount = signalSemaphoreCount;
+	submitInfo.pSignalSemaphores = signalSemaphores;
+
+	VK_ENSURE(vkQueueSubmit(m_Device->GetGfxQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+	frame->SetTimelineValue(signalValue);
+
+	PendingPresent pendingPresent = {};
+	pendingPresent.TimelineValue = signalValue;
+	pendingPresent.InputTime = m_InputSampleTime;
+	pendingPresent.PresentId = m_Device->IsPresentWaitSupported() ? ++m_PresentId : 0;
+
+	m_PendingPresents.push_back(pendingPresent);
+	if (m_PendingPresents.size() > GMaxPendingPresents)
+	{
+		m_PendingPresents.pop_front();
+	}
 
-	// Open fence after successful render.
-	VK_ENSURE(vkQueueSubmit(m_Device->GetGfxQueue(), 1, &submitInfo, m_DrawFences[GRenderFrame]));
+	// Latency of offscreen frame is measured to its gpu completion.
+	if (!offscreen)
+	{
+		Present(imageIndex, pendingPresent);
+	}
+
+	IncrementRenderFrame();
+}
 
+void vge::Renderer::Present(u32 imageIndex, const PendingPresent& present)
+{
 	VkSwapchainKHR swapchain = m_Swapchain->GetHandle();
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = &m_RenderFinishedSemas[GRenderFrame];
+	presentInfo.pWaitSemaphores = &m_RenderFinishedSemas[imageIndex];
 	presentInfo.swapchainCount = 1;
 	presentInfo.pSwapchains = &swapchain;
 	presentInfo.pImageIndices = &imageIndex;
 
+	VkPresentIdKHR presentId = {};
+	if (present.PresentId != 0)
+	{
+		presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+		presentId.swapchainCount = 1;
+		presentId.pPresentIds = &present.PresentId;
+		presentInfo.pNext = &presentId;
+	}
+
 	VkResult queuePresentResult = vkQueuePresentKHR(m_Device->GetPresentQueue(), &presentInfo);
 	if (queuePresentResult == VK_ERROR_OUT_OF_DATE_KHR || queuePresentResult == VK_SUBOPTIMAL_KHR || m_Device->WasWindowResized())
 	{
@@ -131,239 +246,278 @@ void vge::Renderer::EndFrame()
 	{
 		VK_ENSURE(queuePresentResult);
 	}
+}
 
-	IncrementRenderFrame();
+void vge::Renderer::RecordReadback(FrameContext* frame, u32 imageIndex)
+{
+	CommandBuffer* cmd = frame->GetReadbackCmdBuffer();
+	cmd->BeginRecord(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	// Render pass leaves offscreen image as color attachment, its writes must be done before copy.
+	VkImageMemoryBarrier imageBarrier = {};
+	imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	imageBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.image = m_Swapchain->GetImage(imageIndex)->Handle;
+	imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageBarrier.subresourceRange.levelCount = 1;
+	imageBarrier.subresourceRange.layerCount = 1;
+
+	vkCmdPipelineBarrier(cmd->GetHandle(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+	VkBufferImageCopy copyRegion = {};
+	copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	copyRegion.imageSubresource.layerCount = 1;
+	copyRegion.imageExtent = { m_Swapchain->GetExtentWidth(), m_Swapchain->GetExtentHeight(), 1 };
+
+	vkCmdCopyImageToBuffer(cmd->GetHandle(), imageBarrier.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, frame->GetReadbackBuffer()->Handle, 1, &copyRegion);
+
+	// Copy is read on host after frame timeline wait.
+	VkBufferMemoryBarrier bufferBarrier = {};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = frame->GetReadbackBuffer()->Handle;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(cmd->GetHandle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+
+	cmd->EndRecord();
+
+	frame->SetReadbackFrame(static_cast<i64>(GAppFrame));
+}
+
+void vge::Renderer::SaveReadback(FrameContext* frame)
+{
+	const Buffer* readbackBuffer = frame->GetReadbackBuffer();
+	VK_ENSURE(vmaInvalidateAllocation(m_Device->GetAllocator(), readbackBuffer->Allocation, 0, VK_WHOLE_SIZE));
+
+	char filename[256];
+	std::snprintf(filename, sizeof(filename), "%s/frame_%06lld.ppm", m_ReadbackDirectory.c_str(), static_cast<long long>(frame->GetReadbackFrame()));
+
+	const u8* pixels = static_cast<const u8*>(readbackBuffer->AllocInfo.pMappedData);
+	if (file::SaveImagePpm(filename, pixels, m_Swapchain->GetExtentWidth(), m_Swapchain->GetExtentHeight()))
+	{
+		LOG(Log, "Frame read back to %s.", filename);
+	}
+
+	frame->SetReadbackFrame(INDEX_NONE);
+}
+
+void vge::Renderer::WaitFrameLatency()
+{
+	// Nothing is queued for presentation when input is sampled after previous frame is on screen.
+	if (m_LowLatency && !m_PendingPresents.empty())
+	{
+		WaitPresent(m_PendingPresents.back(), GPresentWaitTimeout);
+	}
+
+	// Presents are polled, so latency may be overestimated by time since their completion.
+	const f64 now = m_Device->GetWindow()->GetTime();
+	while (!m_PendingPresents.empty() && WaitPresent(m_PendingPresents.front(), 0))
+	{
+		const f64 latencyMs = (now - m_PendingPresents.front().InputTime) * 1000.0;
+		m_LatencyStats.FrameCount++;
+		m_LatencyStats.TotalMs += latencyMs;
+		m_LatencyStats.MaxMs = std::max(m_LatencyStats.MaxMs, latencyMs);
+
+		m_PendingPresents.pop_front();
+	}
+
+	m_InputSampleTime = m_Device->GetWindow()->GetTime();
+}
+
+bool vge::Renderer::WaitPresent(const PendingPresent& present, u64 timeout) const
+{
+	if (present.PresentId != 0)
+	{
+		return m_Device->WaitForPresent(m_Swapchain->GetHandle(), present.PresentId, timeout);
+	}
+
+	return m_Device->WaitSemaphore(m_FrameTimeline, present.TimelineValue, timeout);
+}
+
+bool vge::Renderer::PopRetiredFrameStats(FrameStats& outStats)
+{
+	if (m_RetiredFrameStats.empty())
+	{
+		return false;
+	}
+
+	outStats = m_RetiredFrameStats.front();
+	m_RetiredFrameStats.pop_front();
+	return true;
+}
+
+void vge::Renderer::RetireAllFrames()
+{
+	m_Device->WaitIdle();
+
+	// Current frame is the oldest one in flight, as it is reused next.
+	for (i32 i = 0; i < GMaxDrawFrames; ++i)
+	{
+		FrameContext& frame = m_Frames[(GRenderFrame + i) % GMaxDrawFrames];
+		if (frame.HasPendingStats())
+		{
+			RetireFrameStats(&frame);
+		}
+	}
+}
+
+void vge::Renderer::WriteFrameTimestamp(CommandBuffer* cmd, FrameTimestamp timestamp)
+{
+	const VkQueryPool queryPool = GetCurrentFrame()->GetTimestampQueryPool();
+	if (!m_CollectFrameStats || !queryPool)
+	{
+		return;
+	}
+
+	if (timestamp == FrameTimestamp::Begin)
+	{
+		// Queries must be reset before they are written again, it is not allowed within render pass.
+		vkCmdResetQueryPool(cmd->GetHandle(), queryPool, 0, static_cast<u32>(FrameTimestamp::Count));
+		vkCmdWriteTimestamp(cmd->GetHandle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, static_cast<u32>(FrameTimestamp::Begin));
+	}
+	else
+	{
+		vkCmdWriteTimestamp(cmd->GetHandle(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, static_cast<u32>(timestamp));
+	}
+}
+
+void vge::Renderer::RetireFrameStats(FrameContext* frame)
+{
+	FrameStats stats = frame->GetStats();
+
+	if (const VkQueryPool queryPool = frame->GetTimestampQueryPool())
+	{
+		u64 timestamps[static_cast<size_t>(FrameTimestamp::Count)] = {};
+		const VkResult result = vkGetQueryPoolResults(m_Device->GetHandle(), queryPool, 0, static_cast<u32>(FrameTimestamp::Count),
+			sizeof(timestamps), timestamps, sizeof(u64), VK_QUERY_RESULT_64_BIT);
+
+		// Frame has retired, so results are not ready only if it was recorded before stats were enabled.
+		if (result == VK_SUCCESS)
+		{
+			const u64 ticks = timestamps[static_cast<size_t>(FrameTimestamp::End)] - timestamps[static_cast<size_t>(FrameTimestamp::Begin)];
+			stats.GpuTimeMs = static_cast<f64>(ticks) * m_Device->GetTimestampPeriod() / 1'000'000.0;
+		}
+	}
+
+	m_RetiredFrameStats.push_back(stats);
+	frame->SetPendingStats(false);
 }
 
 void vge::Renderer::CreateSwapchain()
 {
 	m_SwapchainRecreateInfo = std::make_unique<SwapchainRecreateInfo>();
 	m_SwapchainRecreateInfo->Surface = m_Device->GetInitialSurface();
+	m_SwapchainRecreateInfo->PresentMode = GApplication->Specs.Render.PresentMode;
+	m_SwapchainRecreateInfo->ImageCount = GApplication->Specs.Render.SwapchainImageCount;
+
+	// Offscreen image per frame in flight, so image is rendered again only after its frame retired.
+	if (m_Device->IsHeadless() && m_SwapchainRecreateInfo->ImageCount == 0)
+	{
+		m_SwapchainRecreateInfo->ImageCount = static_cast<u32>(GMaxDrawFrames);
+	}
 
 	m_Swapchain = std::make_unique<Swapchain>(m_Device);
 	m_Swapchain->Initialize(m_SwapchainRecreateInfo.get());
 }
 
-void vge::Renderer::CreateRenderPassColorAttachments()
+void vge::Renderer::CreateRenderGraph()
 {
-	const size_t swapchainImageCount = m_Swapchain->GetImageCount();
-	m_ColorAttachments.resize(swapchainImageCount);
-	m_ColorFormat = Image::GetBestFormat(m_Device, { VK_FORMAT_R8G8B8A8_UNORM }, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	const VkFormat colorFormat = Image::GetBestFormat(m_Device, { VK_FORMAT_R8G8B8A8_UNORM }, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	const VkFormat depthFormat = Image::GetBestFormat(m_Device, { VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT }, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+	VkClearValue backbufferClearValue = {};
+	backbufferClearValue.color = { 0.0f, 0.0f, 0.0f, 1.0f }; // draw black triangle by default, dont care actually
+
+	VkClearValue sceneColorClearValue = {};
+	sceneColorClearValue.color = { 0.0f, 0.2f, 0.3f, 1.0f };
+
+	VkClearValue sceneDepthClearValue = {};
+	sceneDepthClearValue.depthStencil.depth = 1.0f;
+
+	m_RenderGraph.Initialize(m_Device);
+
+	// Offscreen image stays color attachment, it is transitioned only if read back.
+	const VkImageLayout backbufferFinalLayout = m_Swapchain->IsOffscreen() ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	m_BackbufferImage = m_RenderGraph.ImportImage("Backbuffer", m_Swapchain->GetImageFormat(), backbufferClearValue, backbufferFinalLayout);
+	m_SceneColorImage = m_RenderGraph.CreateImage("SceneColor", colorFormat, sceneColorClearValue);
+	m_SceneDepthImage = m_RenderGraph.CreateImage("SceneDepth", depthFormat, sceneDepthClearValue);
+
+	// Render everything to color and depth ...
+	m_ScenePass = m_RenderGraph.AddPass("Scene");
+	m_RenderGraph.WriteColor(m_ScenePass, m_SceneColorImage);
+	m_RenderGraph.WriteDepth(m_ScenePass, m_SceneDepthImage);
+
+	// ... and compose them on swapchain image.
+	m_CompositionPass = m_RenderGraph.AddPass("Composition");
+	m_RenderGraph.ReadInput(m_CompositionPass, m_SceneColorImage);
+	m_RenderGraph.ReadInput(m_CompositionPass, m_SceneDepthImage);
+	m_RenderGraph.WriteColor(m_CompositionPass, m_BackbufferImage);
 
-	ImageCreateInfo imageCreateInfo = {};
-	imageCreateInfo.Device = m_Device;
-	imageCreateInfo.Extent = m_Swapchain->GetExtent();
-	imageCreateInfo.Format = m_ColorFormat;
-	imageCreateInfo.Tiling = VK_IMAGE_TILING_OPTIMAL;
-	imageCreateInfo.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
-	imageCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-	ImageViewCreateInfo viewCreateInfo = {};
-	viewCreateInfo.Device = m_Device;
-	viewCreateInfo.Format = m_ColorFormat;
-	viewCreateInfo.AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
-
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
-	{
-		m_ColorAttachments[i].Image = Image::Create(imageCreateInfo);
-		viewCreateInfo.Image = m_ColorAttachments[i].Image.GetHandle();
-		m_ColorAttachments[i].View = Image::CreateView(viewCreateInfo);
-	}
-}
-
-void vge::Renderer::CreateRenderPassDepthAttachments()
-{
-	const size_t swapchainImageCount = m_Swapchain->GetImageCount();
-	m_DepthAttachments.resize(swapchainImageCount);
-	m_DepthFormat = Image::GetBestFormat(m_Device, { VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT }, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
-
-	ImageCreateInfo imageCreateInfo = {};
-	imageCreateInfo.Device = m_Device;
-	imageCreateInfo.Extent = m_Swapchain->GetExtent();
-	imageCreateInfo.Format = m_DepthFormat;
-	imageCreateInfo.Tiling = VK_IMAGE_TILING_OPTIMAL;
-	imageCreateInfo.Usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
-	imageCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-	ImageViewCreateInfo viewCreateInfo = {};
-	viewCreateInfo.Device = m_Device;
-	viewCreateInfo.Format = m_DepthFormat;
-	viewCreateInfo.AspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
-
-	for (size_t i = 0; i < swapchainImageCount; ++i)
-	{
-		m_DepthAttachments[i].Image = Image::Create(imageCreateInfo);
-		viewCreateInfo.Image = m_DepthAttachments[i].Image.GetHandle();
-		m_DepthAttachments[i].View = Image::CreateView(viewCreateInfo);
-	}
-}
-
-void vge::Renderer::CreateRenderPass()
-{
-	std::vector<VkSubpassDescription> subpasses(m_SubpassCount);
-
-	// Attachments and references for 1 subpass.
-	// This subpass will have color and depth ones.
-	// They will be used as inputs later.
-
-	VkAttachmentDescription colorAttachment = {};
-	colorAttachment.format = m_ColorFormat;
-	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	// Store op tells how to store data after render pass finish,
-	// as we do not use 1 subpass to present images - dont care.
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkAttachmentDescription depthAttachment = {};
-	depthAttachment.format = m_DepthFormat;
-	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-	VkAttachmentReference colorAttachmentReference = {};
-	// Attachment corresponds to index position in array of image views passed to framebuffer create info.
-	colorAttachmentReference.attachment = 1;
-	colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkAttachmentReference depthAttachmentReference = {};
-	depthAttachmentReference.attachment = 2;
-	depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-	subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpasses[0].colorAttachmentCount = 1;
-	subpasses[0].pColorAttachments = &colorAttachmentReference;
-	subpasses[0].pDepthStencilAttachment = &depthAttachmentReference;
-
-	// Attachments and references for 2 subpass.
-	// This subpass will present images to the screnn.
-	// Will use depth and color attachments from previous 1 subpass as inputs.
-
-	VkAttachmentDescription swapchainColorAttachment = {};
-	swapchainColorAttachment.format = m_Swapchain->GetImageFormat();
-	swapchainColorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	swapchainColorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	// Here we want to store attachment after render pass as we want to present an image to the screen.
-	swapchainColorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	swapchainColorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	swapchainColorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	swapchainColorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	swapchainColorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference swapchainColorAttachmentReference = {};
-	swapchainColorAttachmentReference.attachment = 0;
-	swapchainColorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	std::array<VkAttachmentReference, 2> inputAttachmentReferences = {};
-	inputAttachmentReferences[0].attachment = 1; // reuse color attachment from 1 subpass
-	inputAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	inputAttachmentReferences[1].attachment = 2; // reuse depth attachment from 1 subpass
-	inputAttachmentReferences[1].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-	subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpasses[1].colorAttachmentCount = 1;
-	subpasses[1].pColorAttachments = &swapchainColorAttachmentReference;
-	subpasses[1].inputAttachmentCount = static_cast<u32>(inputAttachmentReferences.size());
-	subpasses[1].pInputAttachments = inputAttachmentReferences.data();
-
-	// Amount of dependencies = amount of subpasses + 1.
-	// <dependency1> (subpass1) <dependency2> (subpass2) <dependency3>.
-	std::vector<VkSubpassDependency> dependencies(m_SubpassCount + 1);
-
-	// Start to subpass 1.
-	// Image layout transition must happen after ...
-	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-	// Stage we want to make sure is finished before layout transition.
-	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-	dependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-	// ... and before ...
-	dependencies[0].dstSubpass = 0;
-	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	dependencies[0].dependencyFlags = 0;
-
-	// From subpass 1 to subpass 2.
-	// Image layout transition must happen after ...
-	dependencies[1].srcSubpass = 0;
-	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	// ... and before ...
-	dependencies[1].dstSubpass = 1;
-	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-	dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-	dependencies[1].dependencyFlags = 0;
-
-	// Subpass 2 to end.
-	// Image layout transition must happen after ...
-	dependencies[2].srcSubpass = 1;
-	dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	// ... and before ...
-	dependencies[2].dstSubpass = VK_SUBPASS_EXTERNAL;
-	dependencies[2].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-	dependencies[2].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-	dependencies[2].dependencyFlags = 0;
-
-	// Order should correspond to attachment values in attachment descriptions.
-	std::vector<VkAttachmentDescription> attachments = { swapchainColorAttachment, colorAttachment, depthAttachment };
-	std::vector<VkClearValue> clearValues(attachments.size());
-	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f }; // draw black triangle by default, dont care actually
-	clearValues[1].color = { 0.0f, 0.2f, 0.3f, 1.0f };
-	clearValues[2].depthStencil.depth = 1.0f;
-
-	RenderPassCreateInfo createInfo = {};
-	createInfo.Device = m_Device;
-	createInfo.SubpassCount = m_SubpassCount;
-	createInfo.ColorFormat = m_ColorFormat;
-	createInfo.DepthFormat = m_DepthFormat;
-	createInfo.Subpasses = &subpasses;
-	createInfo.Dependencies = &dependencies;
-	createInfo.Attachments = &attachments;
-	createInfo.ClearValues = &clearValues;
-
-	m_RenderPass.Initialize(createInfo);
-}
-
-void vge::Renderer::CreatePushConstantRange()
-{
-	m_PushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	m_PushConstantRange.offset = 0;
-	m_PushConstantRange.size = sizeof(ModelData);
+	m_RenderGraph.SetOutput(m_BackbufferImage);
+	m_RenderGraph.Compile();
+
+	CreateRenderGraphImages();
+}
+
+void vge::Renderer::CreateRenderGraphImages()
+{
+	// Graph images are used only within render pass, so frames in flight need own copies, not swapchain images.
+	m_RenderGraph.CreateImages(m_Swapchain->GetExtent(), static_cast<u32>(GMaxDrawFrames));
+
+	constexpr f32 bytesInMiB = 1024.0f * 1024.0f;
+	const f32 memorySize = static_cast<f32>(m_RenderGraph.GetImageMemorySize()) / bytesInMiB;
+	const f32 perSwapchainImageSize = memorySize / GMaxDrawFrames * m_Swapchain->GetImageCount();
+
+	LOG(Log, "Render graph images %ux%u: %.1f MiB for %d frames in flight%s, %.1f MiB with copy per swapchain image (%zu images).",
+		m_Swapchain->GetExtentWidth(), m_Swapchain->GetExtentHeight(), memorySize, GMaxDrawFrames,
+		m_RenderGraph.IsImageMemoryLazilyAllocated() ? " (lazily allocated)" : "", perSwapchainImageSize, m_Swapchain->GetImageCount());
 }
 
 void vge::Renderer::CreatePipelines()
 {
-	m_Pipelines.resize(m_RenderPass.GeSubpassCount(), Pipeline());
+	m_Pipelines.resize(m_RenderGraph.GetSubpassCount(), Pipeline());
+	m_PipelineFeatures.resize(m_Pipelines.size(), GApplication->Specs.Render.ShaderFeatures);
 
 	// TODO: create convenient abstraction for multiple pipelines creation, e.g map with pipeline and its create data.
 
-	u32 currentSubpassIdx = 0;
+	for (u32 subpassIdx = 0; subpassIdx < m_RenderGraph.GetSubpassCount(); ++subpassIdx)
+	{
+		InitializePipeline(subpassIdx, PipelineInitMode::Create);
+	}
+
+	// Scene pipeline layout is reflected from shaders, so it must match data pushed by render system.
+	const u32 pushConstantsSize = sizeof(ModelData) + sizeof(MeshData) + (IsBindless() ? sizeof(MaterialData) : 0);
+	ENSURE_MSG(GetPassPipeline(m_ScenePass).GetPushConstantRange().size == pushConstantsSize, "Scene shader push constants do not match ModelData, MeshData and MaterialData.");
+}
+
+void vge::Renderer::InitializePipeline(u32 subpassIdx, PipelineInitMode mode)
+{
+	VertexInputDescription vertexDescription = {};
+	PipelineCreateInfo pipelineCreateInfo = {};
+	pipelineCreateInfo.DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	Pipeline::DefaultCreateInfo(pipelineCreateInfo);
+
+	pipelineCreateInfo.Device = m_Device;
+	pipelineCreateInfo.RenderPass = m_RenderGraph.GetRenderPass();
+	pipelineCreateInfo.SubpassIndex = subpassIdx;
+	pipelineCreateInfo.Features = m_PipelineFeatures[subpassIdx];
 
-	// First pipeline creation. Used to render everything.
+	const RenderGraphHandle pass = m_RenderGraph.GetSubpassPass(subpassIdx);
+
+	// Scene pipeline creation. Used to render everything.
 	// As this pipeline is used for rendering actual data, we need vertex input.
+	if (pass == m_ScenePass)
 	{
-		VkDescriptorSetLayoutBinding vpLayoutBinding = {};
-		vpLayoutBinding.binding = 0; // binding for a particular subpass
-		vpLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		vpLayoutBinding.descriptorCount = 1;
-		vpLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-		vpLayoutBinding.pImmutableSamplers = nullptr;
-
-		VkDescriptorSetLayoutBinding samplerLayoutBinding = {};
-		samplerLayoutBinding.binding = 0; // should be increased by 1 if this was used in vertex shader as previous one
-		samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		samplerLayoutBinding.descriptorCount = 1;
-		samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-		samplerLayoutBinding.pImmutableSamplers = nullptr;
-
-		const VertexInputDescription vertexDescription = Vertex::GetDescription();
+		vertexDescription = Vertex::GetDescription();
 		VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo = {};
 		vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 		vertexInputCreateInfo.vertexBindingDescriptionCount = static_cast<u32>(vertexDescription.Bindings.size());
@@ -371,74 +525,116 @@ void vge::Renderer::CreatePipelines()
 		vertexInputCreateInfo.vertexAttributeDescriptionCount = static_cast<u32>(vertexDescription.Attributes.size());
 		vertexInputCreateInfo.pVertexAttributeDescriptions = vertexDescription.Attributes.data();
 
-		PipelineCreateInfo pipelineCreateInfo = {};
-		pipelineCreateInfo.DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-		Pipeline::DefaultCreateInfo(pipelineCreateInfo);
-
-		pipelineCreateInfo.Device = m_Device;
-		pipelineCreateInfo.PushConstants = { m_PushConstantRange };
-		pipelineCreateInfo.ShaderFilenames = { "Shaders/Bin/first_vert.spv", "Shaders/Bin/first_frag.spv" };
-		pipelineCreateInfo.DescriptorSetLayoutBindings = { { vpLayoutBinding }, { samplerLayoutBinding } };
-		pipelineCreateInfo.RenderPass = &m_RenderPass;
+		const char* fragmentShaderFilename = IsBindless() ? "Shaders/Bin/first_bindless_frag.spv" : "Shaders/Bin/first_frag.spv";
+		pipelineCreateInfo.ShaderFilenames = { GVertexLayout.GetVertexShaderFilename(), fragmentShaderFilename };
 		pipelineCreateInfo.VertexInfo = vertexInputCreateInfo;
-		pipelineCreateInfo.SubpassIndex = currentSubpassIdx++;
+	}
+	// Composition pipeline creation. Used to present data from scene pipeline.
+	// This pipeline just presents data on screen, so we don't need any vertex input here.
+	else if (pass == m_CompositionPass)
+	{
+		pipelineCreateInfo.ShaderFilenames = { "Shaders/Bin/second_vert.spv", "Shaders/Bin/second_frag.spv" };
+		pipelineCreateInfo.DepthStencilInfo.depthWriteEnable = VK_FALSE;
+	}
+	else
+	{
+		ENSURE_MSG(false, "No pipeline is described for given subpass.");
+		return;
+	}
+
+	switch (mode)
+	{
+	case PipelineInitMode::Create:
+		m_Pipelines[subpassIdx].Initialize(pipelineCreateInfo);
+		break;
+
+	case PipelineInitMode::Reload:
+		m_Pipelines[subpassIdx].Reload(pipelineCreateInfo);
+		break;
 
-		m_Pipelines[0].Initialize(pipelineCreateInfo);
+	case PipelineInitMode::Variant:
+		m_Pipelines[subpassIdx].SelectVariant(pipelineCreateInfo);
+		break;
 	}
+}
 
-	// Second pipeline creation. Used to present data from previous pipeline.
-	// This pipeline just presents data on screen, so we don't need any vertex input here.
+void vge::Renderer::ReloadPipelines(const std::vector<const char*>& shaderFilenames)
+{
+	m_Device->WaitIdle();
+
+	for (u32 subpassIdx = 0; subpassIdx < static_cast<u32>(m_Pipelines.size()); ++subpassIdx)
 	{
-		VkDescriptorSetLayoutBinding colorInputLayoutBinding = {};
-		colorInputLayoutBinding.binding = 0;
-		colorInputLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		colorInputLayoutBinding.descriptorCount = 1;
-		colorInputLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		const bool affected = std::any_of(shaderFilenames.begin(), shaderFilenames.end(), [this, subpassIdx](const char* filename)
+		{
+			return m_Pipelines[subpassIdx].UsesShader(filename);
+		});
+
+		if (affected)
+		{
+			InitializePipeline(subpassIdx, PipelineInitMode::Reload);
+			LOG(Log, "Pipeline for subpass %u reloaded.", subpassIdx);
+		}
+	}
+}
 
-		VkDescriptorSetLayoutBinding depthInputLayoutBinding = {};
-		depthInputLayoutBinding.binding = 1;
-		depthInputLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		depthInputLayoutBinding.descriptorCount = 1;
-		depthInputLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+void vge::Renderer::SetPipelineFeatures(u32 subpassIdx, ShaderFeatures features)
+{
+	ENSURE(subpassIdx < m_PipelineFeatures.size());
 
-		PipelineCreateInfo pipelineCreateInfo = {};
-		pipelineCreateInfo.DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-		Pipeline::DefaultCreateInfo(pipelineCreateInfo);
+	if (m_PipelineFeatures[subpassIdx] == features)
+	{
+		return;
+	}
 
-		pipelineCreateInfo.Device = m_Device;
-		pipelineCreateInfo.ShaderFilenames = { "Shaders/Bin/second_vert.spv", "Shaders/Bin/second_frag.spv" };
-		pipelineCreateInfo.DescriptorSetLayoutBindings = { {}, { colorInputLayoutBinding, depthInputLayoutBinding } };
-		pipelineCreateInfo.RenderPass = &m_RenderPass;
-		pipelineCreateInfo.SubpassIndex = currentSubpassIdx++;
-		pipelineCreateInfo.DepthStencilInfo.depthWriteEnable = VK_FALSE;
+	m_PipelineFeatures[subpassIdx] = features;
+	InitializePipeline(subpassIdx, PipelineInitMode::Variant);
+}
 
-		m_Pipelines[1].Initialize(pipelineCreateInfo);
+void vge::Renderer::ToggleShaderFeature(ShaderFeature feature)
+{
+	for (u32 subpassIdx = 0; subpassIdx < GetPipelineCount(); ++subpassIdx)
+	{
+		SetPipelineFeatures(subpassIdx, GetPipelineFeatures(subpassIdx) ^ GetFeatureBit(feature));
 	}
 
-	ENSURE(currentSubpassIdx == m_SubpassCount);
+	LOG(Log, "Shader feature %s %s.", ShaderFeatureToString(feature), HasFeature(GetPipelineFeatures(0), feature) ? "enabled" : "disabled");
+}
+
+void vge::Renderer::SetPresentMode(PresentMode mode)
+{
+	m_SwapchainRecreateInfo->PresentMode = mode;
+	RecreateSwapchain();
 }
 
 void vge::Renderer::CreateFramebuffers()
 {
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+	// Framebuffer for each pair of frame in flight graph images and swapchain image.
+	for (i32 frame = 0; frame < GMaxDrawFrames; ++frame)
 	{
-		std::array<VkImageView, 3> attachments = {};
-		attachments[0] = m_Swapchain->GetImage(i)->View;
-		attachments[1] = m_ColorAttachments[i].View;
-		attachments[2] = m_DepthAttachments[i].View;
+		for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+		{
+			std::vector<VkImageView> attachments;
+			m_RenderGraph.GetAttachmentViews(static_cast<u32>(frame), m_Swapchain->GetImage(i)->View, attachments);
 
-		m_Swapchain->CreateFramebuffer(&m_RenderPass, static_cast<u32>(attachments.size()), attachments.data());
+			m_Swapchain->CreateFramebuffer(m_RenderGraph.GetRenderPass(), static_cast<u32>(attachments.size()), attachments.data());
+		}
 	}
 }
 
-void vge::Renderer::AllocateCommandBuffers()
+void vge::Renderer::CreateFrameContexts()
 {
-	const size_t cmdBufferCount = m_Swapchain->GetFramebufferCount();
-	m_CommandBuffers.reserve(cmdBufferCount);
-
-	for (size_t i = 0; i < cmdBufferCount; ++i)
+	FrameContextCreateInfo frameCreateInfo = {};
+	frameCreateInfo.Device = m_Device;
+	frameCreateInfo.MaxIndirectDraws = GMaxIndirectDraws;
+	frameCreateInfo.UniformBufferSize = sizeof(UboViewProjection);
+	frameCreateInfo.Timestamps = m_Device->IsTimestampSupported();
+	// Offscreen images are never resized, so readback buffer size is fixed.
+	frameCreateInfo.ReadbackBufferSize = m_ReadbackInterval > 0 ? static_cast<VkDeviceSize>(m_Swapchain->GetExtentWidth()) * m_Swapchain->GetExtentHeight() * 4 : 0;
+
+	m_Frames.resize(GMaxDrawFrames);
+	for (FrameContext& frame : m_Frames)
 	{
-		m_CommandBuffers.push_back(CommandBuffer::Allocate(m_Device));
+		frame.Initialize(frameCreateInfo);
 	}
 }
 
@@ -465,277 +661,219 @@ void vge::Renderer::CreateTextureSampler()
 	VK_ENSURE(vkCreateSampler(m_Device->GetHandle(), &samplerCreateInfo, nullptr, &m_TextureSampler));
 }
 
-void vge::Renderer::CreateUniformBuffers()
+void vge::Renderer::CreateDescriptorAllocators()
 {
-	constexpr VkDeviceSize vpBufferSize = sizeof(UboViewProjection);
+	m_DescriptorAllocator.Initialize(m_Device);
 
-	m_VpUniformBuffers.resize(m_Swapchain->GetImageCount());
-
-	BufferCreateInfo buffCreateInfo = {};
-	buffCreateInfo.Device = m_Device;
-	buffCreateInfo.Size = vpBufferSize;
-	buffCreateInfo.Usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-	buffCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+	if (IsBindless())
 	{
-		m_VpUniformBuffers[i] = Buffer::Create(buffCreateInfo);
+		VkDescriptorPoolSize bindlessPoolSize = {};
+		bindlessPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindlessPoolSize.descriptorCount = GMaxBindlessDescriptors;
+
+		VkDescriptorPoolCreateInfo bindlessPoolCreateInfo = {};
+		bindlessPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		bindlessPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT; // textures are written into unused slots while set is bound in pending command buffers
+		bindlessPoolCreateInfo.maxSets = 1;
+		bindlessPoolCreateInfo.poolSizeCount = 1;
+		bindlessPoolCreateInfo.pPoolSizes = &bindlessPoolSize;
+
+		VK_ENSURE(vkCreateDescriptorPool(m_Device->GetHandle(), &bindlessPoolCreateInfo, nullptr, &m_BindlessDescriptorPool));
 	}
 }
 
-void vge::Renderer::CreateDescriptorPools()
+void vge::Renderer::CreateDescriptorSets()
 {
+	// Uniform and input sets are transient, allocated from frame context when frame begins.
+	if (IsBindless())
 	{
-		VkDescriptorPoolSize vpPoolSize = {};
-		vpPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		vpPoolSize.descriptorCount = static_cast<u32>(m_VpUniformBuffers.size());
-
-		const std::array<VkDescriptorPoolSize, 1> uniformPoolSizes = { vpPoolSize };
-
-		VkDescriptorPoolCreateInfo uniformPoolCreateInfo = {};
-		uniformPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		uniformPoolCreateInfo.maxSets = static_cast<u32>(m_Swapchain->GetImageCount());
-		uniformPoolCreateInfo.poolSizeCount = static_cast<u32>(uniformPoolSizes.size());
-		uniformPoolCreateInfo.pPoolSizes = uniformPoolSizes.data();
-
-		VK_ENSURE(vkCreateDescriptorPool(m_Device->GetHandle(), &uniformPoolCreateInfo, nullptr, &m_UniformDescriptorPool));
+		AllocateBindlessDescriptorSet();
 	}
+}
 
-	{
-		VkDescriptorPoolSize samplerPoolSize = {};
-		samplerPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; // in advanced projects descriptor for image and sampler should be separate
-		samplerPoolSize.descriptorCount = static_cast<u32>(GMaxSceneObjects);
-
-		const std::array<VkDescriptorPoolSize, 1> samplerPoolSizes = { samplerPoolSize };
-
-		VkDescriptorPoolCreateInfo samplerPoolCreateInfo = {};
-		samplerPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		samplerPoolCreateInfo.maxSets = static_cast<u32>(GMaxSceneObjects);
-		samplerPoolCreateInfo.poolSizeCount = static_cast<u32>(samplerPoolSizes.size());
-		samplerPoolCreateInfo.pPoolSizes = samplerPoolSizes.data();
-
-		VK_ENSURE(vkCreateDescriptorPool(m_Device->GetHandle(), &samplerPoolCreateInfo, nullptr, &m_SamplerDescriptorPool));
-	}
-
-	{
-		VkDescriptorPoolSize colorInputPoolSize = {};
-		colorInputPoolSize.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		colorInputPoolSize.descriptorCount = static_cast<u32>(m_ColorAttachments.size());
-
-		VkDescriptorPoolSize depthInputPoolSize = {};
-		depthInputPoolSize.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		depthInputPoolSize.descriptorCount = static_cast<u32>(m_DepthAttachments.size());
-
-		const std::array<VkDescriptorPoolSize, 2> inputPoolSizes = { colorInputPoolSize, depthInputPoolSize };
+void vge::Renderer::UpdateBindlessDescriptorSet(const Texture& texture)
+{
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = texture.GetView();
+	imageInfo.sampler = m_TextureSampler;
+
+	VkWriteDescriptorSet setWrite = {};
+	setWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	setWrite.dstSet = m_BindlessDescriptorSet;
+	setWrite.dstBinding = 0;
+	setWrite.dstArrayElement = static_cast<u32>(texture.GetId());
+	setWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	setWrite.descriptorCount = 1;
+	setWrite.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &setWrite, 0, nullptr);
+}
 
-		VkDescriptorPoolCreateInfo inputPoolCreateInfo = {};
-		inputPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		inputPoolCreateInfo.maxSets = static_cast<u32>(m_Swapchain->GetImageCount());
-		inputPoolCreateInfo.poolSizeCount = static_cast<u32>(inputPoolSizes.size());
-		inputPoolCreateInfo.pPoolSizes = inputPoolSizes.data();
+void vge::Renderer::CreateSyncObjects()
+{
+	// Frames were never submitted, so waiting for value 0 passes right away.
+	m_FrameTimeline = m_Device->CreateTimelineSemaphore(0);
+	m_FrameTimelineValue = 0;
 
-		VK_ENSURE(vkCreateDescriptorPool(m_Device->GetHandle(), &inputPoolCreateInfo, nullptr, &m_InputDescriptorPool));
-	}
+	CreateRenderFinishedSemaphores();
 }
 
-void vge::Renderer::CreateDescriptorSets()
+void vge::Renderer::CreateRenderFinishedSemaphores()
 {
+	// Nothing is presented from offscreen images.
+	if (m_Swapchain->IsOffscreen())
 	{
-		AllocateUniformDescriptorSet();
-		UpdateUniformDescriptorSet();
+		return;
 	}
 
-	{
-		AllocateInputDescriptorSet();
-		UpdateInputDescriptorSet();
-	}
-}
-
-void vge::Renderer::CreateSyncObjects()
-{
-	m_ImageAvailableSemas.resize(GMaxDrawFrames);
-	m_RenderFinishedSemas.resize(GMaxDrawFrames);
-	m_DrawFences.resize(GMaxDrawFrames);
+	m_RenderFinishedSemas.resize(m_Swapchain->GetImageCount());
 
 	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
 	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-	VkFenceCreateInfo fenceCreateInfo = {};
-	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-	for (i32 i = 0; i < GMaxDrawFrames; ++i)
+	for (VkSemaphore& semaphore : m_RenderFinishedSemas)
 	{
-		VK_ENSURE(vkCreateSemaphore(m_Device->GetHandle(), &semaphoreCreateInfo, nullptr, &m_ImageAvailableSemas[i]));
-		VK_ENSURE(vkCreateSemaphore(m_Device->GetHandle(), &semaphoreCreateInfo, nullptr, &m_RenderFinishedSemas[i]));
-		VK_ENSURE(vkCreateFence(m_Device->GetHandle(), &fenceCreateInfo, nullptr, &m_DrawFences[i]));
+		VK_ENSURE(vkCreateSemaphore(m_Device->GetHandle(), &semaphoreCreateInfo, nullptr, &semaphore));
 	}
 }
 
-void vge::Renderer::AllocateUniformDescriptorSet()
+void vge::Renderer::DestroyRenderFinishedSemaphores(DeletionQueue* deletionQueue /*= nullptr*/)
 {
-	m_UniformDescriptorSets.resize(m_Swapchain->GetImageCount());
-
-	std::vector<VkDescriptorSetLayout> setLayouts(m_Swapchain->GetImageCount(), m_Pipelines[0].GetShader(ShaderStage::Vertex)->GetDescriptorSetLayout().Handle);
-
-	VkDescriptorSetAllocateInfo setAllocInfo = {};
-	setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	setAllocInfo.descriptorPool = m_UniformDescriptorPool;
-	setAllocInfo.descriptorSetCount = static_cast<u32>(m_Swapchain->GetImageCount());
-	setAllocInfo.pSetLayouts = setLayouts.data(); // 1 to 1 relationship with layout and set
+	for (VkSemaphore semaphore : m_RenderFinishedSemas)
+	{
+		if (deletionQueue)
+		{
+			deletionQueue->Push([device = m_Device->GetHandle(), semaphore]() { vkDestroySemaphore(device, semaphore, nullptr); });
+		}
+		else
+		{
+			vkDestroySemaphore(m_Device->GetHandle(), semaphore, nullptr);
+		}
+	}
 
-	VK_ENSURE(vkAllocateDescriptorSets(m_Device->GetHandle(), &setAllocInfo, m_UniformDescriptorSets.data()));
+	m_RenderFinishedSemas.clear();
 }
 
-void vge::Renderer::AllocateInputDescriptorSet()
+void vge::Renderer::AllocateFrameDescriptorSets(FrameContext* frame)
 {
-	m_InputDescriptorSets.resize(m_Swapchain->GetImageCount());
+	frame->AllocateUniformDescriptorSet(GetPassPipeline(m_ScenePass).GetDescriptorSetLayout(0));
+	frame->AllocateInputDescriptorSet(GetPassPipeline(m_CompositionPass).GetDescriptorSetLayout(0),
+		m_RenderGraph.GetView(m_SceneColorImage, static_cast<u32>(GRenderFrame)), m_RenderGraph.GetView(m_SceneDepthImage, static_cast<u32>(GRenderFrame)));
+}
 
-	std::vector<VkDescriptorSetLayout> setLayouts(m_Swapchain->GetImageCount(), m_Pipelines[1].GetShader(ShaderStage::Fragment)->GetDescriptorSetLayout().Handle);
+void vge::Renderer::AllocateBindlessDescriptorSet()
+{
+	const VkDescriptorSetLayout setLayout = GetPassPipeline(m_ScenePass).GetDescriptorSetLayout(1);
 
 	VkDescriptorSetAllocateInfo setAllocInfo = {};
 	setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	setAllocInfo.descriptorPool = m_InputDescriptorPool;
-	setAllocInfo.descriptorSetCount = static_cast<u32>(m_Swapchain->GetImageCount());
-	setAllocInfo.pSetLayouts = setLayouts.data();
+	setAllocInfo.descriptorPool = m_BindlessDescriptorPool;
+	setAllocInfo.descriptorSetCount = 1;
+	setAllocInfo.pSetLayouts = &setLayout;
 
-	VK_ENSURE(vkAllocateDescriptorSets(m_Device->GetHandle(), &setAllocInfo, m_InputDescriptorSets.data()));
+	VK_ENSURE(vkAllocateDescriptorSets(m_Device->GetHandle(), &setAllocInfo, &m_BindlessDescriptorSet));
 }
 
-void vge::Renderer::UpdateUniformDescriptorSet()
+void vge::Renderer::RecreateRenderGraph()
 {
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
-	{
-		VkDescriptorBufferInfo vpDescriptorBufferInfo = {};
-		vpDescriptorBufferInfo.buffer = m_VpUniformBuffers[i].Handle;
-		vpDescriptorBufferInfo.offset = 0;
-		vpDescriptorBufferInfo.range = sizeof(UboViewProjection);
-
-		VkWriteDescriptorSet vpSetWrite = {};
-		vpSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		vpSetWrite.dstSet = m_UniformDescriptorSets[i];
-		vpSetWrite.dstBinding = 0;
-		vpSetWrite.dstArrayElement = 0;
-		vpSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		vpSetWrite.descriptorCount = 1;
-		vpSetWrite.pBufferInfo = &vpDescriptorBufferInfo;
-
-		const std::array<VkWriteDescriptorSet, 1> setWrites = { vpSetWrite };
-
-		vkUpdateDescriptorSets(m_Device->GetHandle(), static_cast<u32>(setWrites.size()), setWrites.data(), 0, nullptr);
-	}
-}
+	// Format changes are rare, so waiting for idle is simpler than retiring render pass and pipelines through deletion queue.
+	m_Device->WaitIdle();
 
-void vge::Renderer::UpdateInputDescriptorSet()
-{
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+	for (Pipeline& pipeline : m_Pipelines)
 	{
-		VkDescriptorImageInfo colorInputDescriptorImageInfo = {};
-		colorInputDescriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		colorInputDescriptorImageInfo.imageView = m_ColorAttachments[i].View;
-		colorInputDescriptorImageInfo.sampler = VK_NULL_HANDLE;
-
-		VkWriteDescriptorSet colorSetWrite = {};
-		colorSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		colorSetWrite.dstSet = m_InputDescriptorSets[i];
-		colorSetWrite.dstBinding = 0;
-		colorSetWrite.dstArrayElement = 0;
-		colorSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		colorSetWrite.descriptorCount = 1;
-		colorSetWrite.pImageInfo = &colorInputDescriptorImageInfo;
-
-		VkDescriptorImageInfo depthInputDescriptorImageInfo = {};
-		depthInputDescriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		depthInputDescriptorImageInfo.imageView = m_DepthAttachments[i].View;
-		depthInputDescriptorImageInfo.sampler = VK_NULL_HANDLE;
-
-		VkWriteDescriptorSet depthSetWrite = {};
-		depthSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		depthSetWrite.dstSet = m_InputDescriptorSets[i];
-		depthSetWrite.dstBinding = 1;
-		depthSetWrite.dstArrayElement = 0;
-		depthSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		depthSetWrite.descriptorCount = 1;
-		depthSetWrite.pImageInfo = &depthInputDescriptorImageInfo;
-
-		const std::array<VkWriteDescriptorSet, 2> setWrites = { colorSetWrite, depthSetWrite };
-
-		vkUpdateDescriptorSets(m_Device->GetHandle(), static_cast<u32>(setWrites.size()), setWrites.data(), 0, nullptr);
+		pipeline.Destroy();
 	}
-}
+	m_Pipelines.clear();
 
-void vge::Renderer::UpdateUniformBuffers(u32 ImageIndex)
-{
-	m_VpUniformBuffers[ImageIndex].TransferToGpuMemory(&m_UboViewProjection, sizeof(UboViewProjection));
+	m_RenderGraph.Destroy();
+
+	// Enabled shader features are kept, as pipeline count does not change.
+	CreateRenderGraph();
+	CreatePipelines();
 }
 
 void vge::Renderer::RecreateSwapchain()
 {
+	// Nothing can be presented to minimized window.
 	m_Device->WaitWindowSizeless();
-	m_Device->WaitIdle();
 
-	// Destruction.
-	DestroyRenderPassColorAttachments();
-	DestroyRenderPassDepthAttachments();
-	m_Swapchain->Destroy(m_SwapchainRecreateInfo.get());
-	m_Swapchain.reset(new Swapchain(m_Device));
+	// No idle wait, old swapchain and resources using it are retired once frames in flight complete.
+	const VkExtent2D oldExtent = m_Swapchain->GetExtent();
+	const VkFormat oldFormat = m_Swapchain->GetImageFormat();
 
-	// Creation.
-	m_Swapchain->Initialize(m_SwapchainRecreateInfo.get());
-	CreateRenderPassColorAttachments();
-	CreateRenderPassDepthAttachments();
-	CreateFramebuffers();
+	m_Swapchain->Destroy(m_SwapchainRecreateInfo.get(), &m_DeletionQueue);
+	m_Swapchain.reset(new Swapchain(m_Device));
+	m_Swapchain->Initialize(m_SwapchainRecreateInfo.get(), &m_DeletionQueue);
 
-	if (m_Swapchain->GetFramebufferCount() != m_CommandBuffers.size())
+	// Render pass and pipelines depend on backbuffer format. Frame contexts depend on neither format nor size, graph images only on size.
+	const VkExtent2D extent = m_Swapchain->GetExtent();
+	if (m_Swapchain->GetImageFormat() != oldFormat)
 	{
-		FreeCommandBuffers();
-		AllocateCommandBuffers();
+		LOG(Warning, "Swapchain format changed, render pass and pipelines are recreated.");
+		RecreateRenderGraph();
 	}
-
-	UpdateInputDescriptorSet();
-}
-
-void vge::Renderer::FreeCommandBuffers()
-{
-	for (CommandBuffer& cmd : m_CommandBuffers)
+	else if (extent.width != oldExtent.width || extent.height != oldExtent.height)
 	{
-		cmd.Free();
+		m_RenderGraph.DestroyImages(&m_DeletionQueue);
+		CreateRenderGraphImages();
 	}
 
-	m_CommandBuffers.clear();
+	CreateFramebuffers();
+
+	// Present to old swapchain may not have waited for its semaphore, so new ones are used.
+	DestroyRenderFinishedSemaphores(&m_DeletionQueue);
+	CreateRenderFinishedSemaphores();
+
+	// Present ids belong to old swapchain and cannot be waited for on new one.
+	m_PendingPresents.clear();
 }
 
-void vge::Renderer::DestroyRenderPassColorAttachments()
+vge::i32 vge::Renderer::CreateTexture(const char* filename)
 {
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
-	{
-		vkDestroyImageView(m_Device->GetHandle(), m_ColorAttachments[i].View, nullptr);
-		m_ColorAttachments[i].Image.Destroy();
-	}
+	return AddTexture(filename, {});
 }
 
-void vge::Renderer::DestroyRenderPassDepthAttachments()
+void vge::Renderer::CreateTextures(const std::vector<std::string>& filenames, std::vector<i32>& outIds)
 {
-	for (size_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+	std::vector<Image> images;
+	Image::CreateForTextures(m_Device, filenames, images);
+
+	outIds.resize(filenames.size());
+
+	for (size_t i = 0; i < filenames.size(); ++i)
 	{
-		vkDestroyImageView(m_Device->GetHandle(), m_DepthAttachments[i].View, nullptr);
-		m_DepthAttachments[i].Image.Destroy();
+		outIds[i] = AddTexture(filenames[i].c_str(), images[i]);
 	}
 }
 
-vge::i32 vge::Renderer::CreateTexture(const char* filename)
+vge::i32 vge::Renderer::AddTexture(const char* filename, const Image& image)
 {
 	TextureCreateInfo texCreateInfo = {};
 	texCreateInfo.Id = static_cast<i32>(m_Textures.size());
 	texCreateInfo.Filename = filename;
 	texCreateInfo.Device = m_Device;
 	texCreateInfo.Sampler = m_TextureSampler;
-	texCreateInfo.DescriptorPool = m_SamplerDescriptorPool;
-	texCreateInfo.DescriptorLayout = m_Pipelines[0].GetShader(ShaderStage::Fragment)->GetDescriptorSetLayout().Handle; // first pipeline is used to render everything
+	texCreateInfo.Image = image;
+
+	if (IsBindless())
+	{
+		ENSURE_MSG(texCreateInfo.Id < static_cast<i32>(GMaxBindlessDescriptors), "Bindless texture array is full.");
+	}
+	else
+	{
+		texCreateInfo.DescriptorAllocator = &m_DescriptorAllocator;
+		texCreateInfo.DescriptorLayout = GetPassPipeline(m_ScenePass).GetDescriptorSetLayout(1); // scene pipeline is used to render everything
+	}
 
 	Texture texture = Texture::Create(texCreateInfo);
 	m_Textures.push_back(texture);
 
+	if (IsBindless())
+	{
+		UpdateBindlessDescriptorSet(texture);
+	}
+
 	return texture.GetId();
 }
 
@@ -7,7 +7,10 @@
 #include "Texture.h"
 #include "Swapchain.h"
 #include "CommandBuffer.h"
-#include "RenderPass.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+#include "FrameContext.h"
+#include "DeletionQueue.h"
 
 namespace vge
 {
@@ -16,10 +19,17 @@ namespace vge
 
 	inline class Renderer* GRenderer = nullptr;
 	
-	inline constexpr i32 GMaxDrawFrames = 3;
+	inline constexpr i32 GMaxDrawFramesLimit = 4;
+	inline			 i32 GMaxDrawFrames = 3;	// frames in flight, taken from application specs on renderer initialization
 	inline			 i32 GRenderFrame  = 0;
 
-	inline constexpr i32 GMaxSceneObjects = 32;
+	// Presents which were not retired yet are dropped above this count, e.g. if they never complete for out of date swapchain.
+	inline constexpr size_t GMaxPendingPresents = 16;
+	// Low latency wait for previous present is bounded, so minimized or occluded window does not block loop forever.
+	inline constexpr u64 GPresentWaitTimeout = 100'000'000; // 100ms
+
+	// Max indexed indirect draws (visible meshlets) per frame.
+	inline constexpr u32 GMaxIndirectDraws = 65536;
 
 	struct UboViewProjection
 	{
@@ -27,6 +37,23 @@ namespace vge
 		glm::mat4 View;			// where and from what angle camera is viewing
 	};
 
+	// Input to photon latency, from input sampling for frame to its presentation (gpu completion if present wait is not supported).
+	struct FrameLatencyStats
+	{
+		u64 FrameCount = 0;
+		f64 TotalMs = 0.0;
+		f64 MaxMs = 0.0;
+
+		inline f64 GetAverageMs() const { return FrameCount > 0 ? TotalMs / static_cast<f64>(FrameCount) : 0.0; }
+	};
+
+	enum class PipelineInitMode : u8
+	{
+		Create,		// first creation with all layouts
+		Reload,		// recreate after shaders were recompiled
+		Variant,	// switch to variant with other features
+	};
+
 	class Renderer final
 	{
 	public:
@@ -40,26 +67,65 @@ namespace vge
 
 		CommandBuffer* BeginFrame();
 		void EndFrame();
+		// Call before input is sampled. Measures latency of presented frames and in low latency mode
+		// waits until previous frame is presented, so input is sampled as late as possible and frames do not queue up.
+		void WaitFrameLatency();
 
 		// TODO: 1 mesh can have only 1 texture for now.
 		i32 CreateTexture(const char* filename);
+		// Load textures in parallel, outIds are filled in same order as filenames.
+		void CreateTextures(const std::vector<std::string>& filenames, std::vector<i32>& outIds);
 		i32 CreateModel(const char* filename);
 
 		void RecreateSwapchain();
-
-		inline CommandBuffer* GetCurrentCmdBuffer() { return &m_CommandBuffers[m_Swapchain->GetCurrentImageIndex()]; }
-		inline FrameBuffer* GetCurrentFrameBuffer() { return m_Swapchain->GetFramebuffer(m_Swapchain->GetCurrentImageIndex()); }
+		// Reload pipelines using any of given recompiled shaders (spv filenames).
+		void ReloadPipelines(const std::vector<const char*>& shaderFilenames);
+		// Switch pipeline of given subpass to variant with given features, variant is created on first use.
+		void SetPipelineFeatures(u32 subpassIdx, ShaderFeatures features);
+		inline ShaderFeatures GetPipelineFeatures(u32 subpassIdx) const { return subpassIdx < m_PipelineFeatures.size() ? m_PipelineFeatures[subpassIdx] : 0; }
+		inline u32 GetPipelineCount() const { return static_cast<u32>(m_Pipelines.size()); }
+		// Flip feature in pipelines of all subpasses, shaders not declaring it are unaffected.
+		void ToggleShaderFeature(ShaderFeature feature);
+		// Swapchain is recreated with new mode, fifo is used if it is not supported.
+		void SetPresentMode(PresentMode mode);
+		inline void SetLowLatency(bool enabled) { m_LowLatency = enabled; }
+		inline bool IsLowLatency() const { return m_LowLatency; }
+		inline const FrameLatencyStats& GetLatencyStats() const { return m_LatencyStats; }
+
+		// Stats of every submitted frame are kept until popped, gpu time is measured if timestamps are supported.
+		inline void SetFrameStatsEnabled(bool enabled) { m_CollectFrameStats = enabled; }
+		// Stats of retired frames in submission order.
+		bool PopRetiredFrameStats(FrameStats& outStats);
+		// Wait for all frames in flight, so stats of every submitted frame can be popped.
+		void RetireAllFrames();
+		// Begin is written before render pass, end after it.
+		void WriteFrameTimestamp(CommandBuffer* cmd, FrameTimestamp timestamp);
+
+		inline CommandBuffer* GetCurrentCmdBuffer() { return GetCurrentFrame()->GetCmdBuffer(); }
+		inline FrameBuffer* GetCurrentFrameBuffer() { return m_Swapchain->GetFramebuffer(GRenderFrame * m_Swapchain->GetImageCount() + m_Swapchain->GetCurrentImageIndex()); }
 		inline const Swapchain* GetSwapchain() const { return m_Swapchain.get(); }
+		// Rendering to offscreen images without window surface and present.
+		inline bool IsHeadless() const { return m_Swapchain->IsOffscreen(); }
 		inline VkExtent2D GetSwapchainExtent() const { return m_Swapchain->GetExtent(); }
 		inline f32 GetSwapchainAspectRatio() const { return m_Swapchain->GetAspectRatio(); }
-		inline VkDescriptorSet GetCurrentInputDescriptorSet() const { return m_InputDescriptorSets[m_Swapchain->GetCurrentImageIndex()]; }
-		inline VkDescriptorSet GetCurrentUniformDescriptorSet() const { return m_UniformDescriptorSets[m_Swapchain->GetCurrentImageIndex()]; }
-		inline const RenderPass* GetRenderPass() const { return &m_RenderPass; }
+		inline VkDescriptorSet GetCurrentInputDescriptorSet() const { return m_Frames[GRenderFrame].GetInputDescriptorSet(); }
+		inline VkDescriptorSet GetCurrentUniformDescriptorSet() const { return m_Frames[GRenderFrame].GetUniformDescriptorSet(); }
+		// Textures are addressed by id in single descriptor array instead of own descriptor sets.
+		inline bool IsBindless() const { return m_Device->IsBindlessSupported(); }
+		inline VkDescriptorSet GetBindlessDescriptorSet() const { return m_BindlessDescriptorSet; }
+		inline const DescriptorAllocator* GetDescriptorAllocator() const { return &m_DescriptorAllocator; }
+		inline const RenderPass* GetRenderPass() const { return m_RenderGraph.GetRenderPass(); }
+		inline IndirectBuffer* GetCurrentIndirectBuffer() { return GetCurrentFrame()->GetIndirectBuffer(); }
+		inline FrameContext* GetCurrentFrame() { return &m_Frames[GRenderFrame]; }
+		// Value signaled on frame timeline by last submitted frame.
+		inline u64 GetFrameTimelineValue() const { return m_FrameTimelineValue; }
+		inline VkSemaphore GetFrameTimeline() const { return m_FrameTimeline; }
+		// Resources pushed here are destroyed once frames in flight which could use them retire.
+		inline DeletionQueue* GetDeletionQueue() { return &m_DeletionQueue; }
 
 		inline void SetView(const glm::mat4& view) { m_UboViewProjection.View = view; }
 		inline void SetProjection(const glm::mat4& projection) { m_UboViewProjection.Projection = projection; }
-		inline void UpdateModelMatrix(i32 id, glm::mat4 model) { ASSERT(id < m_Models.size()); m_Models[id].SetModelMatrix(model); }
-		inline void UpdateUniformBuffers() { UpdateUniformBuffers(m_Swapchain->GetCurrentImageIndex()); }
+		inline void UpdateUniformBuffers() { GetCurrentFrame()->GetUniformBuffer()->TransferToGpuMemory(&m_UboViewProjection, sizeof(UboViewProjection)); }
 
 		inline Model* FindModel(i32 id) { return id < m_Models.size() ? &m_Models[id] : nullptr; }
 		inline Texture* FindTexture(i32 id) { return id < m_Textures.size() ? &m_Textures[id] : nullptr; }
@@ -77,60 +143,82 @@ namespace vge
 
 		VkSampler m_TextureSampler = VK_NULL_HANDLE;
 
-		std::vector<VkSemaphore> m_ImageAvailableSemas = {};
-		std::vector<VkSemaphore> m_RenderFinishedSemas = {};
-		std::vector<VkFence> m_DrawFences = {};
-
-		std::vector<CommandBuffer> m_CommandBuffers = {};
-
-		// TODO: create separate structure for subpass data (images, view, memory, format).
-
-		VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
-		VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
-		std::vector<RenderPassAttachment> m_ColorAttachments = {};
-		std::vector<RenderPassAttachment> m_DepthAttachments = {};
-
-		VkDescriptorPool m_UniformDescriptorPool = VK_NULL_HANDLE;	// uniform data
-		VkDescriptorPool m_SamplerDescriptorPool = VK_NULL_HANDLE;	// texture data (not neccessary to create separate pool)
-		VkDescriptorPool m_InputDescriptorPool = VK_NULL_HANDLE;	// input data for separate pipeline and 2 subpass
-
-		std::vector<VkDescriptorSet> m_UniformDescriptorSets = {};
-		std::vector<VkDescriptorSet> m_InputDescriptorSets = {};
-
-		VkPushConstantRange m_PushConstantRange = {};
-
-		std::vector<Buffer> m_VpUniformBuffers = {};
-
-		// Amount of subpasses in render pass and pipelines in it.
-		u32 m_SubpassCount = 2;
-		RenderPass m_RenderPass = {};
+		// Frames in flight are paced by single timeline semaphore, each frame waits for value of its previous submit.
+		std::vector<FrameContext> m_Frames = {};
+		VkSemaphore m_FrameTimeline = VK_NULL_HANDLE;
+		u64 m_FrameTimelineValue = 0;
+		std::vector<VkSemaphore> m_RenderFinishedSemas = {};	// per swapchain image, as presentation engine holds it until image is reacquired
+		DeletionQueue m_DeletionQueue = {};
+
+		struct PendingPresent
+		{
+			u64 PresentId = 0;		// 0 if present wait is not supported
+			u64 TimelineValue = 0;
+			f64 InputTime = 0.0;
+		};
+
+		std::deque<PendingPresent> m_PendingPresents = {};	// ordered by submission
+		u64 m_PresentId = 0;
+		f64 m_InputSampleTime = 0.0;
+		bool m_LowLatency = false;
+		FrameLatencyStats m_LatencyStats = {};
+
+		bool m_CollectFrameStats = false;
+		std::deque<FrameStats> m_RetiredFrameStats = {};
+
+		u32 m_ReadbackInterval = 0;				// headless only, every n-th frame is written to readback directory
+		std::string m_ReadbackDirectory = {};
+
+		DescriptorAllocator m_DescriptorAllocator = {};				// sets living until renderer destruction
+		VkDescriptorPool m_BindlessDescriptorPool = VK_NULL_HANDLE;	// texture array, update after bind pool with single set
+
+		VkDescriptorSet m_BindlessDescriptorSet = VK_NULL_HANDLE;
+
+		// Render pass is compiled from graph, pipelines are indexed by subpass.
+		RenderGraph m_RenderGraph = {};
+		RenderGraphHandle m_BackbufferImage = INDEX_NONE;
+		RenderGraphHandle m_SceneColorImage = INDEX_NONE;
+		RenderGraphHandle m_SceneDepthImage = INDEX_NONE;
+		RenderGraphHandle m_ScenePass = INDEX_NONE;
+		RenderGraphHandle m_CompositionPass = INDEX_NONE;
 		std::vector<Pipeline> m_Pipelines;
+		std::vector<ShaderFeatures> m_PipelineFeatures;
 
 	private:
 		void CreateSwapchain();
-		void CreateRenderPassColorAttachments();
-		void CreateRenderPassDepthAttachments();
-		void CreateRenderPass();
-		void CreatePushConstantRange();
+		void CreateRenderGraph();
+		void CreateRenderGraphImages();
+		// Render pass with images and pipelines built again for current swapchain format.
+		void RecreateRenderGraph();
 		void CreatePipelines();
+		void InitializePipeline(u32 subpassIdx, PipelineInitMode mode);
 		void CreateFramebuffers();
-		void AllocateCommandBuffers();
+		void CreateFrameContexts();
 		void CreateTextureSampler();
-		void CreateUniformBuffers();
-		void CreateDescriptorPools();
+		void CreateDescriptorAllocators();
 		void CreateDescriptorSets();
 		void CreateSyncObjects();
+		void CreateRenderFinishedSemaphores();
+		void DestroyRenderFinishedSemaphores(DeletionQueue* deletionQueue = nullptr);
+
+		// Uniform and input sets of frame, its transient allocator must have been reset.
+		void AllocateFrameDescriptorSets(FrameContext* frame);
+		void AllocateBindlessDescriptorSet();
+
+		void Present(u32 imageIndex, const PendingPresent& present);
+		bool WaitPresent(const PendingPresent& present, u64 timeout) const;
 
-		void AllocateUniformDescriptorSet();
-		void AllocateInputDescriptorSet();
-		void UpdateUniformDescriptorSet();
-		void UpdateInputDescriptorSet();
+		// Copy current offscreen image to readback buffer of frame, recorded after frame render pass.
+		void RecordReadback(FrameContext* frame, u32 imageIndex);
+		// Write image copied by retired frame to readback directory.
+		void SaveReadback(FrameContext* frame);
+		void RetireFrameStats(FrameContext* frame);
+		void UpdateBindlessDescriptorSet(const Texture& texture);
 
-		void UpdateUniformBuffers(u32 ImageIndex);
+		// Create texture from file or already created image and make it available for shaders.
+		i32 AddTexture(const char* filename, const Image& image);
 
-		void FreeCommandBuffers();
-		void DestroyRenderPassColorAttachments();
-		void DestroyRenderPassDepthAttachments();
+		inline Pipeline& GetPassPipeline(RenderGraphHandle pass) { return m_Pipelines[m_RenderGraph.GetSubpassIndex(pass)]; }
 	};
 
 	inline Renderer* CreateRenderer(Device* device)
@@ -42,29 +42,41 @@ void vge::Shader::Initialize(const ShaderCreateInfo& data)
 	
 	CreateModule(data.SpirvChar);
 
-	if (data.DescriptorSetLayoutBindings.size() > 0)
-	{
-#if DEBUG
-		VerifyBindingIndices(data.DescriptorSetLayoutBindings);
-#endif
-
-		CreateDescriptorSetLayout(data.DescriptorSetLayoutBindings);
-	}
+	const bool reflected = spirv::Reflect(*data.SpirvChar, m_StageFlags, m_Reflection);
+	ENSURE_MSG(reflected, "Failed to reflect SPIR-V of shader, descriptor and push constant layout would be empty.");
 }
 
 void vge::Shader::Destroy()
 {
 	vkDestroyShaderModule(m_Device->GetHandle(), m_Module, nullptr);
-	vkDestroyDescriptorSetLayout(m_Device->GetHandle(), m_DescriptorLayout.Handle, nullptr);
 }
 
-VkPipelineShaderStageCreateInfo vge::Shader::GetStageCreateInfo() const
+bool vge::Shader::ReloadModule(const std::vector<char>* SpirvChar)
+{
+	ShaderReflection reflection = {};
+	if (!spirv::Reflect(*SpirvChar, m_StageFlags, reflection))
+	{
+		LOG(Error, "Failed to reflect reloaded SPIR-V, old shader module is kept.");
+		return false;
+	}
+
+	vkDestroyShaderModule(m_Device->GetHandle(), m_Module, nullptr);
+	m_Module = VK_NULL_HANDLE;
+
+	CreateModule(SpirvChar);
+	m_Reflection = std::move(reflection);
+
+	return true;
+}
+
+VkPipelineShaderStageCreateInfo vge::Shader::GetStageCreateInfo(const VkSpecializationInfo* specialization /*= nullptr*/) const
 {
 	VkPipelineShaderStageCreateInfo stageCreateInfo = {};
 	stageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	stageCreateInfo.stage = m_StageFlags;
 	stageCreateInfo.module = m_Module;
 	stageCreateInfo.pName = DefaultEntryName;
+	stageCreateInfo.pSpecializationInfo = specialization;
 
 	return stageCreateInfo;
 }
@@ -78,29 +90,3 @@ void vge::Shader::CreateModule(const std::vector<char>* SpirvInt8)
 
 	VK_ENSURE(vkCreateShaderModule(m_Device->GetHandle(), &createInfo, nullptr, &m_Module));
 }
-
-void vge::Shader::CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
-{
-	m_DescriptorLayout.Bindings = bindings;
-
-	VkDescriptorSetLayoutCreateInfo uniformLayoutCreateInfo = {};
-	uniformLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	uniformLayoutCreateInfo.bindingCount = static_cast<u32>(bindings.size());
-	uniformLayoutCreateInfo.pBindings = bindings.data();
-
-	VK_ENSURE(vkCreateDescriptorSetLayout(m_Device->GetHandle(), &uniformLayoutCreateInfo, nullptr, &m_DescriptorLayout.Handle))
-}
-
-#if DEBUG
-void vge::Shader::VerifyBindingIndices(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
-{
-	std::vector<u32> bindingIndices;
-	for (const VkDescriptorSetLayoutBinding& binding : bindings)
-	{
-		bindingIndices.push_back(binding.binding);
-	}
-
-	std::unordered_set<u32> uniqueBindingIndices(std::cbegin(bindingIndices), std::cend(bindingIndices));
-	ENSURE_MSG(uniqueBindingIndices.size() == bindingIndices.size(), "Descriptor set layout bindings must have unique indices.");
-}
-#endif
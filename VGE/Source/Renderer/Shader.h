@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "ShaderReflection.h"
 
 namespace vge 
 {
@@ -16,18 +17,11 @@ namespace vge
 		Count = 2
 	};
 
-	struct DescriptorSetLayout
-	{
-		VkDescriptorSetLayout Handle = VK_NULL_HANDLE;
-		std::vector<VkDescriptorSetLayoutBinding> Bindings = {};
-	};
-
 	struct ShaderCreateInfo
 	{
 		vge::Device* Device = nullptr;
 		VkShaderStageFlagBits StageFlags = VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
 		std::vector<char>* SpirvChar = {};
-		std::vector<VkDescriptorSetLayoutBinding> DescriptorSetLayoutBindings = {};
 	};
 
 	class Shader
@@ -44,29 +38,26 @@ namespace vge
 		void Initialize(const ShaderCreateInfo& data);
 		void Destroy();
 
-		// NOTE: Descriptor layout is not crucial for shader to be valid as it may use its own specific data.
+		// Replace shader module and its reflection, pipeline layout is expected to stay compatible.
+		// Returns false and keeps old module if new code can not be reflected.
+		bool ReloadModule(const std::vector<char>* SpirvChar);
+
 		inline bool IsValid() const { return m_Device && m_Module && m_Stage != ShaderStage::None && m_StageFlags != VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM; }
 		inline ShaderStage GetStage() const { return m_Stage; }
 		inline VkShaderModule GetModule() const { return m_Module; }
 		inline VkShaderStageFlagBits GetStageFlags() const { return m_StageFlags; }
-		inline const DescriptorSetLayout& GetDescriptorSetLayout() const { return m_DescriptorLayout; }
+		inline const ShaderReflection& GetReflection() const { return m_Reflection; }
 
-		VkPipelineShaderStageCreateInfo GetStageCreateInfo() const;
+		VkPipelineShaderStageCreateInfo GetStageCreateInfo(const VkSpecializationInfo* specialization = nullptr) const;
 
 	private:
 		void CreateModule(const std::vector<char>* SpirvInt8);
-		void CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
 
 	private:
 		const Device* m_Device = nullptr;
 		ShaderStage m_Stage = ShaderStage::None;
 		VkShaderModule m_Module = VK_NULL_HANDLE;
 		VkShaderStageFlagBits m_StageFlags = VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
-		DescriptorSetLayout m_DescriptorLayout = {};
-
-#if DEBUG
-	private:
-		void VerifyBindingIndices(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
-#endif
+		ShaderReflection m_Reflection = {};
 	};
 }
@@ -0,0 +1,100 @@
+#include "ShaderCompiler.h"
+
+namespace
+{
+	// FNV-1a hash of file content, 0 if file can not be read.
+	vge::u64 HashFile(const char* filename)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.is_open())
+		{
+			return 0;
+		}
+
+		vge::u64 hash = 14695981039346656037ull;
+
+		char buffer[4096];
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+		{
+			for (std::streamsize i = 0; i < file.gcount(); ++i)
+			{
+				hash ^= static_cast<vge::u8>(buffer[i]);
+				hash *= 1099511628211ull;
+			}
+		}
+
+		return hash;
+	}
+
+	std::filesystem::file_time_type GetWriteTime(const char* filename)
+	{
+		std::error_code error;
+		const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filename, error);
+		return error ? std::filesystem::file_time_type() : writeTime;
+	}
+}
+
+bool vge::CompileShader(const ShaderBuild& build)
+{
+	std::string compiler = "glslangValidator";
+#pragma warning(suppress : 4996)
+	if (const char* sdkPath = std::getenv("VULKAN_SDK"))
+	{
+		compiler = std::string("\"") + sdkPath + "/bin/glslangValidator\"";
+	}
+
+	const std::string command = compiler + " -V " + build.Defines + " -o " + build.Output + " " + build.Source;
+
+	if (std::system(command.c_str()) != 0)
+	{
+		LOG(Error, "Failed to compile shader %s to %s.", build.Source, build.Output);
+		return false;
+	}
+
+	LOG(Log, "Shader %s compiled to %s.", build.Source, build.Output);
+	return true;
+}
+
+void vge::ShaderHotReload::Initialize()
+{
+	m_Sources.clear();
+
+	for (const ShaderBuild& build : GShaderBuilds)
+	{
+		WatchedSource& source = m_Sources[build.Source];
+		source.WriteTime = GetWriteTime(build.Source);
+		source.Hash = HashFile(build.Source);
+	}
+
+	LOG(Log, "Shader hot reload is watching %zu sources.", m_Sources.size());
+}
+
+void vge::ShaderHotReload::Poll(std::vector<const char*>& outRecompiledOutputs)
+{
+	for (auto& [filename, source] : m_Sources)
+	{
+		const std::filesystem::file_time_type writeTime = GetWriteTime(filename.c_str());
+		if (writeTime == source.WriteTime)
+		{
+			continue;
+		}
+
+		source.WriteTime = writeTime;
+
+		const u64 hash = HashFile(filename.c_str());
+		if (hash == 0 || hash == source.Hash)
+		{
+			continue;
+		}
+
+		source.Hash = hash;
+
+		for (const ShaderBuild& build : GShaderBuilds)
+		{
+			if (filename == build.Source && CompileShader(build))
+			{
+				outRecompiledOutputs.push_back(build.Output);
+			}
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Common.h"
+#include <filesystem>
+
+namespace vge
+{
+	// How often shader sources are checked for changes in hot reload mode.
+	inline constexpr f32 GShaderHotReloadInterval = 0.5f;
+
+	// Offline shader build step. Shaders are compiled at build time by VGE.vcxproj custom build
+	// (or compile_shaders.bat/.sh), keep those in sync with this list.
+	struct ShaderBuild
+	{
+		const char* Source = nullptr;
+		const char* Output = nullptr;
+		const char* Defines = "";
+	};
+
+	inline constexpr ShaderBuild GShaderBuilds[] =
+	{
+		{ "Shaders/first.vert", "Shaders/Bin/first_vert.spv", "" },
+		{ "Shaders/first.vert", "Shaders/Bin/first_normal_vert.spv", "-DVERTEX_NORMAL" },
+		{ "Shaders/first.vert", "Shaders/Bin/first_normal_float_vert.spv", "-DVERTEX_NORMAL -DVERTEX_NORMAL_FLOAT" },
+		{ "Shaders/first.frag", "Shaders/Bin/first_frag.spv", "" },
+		{ "Shaders/first.frag", "Shaders/Bin/first_bindless_frag.spv", "-DBINDLESS" },
+		{ "Shaders/second.vert", "Shaders/Bin/second_vert.spv", "" },
+		{ "Shaders/second.frag", "Shaders/Bin/second_frag.spv", "" },
+	};
+
+	// Compile shader with glslangValidator from VULKAN_SDK (or PATH), used by hot reload only.
+	bool CompileShader(const ShaderBuild& build);
+
+	// Polls modification time of shader sources and recompiles changed ones.
+	// Content hash filters out saves without actual changes.
+	class ShaderHotReload
+	{
+	public:
+		ShaderHotReload() = default;
+
+		void Initialize();
+
+		// Outputs (spv filenames) of successfully recompiled shaders are appended.
+		void Poll(std::vector<const char*>& outRecompiledOutputs);
+
+	private:
+		struct WatchedSource
+		{
+			std::filesystem::file_time_type WriteTime = {};
+			u64 Hash = 0;
+		};
+
+		std::unordered_map<std::string, WatchedSource> m_Sources = {};
+	};
+}
@@ -0,0 +1,628 @@
+#include "ShaderReflection.h"
+
+namespace vge
+{
+	namespace
+	{
+		// Subset of SPIR-V specification enums used for reflection.
+		constexpr u32 SpvMagicNumber = 0x07230203;
+		constexpr u32 SpvHeaderWordCount = 5;
+
+		constexpr u32 SpvOpDecorate = 71;
+		constexpr u32 SpvOpMemberDecorate = 72;
+		constexpr u32 SpvOpTypeBool = 20;
+		constexpr u32 SpvOpTypeInt = 21;
+		constexpr u32 SpvOpTypeFloat = 22;
+		constexpr u32 SpvOpTypeVector = 23;
+		constexpr u32 SpvOpTypeMatrix = 24;
+		constexpr u32 SpvOpTypeImage = 25;
+		constexpr u32 SpvOpTypeSampler = 26;
+		constexpr u32 SpvOpTypeSampledImage = 27;
+		constexpr u32 SpvOpTypeArray = 28;
+		constexpr u32 SpvOpTypeRuntimeArray = 29;
+		constexpr u32 SpvOpTypeStruct = 30;
+		constexpr u32 SpvOpTypePointer = 32;
+		constexpr u32 SpvOpConstant = 43;
+		constexpr u32 SpvOpSpecConstant = 50;
+		constexpr u32 SpvOpVariable = 59;
+
+		constexpr u32 SpvDecorationSpecId = 1;
+		constexpr u32 SpvDecorationBlock = 2;
+		constexpr u32 SpvDecorationBufferBlock = 3;
+		constexpr u32 SpvDecorationArrayStride = 6;
+		constexpr u32 SpvDecorationMatrixStride = 7;
+		constexpr u32 SpvDecorationBuiltIn = 11;
+		constexpr u32 SpvDecorationLocation = 30;
+		constexpr u32 SpvDecorationBinding = 33;
+		constexpr u32 SpvDecorationDescriptorSet = 34;
+		constexpr u32 SpvDecorationOffset = 35;
+
+		constexpr u32 SpvStorageClassUniformConstant = 0;
+		constexpr u32 SpvStorageClassInput = 1;
+		constexpr u32 SpvStorageClassUniform = 2;
+		constexpr u32 SpvStorageClassPushConstant = 9;
+		constexpr u32 SpvStorageClassStorageBuffer = 12;
+
+		constexpr u32 SpvDimBuffer = 5;
+		constexpr u32 SpvDimSubpassData = 6;
+
+		// Valid modules nest types far less, deeper chains are cycles.
+		constexpr u32 SpvMaxTypeDepth = 64;
+
+		struct SpvMember
+		{
+			u32 TypeId = 0;
+			u32 Offset = 0;
+			u32 MatrixStride = 0;
+		};
+
+		// Everything known about single result id, fields meaning depends on opcode.
+		struct SpvId
+		{
+			u32 Opcode = 0;
+			u32 TypeId = 0;			// pointee, element, component or column type
+			u32 StorageClass = 0;
+			u32 Width = 0;			// scalar width in bits, vector component count, matrix column count
+			u32 LengthId = 0;		// array length constant
+			u32 Value = 0;			// constant value
+			u32 Dim = 0;			// image dimensionality
+			u32 Sampled = 0;		// image usage, 1 - sampled, 2 - storage
+			u32 Set = INDEX_NONE;
+			u32 Binding = INDEX_NONE;
+			u32 Location = INDEX_NONE;
+			u32 ArrayStride = 0;
+			bool Block = false;
+			bool BufferBlock = false;
+			bool BuiltIn = false;
+			std::vector<SpvMember> Members = {};
+		};
+
+		inline bool IsValidId(const std::vector<SpvId>& ids, u32 id) { return id < ids.size(); }
+
+		// 0 if size is unknown, type id is invalid or types form a cycle.
+		u32 GetTypeSize(const std::vector<SpvId>& ids, u32 typeId, u32 matrixStride = 0, u32 depth = 0)
+		{
+			if (!IsValidId(ids, typeId) || depth > SpvMaxTypeDepth)
+			{
+				return 0;
+			}
+
+			const SpvId& type = ids[typeId];
+
+			switch (type.Opcode)
+			{
+			case SpvOpTypeBool:
+				return 4;
+
+			case SpvOpTypeInt:
+			case SpvOpTypeFloat:
+				return type.Width / 8;
+
+			case SpvOpTypeVector:
+				return type.Width * GetTypeSize(ids, type.TypeId, 0, depth + 1);
+
+			case SpvOpTypeMatrix:
+				return type.Width * (matrixStride > 0 ? matrixStride : GetTypeSize(ids, type.TypeId, 0, depth + 1));
+
+			case SpvOpTypeArray:
+			{
+				if (!IsValidId(ids, type.LengthId))
+				{
+					return 0;
+				}
+
+				const u32 length = ids[type.LengthId].Value;
+				return length * (type.ArrayStride > 0 ? type.ArrayStride : GetTypeSize(ids, type.TypeId, matrixStride, depth + 1));
+			}
+
+			case SpvOpTypeStruct:
+			{
+				u32 size = 0;
+				for (const SpvMember& member : type.Members)
+				{
+					size = std::max(size, member.Offset + GetTypeSize(ids, member.TypeId, member.MatrixStride, depth + 1));
+				}
+				return size;
+			}
+
+			default:
+				return 0;
+			}
+		}
+
+		VkFormat GetVertexInputFormat(const std::vector<SpvId>& ids, u32 typeId)
+		{
+			if (!IsValidId(ids, typeId))
+			{
+				return VK_FORMAT_UNDEFINED;
+			}
+
+			const SpvId& type = ids[typeId];
+			if (type.Opcode == SpvOpTypeVector && !IsValidId(ids, type.TypeId))
+			{
+				return VK_FORMAT_UNDEFINED;
+			}
+
+			const u32 componentCount = type.Opcode == SpvOpTypeVector ? type.Width : 1;
+			const SpvId& component = type.Opcode == SpvOpTypeVector ? ids[type.TypeId] : type;
+
+			if (component.Opcode != SpvOpTypeFloat || component.Width != 32)
+			{
+				return VK_FORMAT_UNDEFINED;
+			}
+
+			switch (componentCount)
+			{
+			case 1: return VK_FORMAT_R32_SFLOAT;
+			case 2: return VK_FORMAT_R32G32_SFLOAT;
+			case 3: return VK_FORMAT_R32G32B32_SFLOAT;
+			case 4: return VK_FORMAT_R32G32B32A32_SFLOAT;
+			default: return VK_FORMAT_UNDEFINED;
+			}
+		}
+
+		// Unwraps arrays of descriptors, returns false if variable is not a descriptor or its type ids are invalid.
+		bool GetDescriptorInfo(const std::vector<SpvId>& ids, u32 storageClass, u32 typeId, VkDescriptorType& outType, u32& outCount)
+		{
+			outCount = 1;
+
+			if (!IsValidId(ids, typeId))
+			{
+				return false;
+			}
+
+			const SpvId* type = &ids[typeId];
+			if (type->Opcode == SpvOpTypeArray)
+			{
+				if (!IsValidId(ids, type->LengthId) || !IsValidId(ids, type->TypeId))
+				{
+					return false;
+				}
+
+				outCount = ids[type->LengthId].Value;
+				type = &ids[type->TypeId];
+			}
+			else if (type->Opcode == SpvOpTypeRuntimeArray)
+			{
+				if (!IsValidId(ids, type->TypeId))
+				{
+					return false;
+				}
+
+				outCount = 0;
+				type = &ids[type->TypeId];
+			}
+
+			switch (storageClass)
+			{
+			case SpvStorageClassUniform:
+				if (type->Opcode != SpvOpTypeStruct)
+				{
+					return false;
+				}
+				outType = type->BufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				return true;
+
+			case SpvStorageClassStorageBuffer:
+				outType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				return true;
+
+			case SpvStorageClassUniformConstant:
+				switch (type->Opcode)
+				{
+				case SpvOpTypeSampler:
+					outType = VK_DESCRIPTOR_TYPE_SAMPLER;
+					return true;
+
+				case SpvOpTypeSampledImage:
+					if (!IsValidId(ids, type->TypeId))
+					{
+						return false;
+					}
+					outType = ids[type->TypeId].Dim == SpvDimBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					return true;
+
+				case SpvOpTypeImage:
+					if (type->Dim == SpvDimSubpassData)
+					{
+						outType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+					}
+					else if (type->Dim == SpvDimBuffer)
+					{
+						outType = type->Sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+					}
+					else
+					{
+						outType = type->Sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+					}
+					return true;
+
+				default:
+					return false;
+				}
+
+			default:
+				return false;
+			}
+		}
+
+		// Words up to the last operand read by reflection, 0 for instructions it skips.
+		u32 GetMinWordCount(u32 opcode)
+		{
+			switch (opcode)
+			{
+			case SpvOpTypeBool:
+			case SpvOpTypeSampler:
+			case SpvOpTypeStruct:
+				return 2;
+
+			case SpvOpDecorate:
+			case SpvOpTypeFloat:
+			case SpvOpTypeSampledImage:
+			case SpvOpTypeRuntimeArray:
+				return 3;
+
+			case SpvOpMemberDecorate:
+			case SpvOpTypeInt:
+			case SpvOpTypeVector:
+			case SpvOpTypeMatrix:
+			case SpvOpTypeArray:
+			case SpvOpTypePointer:
+			case SpvOpConstant:
+			case SpvOpSpecConstant:
+			case SpvOpVariable:
+				return 4;
+
+			case SpvOpTypeImage:
+				return 8;
+
+			default:
+				return 0;
+			}
+		}
+	}
+}
+
+bool vge::spirv::Reflect(const std::vector<char>& code, VkShaderStageFlagBits stage, ShaderReflection& outReflection)
+{
+	outReflection = {};
+
+	const u32* words = reinterpret_cast<const u32*>(code.data());
+	const size_t wordCount = code.size() / sizeof(u32);
+
+	if (wordCount < SpvHeaderWordCount || words[0] != SpvMagicNumber)
+	{
+		LOG(Error, "Failed to reflect shader, invalid SPIR-V header.");
+		return false;
+	}
+
+	const u32 bound = words[3];
+	std::vector<SpvId> ids(bound);
+	std::vector<u32> variables;
+
+	auto isValidId = [bound](u32 id) { return id < bound; };
+
+	// Gather types, constants, decorations and variables in single pass, their order in module does not matter.
+	for (size_t wordIndex = SpvHeaderWordCount; wordIndex < wordCount;)
+	{
+		const u32 opcode = words[wordIndex] & 0xFFFF;
+		const u32 opWordCount = words[wordIndex] >> 16;
+
+		if (opWordCount == 0 || wordIndex + opWordCount > wordCount)
+		{
+			LOG(Error, "Failed to reflect shader, instruction at word %zu is out of bounds.", wordIndex);
+			return false;
+		}
+
+		if (opWordCount < GetMinWordCount(opcode))
+		{
+			LOG(Error, "Failed to reflect shader, instruction %u at word %zu has %u words, at least %u expected.", opcode, wordIndex, opWordCount, GetMinWordCount(opcode));
+			return false;
+		}
+
+		const u32* op = words + wordIndex;
+
+		// Every id operand read below must be declared within module bound.
+		auto validateIds = [&isValidId, op, opcode, wordIndex](std::initializer_list<u32> operandIndices)
+		{
+			for (u32 operandIndex : operandIndices)
+			{
+				if (!isValidId(op[operandIndex]))
+				{
+					LOG(Error, "Failed to reflect shader, instruction %u at word %zu references id %u out of bound.", opcode, wordIndex, op[operandIndex]);
+					return false;
+				}
+			}
+			return true;
+		};
+
+		wordIndex += opWordCount;
+
+		switch (opcode)
+		{
+		case SpvOpDecorate:
+		{
+			if (!validateIds({ 1 }))
+			{
+				return false;
+			}
+
+			SpvId& target = ids[op[1]];
+			const u32 literal = opWordCount > 3 ? op[3] : 0;
+
+			switch (op[2])
+			{
+			case SpvDecorationBlock: target.Block = true; break;
+			case SpvDecorationBufferBlock: target.BufferBlock = true; break;
+			case SpvDecorationArrayStride: target.ArrayStride = literal; break;
+			case SpvDecorationBuiltIn: target.BuiltIn = true; break;
+			case SpvDecorationLocation: target.Location = literal; break;
+			case SpvDecorationBinding: target.Binding = literal; break;
+			case SpvDecorationDescriptorSet: target.Set = literal; break;
+			case SpvDecorationSpecId:
+				if (opWordCount > 3 && literal < 32)
+				{
+					outReflection.SpecConstantIds |= 1u << literal;
+				}
+				break;
+			}
+			break;
+		}
+
+		case SpvOpMemberDecorate:
+		{
+			if (!validateIds({ 1 }))
+			{
+				return false;
+			}
+
+			// Struct can not have more members than module has words.
+			if (op[2] >= wordCount)
+			{
+				LOG(Error, "Failed to reflect shader, member %u decorated at word %zu does not exist.", op[2], wordIndex - opWordCount);
+				return false;
+			}
+
+			const bool memberLiteral = op[3] == SpvDecorationOffset || op[3] == SpvDecorationMatrixStride;
+			if (!memberLiteral)
+			{
+				break;
+			}
+
+			if (opWordCount < 5)
+			{
+				LOG(Error, "Failed to reflect shader, member decoration at word %zu has no literal.", wordIndex - opWordCount);
+				return false;
+			}
+
+			std::vector<SpvMember>& members = ids[op[1]].Members;
+			if (op[2] >= members.size())
+			{
+				members.resize(op[2] + 1);
+			}
+
+			if (op[3] == SpvDecorationOffset)
+			{
+				members[op[2]].Offset = op[4];
+			}
+			else
+			{
+				members[op[2]].MatrixStride = op[4];
+			}
+			break;
+		}
+
+		case SpvOpTypeBool:
+		case SpvOpTypeSampler:
+			if (!validateIds({ 1 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			break;
+
+		case SpvOpTypeInt:
+		case SpvOpTypeFloat:
+			if (!validateIds({ 1 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].Width = op[2];
+			break;
+
+		case SpvOpTypeVector:
+		case SpvOpTypeMatrix:
+			if (!validateIds({ 1, 2 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].TypeId = op[2];
+			ids[op[1]].Width = op[3];
+			break;
+
+		case SpvOpTypeImage:
+			if (!validateIds({ 1, 2 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].TypeId = op[2];
+			ids[op[1]].Dim = op[3];
+			ids[op[1]].Sampled = op[7];
+			break;
+
+		case SpvOpTypeSampledImage:
+		case SpvOpTypeRuntimeArray:
+			if (!validateIds({ 1, 2 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].TypeId = op[2];
+			break;
+
+		case SpvOpTypeArray:
+			if (!validateIds({ 1, 2, 3 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].TypeId = op[2];
+			ids[op[1]].LengthId = op[3];
+			break;
+
+		case SpvOpTypeStruct:
+		{
+			if (!validateIds({ 1 }))
+			{
+				return false;
+			}
+
+			SpvId& type = ids[op[1]];
+			type.Opcode = opcode;
+			if (type.Members.size() < opWordCount - 2)
+			{
+				type.Members.resize(opWordCount - 2);
+			}
+			for (u32 i = 2; i < opWordCount; ++i)
+			{
+				if (!validateIds({ i }))
+				{
+					return false;
+				}
+
+				type.Members[i - 2].TypeId = op[i];
+			}
+			break;
+		}
+
+		case SpvOpTypePointer:
+			if (!validateIds({ 1, 3 }))
+			{
+				return false;
+			}
+
+			ids[op[1]].Opcode = opcode;
+			ids[op[1]].StorageClass = op[2];
+			ids[op[1]].TypeId = op[3];
+			break;
+
+		// Spec constant default value is used for array lengths.
+		case SpvOpConstant:
+		case SpvOpSpecConstant:
+			if (!validateIds({ 1, 2 }))
+			{
+				return false;
+			}
+
+			ids[op[2]].Opcode = opcode;
+			ids[op[2]].TypeId = op[1];
+			ids[op[2]].Value = op[3];
+			break;
+
+		case SpvOpVariable:
+			if (!validateIds({ 1, 2 }))
+			{
+				return false;
+			}
+
+			ids[op[2]].Opcode = opcode;
+			ids[op[2]].TypeId = op[1];
+			ids[op[2]].StorageClass = op[3];
+			variables.push_back(op[2]);
+			break;
+		}
+	}
+
+	for (u32 variableId : variables)
+	{
+		// Ids were validated when their instructions were parsed.
+		const SpvId& variable = ids[variableId];
+		if (ids[variable.TypeId].Opcode != SpvOpTypePointer)
+		{
+			LOG(Error, "Failed to reflect shader, type of variable %u is not a pointer.", variableId);
+			return false;
+		}
+
+		const u32 typeId = ids[variable.TypeId].TypeId;
+
+		switch (variable.StorageClass)
+		{
+		case SpvStorageClassUniformConstant:
+		case SpvStorageClassUniform:
+		case SpvStorageClassStorageBuffer:
+		{
+			ReflectedBinding binding = {};
+			if (variable.Binding == INDEX_NONE ||
+				!GetDescriptorInfo(ids, variable.StorageClass, typeId, binding.Binding.descriptorType, binding.Binding.descriptorCount))
+			{
+				break;
+			}
+
+			binding.Set = variable.Set != INDEX_NONE ? variable.Set : 0;
+			binding.Binding.binding = variable.Binding;
+			binding.Binding.stageFlags = stage;
+			outReflection.Bindings.push_back(binding);
+			break;
+		}
+
+		case SpvStorageClassPushConstant:
+		{
+			const SpvId& block = ids[typeId];
+
+			u32 offset = UINT32_MAX;
+			for (const SpvMember& member : block.Members)
+			{
+				offset = std::min(offset, member.Offset);
+			}
+
+			if (offset == UINT32_MAX)
+			{
+				break;
+			}
+
+			const u32 size = GetTypeSize(ids, typeId);
+			if (size <= offset)
+			{
+				LOG(Error, "Failed to reflect shader, size of push constant block %u is unknown.", typeId);
+				return false;
+			}
+
+			outReflection.PushConstants.stageFlags = stage;
+			outReflection.PushConstants.offset = offset;
+			outReflection.PushConstants.size = size - offset;
+			break;
+		}
+
+		case SpvStorageClassInput:
+		{
+			if (stage != VK_SHADER_STAGE_VERTEX_BIT || variable.BuiltIn || variable.Location == INDEX_NONE)
+			{
+				break;
+			}
+
+			ReflectedVertexInput input = {};
+			input.Location = variable.Location;
+			input.Format = GetVertexInputFormat(ids, typeId);
+			outReflection.VertexInputs.push_back(input);
+			break;
+		}
+		}
+	}
+
+	auto bindingLess = [](const ReflectedBinding& a, const ReflectedBinding& b)
+	{
+		return a.Set != b.Set ? a.Set < b.Set : a.Binding.binding < b.Binding.binding;
+	};
+	std::sort(outReflection.Bindings.begin(), outReflection.Bindings.end(), bindingLess);
+
+	return true;
+}
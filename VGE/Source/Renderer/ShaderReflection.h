@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+
+namespace vge
+{
+	// Descriptor binding declared by shader, stage flags contain only reflected stage.
+	struct ReflectedBinding
+	{
+		u32 Set = 0;
+		VkDescriptorSetLayoutBinding Binding = {}; // descriptorCount is 0 for runtime arrays
+	};
+
+	// Vertex shader input, format is natural 32 bit format of declared type (actual attribute format can be quantized).
+	struct ReflectedVertexInput
+	{
+		u32 Location = 0;
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+	};
+
+	struct ShaderReflection
+	{
+		std::vector<ReflectedBinding> Bindings = {};
+		std::vector<ReflectedVertexInput> VertexInputs = {};
+		VkPushConstantRange PushConstants = {}; // size is 0 if shader has no push constant block
+		u32 SpecConstantIds = 0; // bit per declared specialization constant id, ids above 31 are not tracked
+	};
+}
+
+namespace vge::spirv
+{
+	// Parse SPIR-V module declarations, only variables with descriptor, push constant or input location decorations and specialization constant ids are reflected.
+	bool Reflect(const std::vector<char>& code, VkShaderStageFlagBits stage, ShaderReflection& outReflection);
+}
@@ -0,0 +1,33 @@
+#include "ShaderVariant.h"
+
+const char* vge::ShaderFeatureToString(ShaderFeature feature)
+{
+	switch (feature)
+	{
+	case ShaderFeature::DepthViz:
+		return "DepthViz";
+
+	case ShaderFeature::AlphaTest:
+		return "AlphaTest";
+
+	default:
+		return "Unknown";
+	}
+}
+
+vge::ShaderSpecialization::ShaderSpecialization(ShaderFeatures features)
+{
+	for (u32 i = 0; i < static_cast<u32>(ShaderFeature::Count); ++i)
+	{
+		m_Values[i] = HasFeature(features, static_cast<ShaderFeature>(i)) ? VK_TRUE : VK_FALSE;
+
+		m_Entries[i].constantID = i;
+		m_Entries[i].offset = i * sizeof(VkBool32);
+		m_Entries[i].size = sizeof(VkBool32);
+	}
+
+	m_Info.mapEntryCount = static_cast<u32>(C_ARRAY_NUM(m_Entries));
+	m_Info.pMapEntries = m_Entries;
+	m_Info.dataSize = sizeof(m_Values);
+	m_Info.pData = m_Values;
+}
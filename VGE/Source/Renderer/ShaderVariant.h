@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderCommon.h"
+
+namespace vge
+{
+	// Optional shader features, each one is bool specialization constant with constant_id equal to its index.
+	// Features changing shader interface (e.g. vertex layout) are precompiled SPIR-V variants instead.
+	enum class ShaderFeature : u32
+	{
+		DepthViz = 0,	// visualize depth in composition subpass
+		AlphaTest = 1,	// discard transparent texels
+
+		Count
+	};
+
+	// Set of enabled features, used as key of pipeline variants.
+	using ShaderFeatures = u32;
+
+	inline constexpr ShaderFeatures GetFeatureBit(ShaderFeature feature) { return 1u << static_cast<u32>(feature); }
+	inline constexpr bool HasFeature(ShaderFeatures features, ShaderFeature feature) { return (features & GetFeatureBit(feature)) != 0; }
+
+	const char* ShaderFeatureToString(ShaderFeature feature);
+
+	// Specialization constants of all features, shaders pick ones they declare.
+	class ShaderSpecialization
+	{
+	public:
+		ShaderSpecialization(ShaderFeatures features);
+		NOT_COPYABLE(ShaderSpecialization);
+
+		// Points to this object, so it must outlive pipeline creation.
+		inline const VkSpecializationInfo* GetInfo() const { return &m_Info; }
+
+	private:
+		VkBool32 m_Values[static_cast<size_t>(ShaderFeature::Count)] = {};
+		VkSpecializationMapEntry m_Entries[static_cast<size_t>(ShaderFeature::Count)] = {};
+		VkSpecializationInfo m_Info = {};
+	};
+}
@@ -2,6 +2,7 @@
 #include "Window.h"
 #include "Utils.h"
 #include "RenderPass.h"
+#include "Renderer.h"
 
 namespace vge
 {
@@ -28,10 +29,24 @@ namespace vge
 		return formats[0];
 	}
 
-	static VkPresentModeKHR GetBestPresentMode(const std::vector<VkPresentModeKHR>& modes)
+	static VkPresentModeKHR ToVkPresentMode(PresentMode mode)
 	{
-		static constexpr VkPresentModeKHR desiredMode = VK_PRESENT_MODE_MAILBOX_KHR;
-		static constexpr VkPresentModeKHR defaultMode = VK_PRESENT_MODE_FIFO_KHR;
+		switch (mode)
+		{
+		case PresentMode::Immediate:	return VK_PRESENT_MODE_IMMEDIATE_KHR;
+		case PresentMode::Mailbox:		return VK_PRESENT_MODE_MAILBOX_KHR;
+		case PresentMode::Fifo:			return VK_PRESENT_MODE_FIFO_KHR;
+		case PresentMode::FifoRelaxed:	return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+		}
+
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	static VkPresentModeKHR GetBestPresentMode(const std::vector<VkPresentModeKHR>& modes, PresentMode requestedMode)
+	{
+		static constexpr VkPresentModeKHR defaultMode = VK_PRESENT_MODE_FIFO_KHR; // the only one required to be supported
+
+		const VkPresentModeKHR desiredMode = ToVkPresentMode(requestedMode);
 
 		for (const VkPresentModeKHR& mode : modes)
 		{
@@ -41,9 +56,21 @@ namespace vge
 			}
 		}
 
+		LOG(Warning, "Requested present mode %d is not supported, fifo is used.", static_cast<i32>(desiredMode));
 		return defaultMode;
 	}
 
+	static u32 GetBestImageCount(const VkSurfaceCapabilitiesKHR& surfaceCapabilities, u32 requestedCount)
+	{
+		u32 imageCount = requestedCount > 0 ? std::max(requestedCount, surfaceCapabilities.minImageCount) : surfaceCapabilities.minImageCount + 1;
+		if (surfaceCapabilities.maxImageCount > 0 && surfaceCapabilities.maxImageCount < imageCount)
+		{
+			imageCount = surfaceCapabilities.maxImageCount; // 0 means no limit
+		}
+
+		return imageCount;
+	}
+
 	static VkExtent2D GetBestSwapchainExtent(VkSurfaceCapabilitiesKHR surfaceCapabilities)
 	{
 		if (surfaceCapabilities.currentExtent.width != UINT32_MAX)
@@ -67,8 +94,14 @@ vge::Swapchain::Swapchain(const Device* device) : m_Device(device)
 {
 }
 
-void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*/)
+void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*/, DeletionQueue* deletionQueue /*= nullptr*/)
 {
+	if (m_Device->IsHeadless())
+	{
+		InitializeOffscreen(recreateInfo ? recreateInfo->ImageCount : 0);
+		return;
+	}
+
 	if (recreateInfo && recreateInfo->IsValid())
 	{
 		m_Surface = recreateInfo->Surface;
@@ -83,14 +116,12 @@ void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*
 	QueueFamilyIndices queueIndices = m_Device->GetQueueIndices();
 
 	VkSurfaceFormatKHR surfaceFormat = GetBestSurfaceFormat(swapchainDetails.SurfaceFormats);
-	VkPresentModeKHR presentMode = GetBestPresentMode(swapchainDetails.PresentModes);
-	VkExtent2D extent = GetBestSwapchainExtent(swapchainDetails.SurfaceCapabilities);
+	const vge::PresentMode requestedPresentMode = recreateInfo ? recreateInfo->PresentMode : vge::PresentMode::Mailbox;
+	const u32 requestedImageCount = recreateInfo ? recreateInfo->ImageCount : 0;
 
-	u32 imageCount = swapchainDetails.SurfaceCapabilities.minImageCount + 1;
-	if (swapchainDetails.SurfaceCapabilities.maxImageCount > 0 && swapchainDetails.SurfaceCapabilities.maxImageCount < imageCount)
-	{
-		imageCount = swapchainDetails.SurfaceCapabilities.maxImageCount;
-	}
+	VkPresentModeKHR presentMode = GetBestPresentMode(swapchainDetails.PresentModes, requestedPresentMode);
+	VkExtent2D extent = GetBestSwapchainExtent(swapchainDetails.SurfaceCapabilities);
+	u32 imageCount = GetBestImageCount(swapchainDetails.SurfaceCapabilities, requestedImageCount);
 
 	VkSwapchainCreateInfoKHR swapchainCreateInfo = {};
 	swapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -140,7 +171,18 @@ void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*
 	{
 		if (recreateInfo->Swapchain != VK_NULL_HANDLE)
 		{
-			vkDestroySwapchainKHR(m_Device->GetHandle(), recreateInfo->Swapchain, nullptr);
+			// Old swapchain images may still be rendered to or presented by frames in flight.
+			if (deletionQueue)
+			{
+				deletionQueue->Push([device = m_Device->GetHandle(), oldSwapchain = recreateInfo->Swapchain]()
+				{
+					vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+				});
+			}
+			else
+			{
+				vkDestroySwapchainKHR(m_Device->GetHandle(), recreateInfo->Swapchain, nullptr);
+			}
 			recreateInfo->Swapchain = VK_NULL_HANDLE;
 		}
 
@@ -152,6 +194,7 @@ void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*
 	}
 
 	m_ImageFormat = surfaceFormat.format;
+	m_PresentMode = presentMode;
 	m_Extent = extent;
 
 	LOG(Log, "Dimensions: %dx%d", m_Extent.width, m_Extent.height);
@@ -176,21 +219,59 @@ void vge::Swapchain::Initialize(SwapchainRecreateInfo* recreateInfo /*= nullptr*
 
 		m_Images.push_back(swapchainImage);
 	}
+
+	LOG(Log, "Images: %zu, present mode: %d", m_Images.size(), static_cast<i32>(m_PresentMode));
 }
 
-void vge::Swapchain::Destroy(SwapchainRecreateInfo* recreateInfo /*= nullptr*/)
+void vge::Swapchain::Destroy(SwapchainRecreateInfo* recreateInfo /*= nullptr*/, DeletionQueue* deletionQueue /*= nullptr*/)
 {
 	for (FrameBuffer& framebuffer : m_Framebuffers)
 	{
-		framebuffer.Destroy();
+		if (deletionQueue)
+		{
+			deletionQueue->PushDestroy(framebuffer);
+		}
+		else
+		{
+			framebuffer.Destroy();
+		}
 	}
 
 	for (SwapchainImage& swapchainImage : m_Images)
 	{
-		vkDestroyImageView(m_Device->GetHandle(), swapchainImage.View, nullptr);
+		if (deletionQueue)
+		{
+			deletionQueue->Push([device = m_Device->GetHandle(), view = swapchainImage.View]() { vkDestroyImageView(device, view, nullptr); });
+		}
+		else
+		{
+			vkDestroyImageView(m_Device->GetHandle(), swapchainImage.View, nullptr);
+		}
 	}
 
-	if (recreateInfo && recreateInfo->IsValid())
+	for (Image& offscreenImage : m_OffscreenImages)
+	{
+		if (deletionQueue)
+		{
+			deletionQueue->PushDestroy(offscreenImage);
+		}
+		else
+		{
+			offscreenImage.Destroy();
+		}
+	}
+
+	m_Framebuffers.clear();
+	m_Images.clear();
+	m_OffscreenImages.clear();
+
+	if (m_Offscreen)
+	{
+		return;
+	}
+
+	// Handles are kept for recreation, so new swapchain reuses surface and gets old one as oldSwapchain.
+	if (recreateInfo)
 	{
 		recreateInfo->Swapchain = m_Handle;
 		recreateInfo->Surface = m_Surface;
@@ -202,6 +283,47 @@ void vge::Swapchain::Destroy(SwapchainRecreateInfo* recreateInfo /*= nullptr*/)
 	}
 }
 
+void vge::Swapchain::InitializeOffscreen(u32 requestedImageCount)
+{
+	m_Offscreen = true;
+	m_ImageFormat = GOffscreenImageFormat;
+	m_Extent = m_Device->GetWindow()->GetExtent();
+
+	// One image per frame in flight at least, nothing orders rendering and readback of different frames to the same image.
+	const u32 imageCount = std::max(requestedImageCount, static_cast<u32>(GMaxDrawFrames));
+	for (u32 i = 0; i < imageCount; ++i)
+	{
+		// Transfer source to read rendered frames back.
+		ImageCreateInfo imageCreateInfo = {};
+		imageCreateInfo.Device = m_Device;
+		imageCreateInfo.Extent = m_Extent;
+		imageCreateInfo.Format = m_ImageFormat;
+		imageCreateInfo.Tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.MemAllocUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		Image image = Image::Create(imageCreateInfo);
+
+		ImageViewCreateInfo imgViewCreateInfo = {};
+		imgViewCreateInfo.Device = m_Device;
+		imgViewCreateInfo.Format = m_ImageFormat;
+		imgViewCreateInfo.AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+		imgViewCreateInfo.Image = image.GetHandle();
+
+		SwapchainImage swapchainImage = {};
+		swapchainImage.Handle = image.GetHandle();
+		swapchainImage.View = Image::CreateView(imgViewCreateInfo);
+
+		m_OffscreenImages.push_back(image);
+		m_Images.push_back(swapchainImage);
+	}
+
+	// First acquire returns image 0.
+	m_CurrentImageIndex = imageCount - 1;
+
+	LOG(Log, "Offscreen images: %zu, dimensions: %dx%d", m_Images.size(), m_Extent.width, m_Extent.height);
+}
+
 void vge::Swapchain::CreateFramebuffer(const RenderPass* renderPass, u32 attachmentCount, const VkImageView* attachments)
 {
 	FrameBufferCreateInfo createInfo = {};
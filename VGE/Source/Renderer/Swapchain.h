@@ -1,13 +1,19 @@
 #pragma once
 
 #include "Common.h"
+#include "Application.h"
 #include "Device.h"
 #include "Buffer.h"
+#include "Image.h"
+#include "DeletionQueue.h"
 
 namespace vge
 {
 	class RenderPass;
 
+	// Format of headless images, guaranteed to support color attachment and transfer and is tightly packed for readback.
+	inline constexpr VkFormat GOffscreenImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
 	struct SwapchainImage
 	{
 		VkImage Handle = VK_NULL_HANDLE;
@@ -19,9 +25,14 @@ namespace vge
 		VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
 		VkSurfaceKHR Surface = VK_NULL_HANDLE;
 
+		// Requested settings, kept between recreations.
+		vge::PresentMode PresentMode = vge::PresentMode::Mailbox;	// fifo is used if not supported
+		u32 ImageCount = 0;											// 0 - one more than surface minimum, clamped to surface limits otherwise
+
 		inline bool IsValid() { return Swapchain && Surface; }
 	};
 
+	// Presentable images of window surface, or offscreen images with the same interface if device is headless.
 	class Swapchain
 	{
 	public:
@@ -30,12 +41,16 @@ namespace vge
 		NOT_COPYABLE(Swapchain);
 
 	public:
-		void Initialize(SwapchainRecreateInfo* recreateInfo = nullptr);
-		void Destroy(SwapchainRecreateInfo* recreateInfo = nullptr);
+		// Old swapchain from recreate info is passed as oldSwapchain and retired through deletion queue if given, destroyed right away otherwise.
+		void Initialize(SwapchainRecreateInfo* recreateInfo = nullptr, DeletionQueue* deletionQueue = nullptr);
+		// Framebuffers and image views are retired through deletion queue if given, as frames in flight may still use them.
+		void Destroy(SwapchainRecreateInfo* recreateInfo = nullptr, DeletionQueue* deletionQueue = nullptr);
 
-		inline VkSwapchainKHR GetHandle() const { return m_Handle; }
+		inline VkSwapchainKHR GetHandle() const { return m_Handle; }	// null if offscreen
+		inline bool IsOffscreen() const { return m_Offscreen; }
 		inline VkSurfaceKHR GetSurface() const { return m_Surface; }
 		inline VkFormat GetImageFormat() const { return m_ImageFormat; }
+		inline VkPresentModeKHR GetPresentMode() const { return m_PresentMode; }
 		inline VkExtent2D GetExtent() const { return m_Extent; }
 		inline u32 GetExtentWidth() const { return m_Extent.width; }
 		inline u32 GetExtentHeight() const { return m_Extent.height; }
@@ -48,8 +63,15 @@ namespace vge
 		inline 		 SwapchainImage* GetImage(size_t index)		  { return index < GetImageCount() ? &m_Images[index] : nullptr; }
 
 		inline u32 GetCurrentImageIndex() const { return m_CurrentImageIndex; }
+		// Semaphore and fence are not signaled for offscreen images, they are not owned by presentation engine and just cycled.
 		inline VkResult AcquireNextImage(VkSemaphore semaphore, u64 timeout = UINT64_MAX, VkFence fence = VK_NULL_HANDLE)
 		{
+			if (m_Offscreen)
+			{
+				m_CurrentImageIndex = (m_CurrentImageIndex + 1) % static_cast<u32>(GetImageCount());
+				return VK_SUCCESS;
+			}
+
 			return vkAcquireNextImageKHR(m_Device->GetHandle(), m_Handle, timeout, semaphore, fence, &m_CurrentImageIndex);
 		}
 
@@ -63,8 +85,14 @@ namespace vge
 		VkSwapchainKHR m_Handle = VK_NULL_HANDLE;
 		VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
 		VkFormat m_ImageFormat = {};
+		VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
 		VkExtent2D m_Extent = {};
 		std::vector<SwapchainImage> m_Images = {};
 		std::vector<FrameBuffer> m_Framebuffers = {};
+		std::vector<Image> m_OffscreenImages = {};	// owned, unlike images of swapchain
+		bool m_Offscreen = false;
+
+	private:
+		void InitializeOffscreen(u32 requestedImageCount);
 	};
 }
@@ -10,19 +10,22 @@ vge::Texture vge::Texture::Create(const TextureCreateInfo& data)
 	tex.m_Id = data.Id;
 	tex.m_Filename = data.Filename;
 	tex.m_Device = data.Device;
-	tex.m_Image = Image::CreateForTexture(data.Device, data.Filename);
+	tex.m_Image = data.Image.GetHandle() ? data.Image : Image::CreateForTexture(data.Device, data.Filename);
 
 	{
 		ImageViewCreateInfo texImgViewCreateInfo = {};
 		texImgViewCreateInfo.Device = data.Device;
-		texImgViewCreateInfo.Format = VK_FORMAT_R8G8B8A8_UNORM;
+		texImgViewCreateInfo.Format = tex.m_Image.GetFormat();
 		texImgViewCreateInfo.AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
 		texImgViewCreateInfo.Image = tex.m_Image.GetHandle();
 
 		tex.m_View = Image::CreateView(texImgViewCreateInfo);
 	}
 
-	CreateTextureDescriptorSet(data.Device->GetHandle(), data.Sampler, data.DescriptorPool, data.DescriptorLayout, tex.m_View, tex.m_Descriptor);
+	if (data.DescriptorAllocator)
+	{
+		CreateTextureDescriptorSet(data.Device->GetHandle(), data.Sampler, data.DescriptorAllocator, data.DescriptorLayout, tex.m_View, tex.m_Descriptor);
+	}
 
 	LOG(Log, "New - ID: %d, filename: %s", tex.GetId(), tex.GetFilename());
 
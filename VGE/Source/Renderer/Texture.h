@@ -6,6 +6,7 @@
 namespace vge
 {
 	class Device;
+	class DescriptorAllocator;
 
 	struct TextureCreateInfo
 	{
@@ -13,8 +14,9 @@ namespace vge
 		const char* Filename = nullptr;
 		const Device* Device = nullptr;
 		VkSampler Sampler = VK_NULL_HANDLE;
-		VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+		DescriptorAllocator* DescriptorAllocator = nullptr; // own descriptor set is not allocated without allocator (bindless textures)
 		VkDescriptorSetLayout DescriptorLayout = VK_NULL_HANDLE;
+		vge::Image Image = {}; // already created image to use, otherwise it is loaded from filename
 	};
 
 	class Texture
@@ -29,6 +31,7 @@ namespace vge
 
 		inline i32 GetId() const { return m_Id; }
 		inline const char* GetFilename() const { return m_Filename; }
+		inline VkImageView GetView() const { return m_View; }
 		inline VkDescriptorSet GetDescriptor() const { return m_Descriptor; }
 
 	private:
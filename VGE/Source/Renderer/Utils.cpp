@@ -1,4 +1,5 @@
 ﻿#include "Utils.h"
+#include "DescriptorAllocator.h"
 #include "Renderer.h"
 #include "Texture.h"
 #include "Window.h"
@@ -42,15 +43,10 @@ vge::u32 vge::FindMemoryTypeIndex(VkPhysicalDevice gpu, u32 allowedTypes, VkMemo
 	return 0;
 }
 
-void vge::CreateTextureDescriptorSet(VkDevice device, VkSampler sampler, VkDescriptorPool descriptorPool, VkDescriptorSetLayout descrptorSetLayout, VkImageView textureImageView, VkDescriptorSet& outTextureDescriptorSet)
+void vge::CreateTextureDescriptorSet(VkDevice device, VkSampler sampler, DescriptorAllocator* descriptorAllocator, VkDescriptorSetLayout descrptorSetLayout, VkImageView textureImageView, VkDescriptorSet& outTextureDescriptorSet)
 {
-	VkDescriptorSetAllocateInfo descriptorSetAllocInfo = {};
-	descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	descriptorSetAllocInfo.descriptorPool = descriptorPool;
-	descriptorSetAllocInfo.descriptorSetCount = 1;
-	descriptorSetAllocInfo.pSetLayouts = &descrptorSetLayout;
-
-	VK_ENSURE_MSG(vkAllocateDescriptorSets(device, &descriptorSetAllocInfo, &outTextureDescriptorSet), "Failed to allocate texture descriptor set.");
+	outTextureDescriptorSet = descriptorAllocator->Allocate(descrptorSetLayout);
+	ENSURE_MSG(outTextureDescriptorSet, "Failed to allocate texture descriptor set.");
 
 	VkDescriptorImageInfo descriptorImageInfo = {};
 	descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -69,7 +65,7 @@ void vge::CreateTextureDescriptorSet(VkDevice device, VkSampler sampler, VkDescr
 	vkUpdateDescriptorSets(device, 1, &descriptorSetWrite, 0, nullptr);
 }
 
-void vge::GetTexturesFromMaterials(const aiScene* scene, std::vector<const char*>& outTextures)
+void vge::GetTexturesFromMaterials(const aiScene* scene, std::vector<std::string>& outTextures)
 {
 	outTextures.resize(scene->mNumMaterials, "");
 
@@ -90,31 +86,48 @@ void vge::GetTexturesFromMaterials(const aiScene* scene, std::vector<const char*
 			if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
 			{
 				const i32 LastSlashIndex = static_cast<i32>(std::string(path.data).rfind("\\"));
-				const std::string filename = std::string(path.data).substr(LastSlashIndex + 1);
-				outTextures[i] = filename.c_str();
+				outTextures[i] = std::string(path.data).substr(LastSlashIndex + 1);
 			}
 		}
 	}
 }
 
-void vge::ResolveTexturesForDescriptors(Renderer* renderer, const std::vector<const char*>& texturePaths, std::vector<i32>& outTextureToDescriptorSet)
+void vge::ResolveTexturesForDescriptors(Renderer* renderer, const std::vector<std::string>& texturePaths, std::vector<i32>& outTextureToDescriptorSet)
 {
 	if (!renderer)
 	{
 		return;
 	}
 
-	outTextureToDescriptorSet.resize(texturePaths.size());
+	outTextureToDescriptorSet.resize(texturePaths.size(), 0);
+
+	std::vector<std::string> uniquePaths;
+	std::vector<i32> pathToUnique(texturePaths.size(), INDEX_NONE);
 
 	for (size_t i = 0; i < texturePaths.size(); ++i)
 	{
-		if (texturePaths[i] == "")
+		if (texturePaths[i].empty())
+		{
+			continue;
+		}
+
+		const auto it = std::find(uniquePaths.begin(), uniquePaths.end(), texturePaths[i]);
+		pathToUnique[i] = static_cast<i32>(std::distance(uniquePaths.begin(), it));
+
+		if (it == uniquePaths.end())
 		{
-			outTextureToDescriptorSet[i] = 0;
+			uniquePaths.push_back(texturePaths[i]);
 		}
-		else
+	}
+
+	std::vector<i32> textureIds;
+	renderer->CreateTextures(uniquePaths, textureIds);
+
+	for (size_t i = 0; i < texturePaths.size(); ++i)
+	{
+		if (pathToUnique[i] != INDEX_NONE)
 		{
-			outTextureToDescriptorSet[i] = renderer->CreateTexture(texturePaths[i]);
+			outTextureToDescriptorSet[i] = textureIds[pathToUnique[i]];
 		}
 	}
 }
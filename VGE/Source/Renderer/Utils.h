@@ -5,16 +5,19 @@
 
 namespace vge
 {	
+	class DescriptorAllocator;
+
 	const char* GpuTypeToString(VkPhysicalDeviceType gpuType);
 
 	u32 FindMemoryTypeIndex(VkPhysicalDevice gpu, u32 allowedTypes, VkMemoryPropertyFlags flags);
 
-	void CreateTextureDescriptorSet(VkDevice device, VkSampler sampler, VkDescriptorPool descriptorPool, VkDescriptorSetLayout descrptorSetLayout, VkImageView textureImageView, VkDescriptorSet& outTextureDescriptorSet);
+	void CreateTextureDescriptorSet(VkDevice device, VkSampler sampler, DescriptorAllocator* descriptorAllocator, VkDescriptorSetLayout descrptorSetLayout, VkImageView textureImageView, VkDescriptorSet& outTextureDescriptorSet);
 
 	// Get texture names from a given scene, preserves 1 to 1 relationship.
 	// If failed to get a texture from material, its name will be empty in out array.
-	void GetTexturesFromMaterials(const aiScene* scene, std::vector<const char*>& outTextures);
+	void GetTexturesFromMaterials(const aiScene* scene, std::vector<std::string>& outTextures);
 
 	// Resolve given textures to be mapped with descriptor sets.
-	void ResolveTexturesForDescriptors(class Renderer* renderer, const std::vector<const char*>& texturePaths, std::vector<i32>& outTextureToDescriptorSet);
+	// Textures are loaded in parallel, empty paths are mapped to default texture.
+	void ResolveTexturesForDescriptors(class Renderer* renderer, const std::vector<std::string>& texturePaths, std::vector<i32>& outTextureToDescriptorSet);
 }
@@ -0,0 +1,245 @@
+#include "VertexLayout.h"
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+	vge::u32 GetPositionSize(vge::VertexPositionFormat format)
+	{
+		switch (format)
+		{
+		case vge::VertexPositionFormat::Float32:	return sizeof(vge::f32) * 3;
+		case vge::VertexPositionFormat::Float16:	return sizeof(vge::u16) * 4;
+		case vge::VertexPositionFormat::Snorm16:	return sizeof(vge::u16) * 4;
+		default:									return 0;
+		}
+	}
+
+	VkFormat GetPositionVkFormat(vge::VertexPositionFormat format)
+	{
+		// 3 component 16 bit formats are rarely supported for vertex input, so 4th component is padding.
+		switch (format)
+		{
+		case vge::VertexPositionFormat::Float32:	return VK_FORMAT_R32G32B32_SFLOAT;
+		case vge::VertexPositionFormat::Float16:	return VK_FORMAT_R16G16B16A16_SFLOAT;
+		case vge::VertexPositionFormat::Snorm16:	return VK_FORMAT_R16G16B16A16_SNORM;
+		default:									return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	vge::u32 GetTexCoordSize(vge::VertexTexCoordFormat format)
+	{
+		switch (format)
+		{
+		case vge::VertexTexCoordFormat::Float32:	return sizeof(vge::f32) * 2;
+		case vge::VertexTexCoordFormat::Unorm16:	return sizeof(vge::u16) * 2;
+		default:									return 0;
+		}
+	}
+
+	VkFormat GetTexCoordVkFormat(vge::VertexTexCoordFormat format)
+	{
+		switch (format)
+		{
+		case vge::VertexTexCoordFormat::Float32:	return VK_FORMAT_R32G32_SFLOAT;
+		case vge::VertexTexCoordFormat::Unorm16:	return VK_FORMAT_R16G16_UNORM;
+		default:									return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	vge::u32 GetNormalSize(vge::VertexNormalFormat format)
+	{
+		switch (format)
+		{
+		case vge::VertexNormalFormat::Float32:		return sizeof(vge::f32) * 3;
+		case vge::VertexNormalFormat::Octahedral16:	return sizeof(vge::u16) * 2;
+		default:									return 0;
+		}
+	}
+
+	VkFormat GetNormalVkFormat(vge::VertexNormalFormat format)
+	{
+		switch (format)
+		{
+		case vge::VertexNormalFormat::Float32:		return VK_FORMAT_R32G32B32_SFLOAT;
+		case vge::VertexNormalFormat::Octahedral16:	return VK_FORMAT_R16G16_SNORM;
+		default:									return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	// Map unit vector to octahedron and unfold it to [-1, 1] square.
+	glm::vec2 EncodeOctahedral(glm::vec3 n)
+	{
+		const vge::f32 length = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+		if (length == 0.0f)
+		{
+			return glm::vec2(0.0f);
+		}
+
+		n /= length;
+
+		glm::vec2 result = glm::vec2(n.x, n.y);
+		if (n.z < 0.0f)
+		{
+			result.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+			result.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return result;
+	}
+
+	template<typename T>
+	inline void Write(vge::u8*& dst, const T& value)
+	{
+		vge::memory::Memcopy(dst, (void*)&value, sizeof(T));
+		dst += sizeof(T);
+	}
+}
+
+vge::u32 vge::VertexLayout::GetStride() const
+{
+	return GetPositionSize(Position) + GetTexCoordSize(TexCoords) + GetNormalSize(Normal);
+}
+
+vge::VertexInputDescription vge::VertexLayout::GetDescription() const
+{
+	VertexInputDescription description = {};
+
+	VkVertexInputBindingDescription mainDescription = {};
+	mainDescription.binding = 0;
+	mainDescription.stride = GetStride();
+	mainDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	description.Bindings.push_back(mainDescription);
+
+	u32 offset = 0;
+
+	VkVertexInputAttributeDescription positionAttribute = {};
+	positionAttribute.binding = 0;
+	positionAttribute.location = 0;
+	positionAttribute.format = GetPositionVkFormat(Position);
+	positionAttribute.offset = offset;
+	description.Attributes.push_back(positionAttribute);
+	offset += GetPositionSize(Position);
+
+	if (TexCoords != VertexTexCoordFormat::None)
+	{
+		VkVertexInputAttributeDescription textureAttribute = {};
+		textureAttribute.binding = 0;
+		textureAttribute.location = 1;
+		textureAttribute.format = GetTexCoordVkFormat(TexCoords);
+		textureAttribute.offset = offset;
+		description.Attributes.push_back(textureAttribute);
+		offset += GetTexCoordSize(TexCoords);
+	}
+
+	if (Normal != VertexNormalFormat::None)
+	{
+		VkVertexInputAttributeDescription normalAttribute = {};
+		normalAttribute.binding = 0;
+		normalAttribute.location = 2;
+		normalAttribute.format = GetNormalVkFormat(Normal);
+		normalAttribute.offset = offset;
+		description.Attributes.push_back(normalAttribute);
+		offset += GetNormalSize(Normal);
+	}
+
+	return description;
+}
+
+const char* vge::VertexLayout::GetVertexShaderFilename() const
+{
+	// Position and uv formats are converted to float by input assembler, only normal decoding needs different code.
+	switch (Normal)
+	{
+	case VertexNormalFormat::Float32:		return "Shaders/Bin/first_normal_float_vert.spv";
+	case VertexNormalFormat::Octahedral16:	return "Shaders/Bin/first_normal_vert.spv";
+	default:								return "Shaders/Bin/first_vert.spv";
+	}
+}
+
+void vge::VertexLayout::Pack(const Vertex* vertices, size_t vertexCount, std::vector<u8>& outData, MeshData& outMeshData) const
+{
+	outMeshData = {};
+	outData.resize(vertexCount * GetStride());
+
+	if (vertexCount == 0)
+	{
+		return;
+	}
+
+	glm::vec3 positionMin = vertices[0].Position;
+	glm::vec3 positionMax = vertices[0].Position;
+	glm::vec2 texCoordMin = vertices[0].TexCoords;
+	glm::vec2 texCoordMax = vertices[0].TexCoords;
+
+	for (size_t i = 1; i < vertexCount; ++i)
+	{
+		positionMin = glm::min(positionMin, vertices[i].Position);
+		positionMax = glm::max(positionMax, vertices[i].Position);
+		texCoordMin = glm::min(texCoordMin, vertices[i].TexCoords);
+		texCoordMax = glm::max(texCoordMax, vertices[i].TexCoords);
+	}
+
+	const glm::vec3 positionCenter = (positionMin + positionMax) * 0.5f;
+	const glm::vec3 positionExtent = glm::max((positionMax - positionMin) * 0.5f, glm::vec3(FLT_MIN));
+	const glm::vec2 texCoordRange = glm::max(texCoordMax - texCoordMin, glm::vec2(FLT_MIN));
+
+	if (Position == VertexPositionFormat::Float16)
+	{
+		outMeshData.PositionOffset = glm::vec4(positionCenter, 0.0f);
+	}
+	else if (Position == VertexPositionFormat::Snorm16)
+	{
+		outMeshData.PositionScale = glm::vec4(positionExtent, 1.0f);
+		outMeshData.PositionOffset = glm::vec4(positionCenter, 0.0f);
+	}
+
+	if (TexCoords == VertexTexCoordFormat::Unorm16)
+	{
+		outMeshData.TexCoordScaleOffset = glm::vec4(texCoordRange, texCoordMin);
+	}
+
+	u8* dst = outData.data();
+
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		const Vertex& vertex = vertices[i];
+
+		switch (Position)
+		{
+		case VertexPositionFormat::Float32:
+			Write(dst, vertex.Position);
+			break;
+		case VertexPositionFormat::Float16:
+			Write(dst, glm::packHalf4x16(glm::vec4(vertex.Position - positionCenter, 1.0f)));
+			break;
+		case VertexPositionFormat::Snorm16:
+			Write(dst, glm::packSnorm4x16(glm::vec4((vertex.Position - positionCenter) / positionExtent, 1.0f)));
+			break;
+		}
+
+		switch (TexCoords)
+		{
+		case VertexTexCoordFormat::Float32:
+			Write(dst, vertex.TexCoords);
+			break;
+		case VertexTexCoordFormat::Unorm16:
+			Write(dst, glm::packUnorm2x16((vertex.TexCoords - texCoordMin) / texCoordRange));
+			break;
+		default:
+			break;
+		}
+
+		switch (Normal)
+		{
+		case VertexNormalFormat::Float32:
+			Write(dst, vertex.Normal);
+			break;
+		case VertexNormalFormat::Octahedral16:
+			Write(dst, glm::packSnorm2x16(EncodeOctahedral(vertex.Normal)));
+			break;
+		default:
+			break;
+		}
+	}
+}
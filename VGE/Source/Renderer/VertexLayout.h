@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+
+namespace vge
+{
+	enum class VertexPositionFormat : u8
+	{
+		Float32,	// 12 bytes, as is
+		Float16,	// 8 bytes, relative to mesh bounds center
+		Snorm16,	// 8 bytes, normalized to mesh bounds
+	};
+
+	enum class VertexTexCoordFormat : u8
+	{
+		None,
+		Float32,	// 8 bytes, as is
+		Unorm16,	// 4 bytes, normalized to mesh uv bounds
+	};
+
+	enum class VertexNormalFormat : u8
+	{
+		None,
+		Float32,		// 12 bytes, as is
+		Octahedral16,	// 4 bytes, octahedral encoded unit vector
+	};
+
+	// Per mesh data to restore quantized attributes in vertex shader, pushed after ModelData.
+	struct MeshData
+	{
+		alignas(16) glm::vec4 PositionScale = glm::vec4(1.0f);
+		alignas(16) glm::vec4 PositionOffset = glm::vec4(0.0f);
+		alignas(16) glm::vec4 TexCoordScaleOffset = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f); // xy - scale, zw - offset
+	};
+
+	// Describes how Vertex is stored in vertex buffer, attributes are tightly packed in single binding.
+	// Locations are fixed: 0 - position, 1 - texture coordinates, 2 - normal.
+	struct VertexLayout
+	{
+	public:
+		// Smallest layout with attributes used by current shaders.
+		static constexpr VertexLayout Compact() { return { VertexPositionFormat::Snorm16, VertexTexCoordFormat::Unorm16, VertexNormalFormat::None }; }
+		// Unquantized layout, useful for debugging precision issues.
+		static constexpr VertexLayout Full() { return { VertexPositionFormat::Float32, VertexTexCoordFormat::Float32, VertexNormalFormat::Float32 }; }
+
+	public:
+		u32 GetStride() const;
+		VertexInputDescription GetDescription() const;
+
+		// Vertex shader variant compiled for this layout.
+		const char* GetVertexShaderFilename() const;
+
+		// Quantize vertices to given output with layout stride, fill data to dequantize them.
+		void Pack(const Vertex* vertices, size_t vertexCount, std::vector<u8>& outData, MeshData& outMeshData) const;
+
+	public:
+		VertexPositionFormat Position = VertexPositionFormat::Float32;
+		VertexTexCoordFormat TexCoords = VertexTexCoordFormat::Float32;
+		VertexNormalFormat Normal = VertexNormalFormat::None;
+	};
+
+	// Layout used for all meshes and main pipeline.
+	inline VertexLayout GVertexLayout = VertexLayout::Compact();
+}
@@ -11,5 +11,13 @@ namespace vge
 #endif
 
 	inline const char* GValidationLayers[] = { "VK_LAYER_KHRONOS_validation" };
-	inline const char* GDeviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+	// Timeline semaphore is core since Vulkan 1.2, its feature is guaranteed when extension is present.
+	inline const char* GDeviceExtensions[] = { VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME };
+	// Required unless rendering headless, as they depend on surface instance extensions.
+	inline const char* GPresentDeviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+	// Optional, enabled if supported.
+	inline const char* GBindlessInstanceExtensions[] = { VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME };
+	inline const char* GBindlessDeviceExtensions[] = { VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, VK_KHR_MAINTENANCE3_EXTENSION_NAME };
+	inline const char* GPresentWaitDeviceExtensions[] = { VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME };
 }
@@ -1,7 +1,30 @@
 #include "Window.h"
 
+vge::f64 vge::Window::GetTime() const
+{
+	return std::chrono::duration<f64>(std::chrono::steady_clock::now() - m_StartTime).count();
+}
+
+void vge::Window::GetFramebufferSize(i32& outw, i32& outh) const
+{
+	if (m_Headless)
+	{
+		outw = m_Width;
+		outh = m_Height;
+		return;
+	}
+
+	glfwGetFramebufferSize(m_Handle, &outw, &outh);
+}
+
 void vge::Window::GetInstanceExtensions(std::vector<const char*>& outExtensions) const
 {
+	// No surface is created, so no surface extensions are needed.
+	if (m_Headless)
+	{
+		return;
+	}
+
 	u32 glfwExtensionCount = 0;
 	const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
@@ -13,6 +36,12 @@ void vge::Window::GetInstanceExtensions(std::vector<const char*>& outExtensions)
 
 void vge::Window::WaitSizeless() const
 {
+	// Headless size never changes, so there are no events to wait for.
+	if (m_Headless)
+	{
+		return;
+	}
+
 	while (m_Width == 0 || m_Height == 0)
 	{
 		glfwWaitEvents();
@@ -31,12 +60,20 @@ void vge::Window::FramebufferResizeCallback(GLFWwindow* windowRaw, i32 width, i3
 	// TODO: add clever and beautiful way to recreate swapchain.
 }
 
-vge::Window::Window(const char* name, const i32 width, const i32 height)
-	: m_Name(name), m_Width(width), m_Height(height)
+vge::Window::Window(const char* name, const i32 width, const i32 height, bool headless /*= false*/)
+	: m_Name(name), m_Width(width), m_Height(height), m_Headless(headless)
 {}
 
 void vge::Window::Initialize()
 {
+	m_StartTime = std::chrono::steady_clock::now();
+
+	if (m_Headless)
+	{
+		LOG(Log, "Headless dimensions: %dx%d", m_Width, m_Height);
+		return;
+	}
+
 	glfwInit();
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 	glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
@@ -50,6 +87,11 @@ void vge::Window::Initialize()
 
 void vge::Window::Destroy()
 {
+	if (m_Headless)
+	{
+		return;
+	}
+
 	glfwDestroyWindow(m_Handle);
 	m_Handle = nullptr;
 	glfwTerminate();
@@ -7,10 +7,11 @@ namespace vge
 {
 	inline class Window* GWindow = nullptr;
 
+	// Headless window has no glfw window and surface, its size is only used for offscreen images.
 	class Window
 	{
 	public:
-		Window(const char* name, const i32 width, const i32 height);
+		Window(const char* name, const i32 width, const i32 height, bool headless = false);
 		NOT_COPYABLE(Window);
 
 	public:
@@ -18,16 +19,20 @@ namespace vge
 		void Destroy();
 
 		inline GLFWwindow* GetHandle() const { return m_Handle; }
-		inline void PollEvents() const { glfwPollEvents(); }
-		inline bool ShouldClose() const { return glfwWindowShouldClose(m_Handle); }
-		inline void GetFramebufferSize(i32& outw, i32& outh) const { glfwGetFramebufferSize(m_Handle, &outw, &outh); }
-		inline void CreateSurface(VkInstance instance, VkSurfaceKHR& outSurface) const { VK_ENSURE(glfwCreateWindowSurface(instance, m_Handle, nullptr, &outSurface)); }
+		inline bool IsHeadless() const { return m_Headless; }
+		inline void PollEvents() const { if (!m_Headless) glfwPollEvents(); }
+		inline bool ShouldClose() const { return !m_Headless && glfwWindowShouldClose(m_Handle); }
+		inline void CreateSurface(VkInstance instance, VkSurfaceKHR& outSurface) const { ENSURE(!m_Headless); VK_ENSURE(glfwCreateWindowSurface(instance, m_Handle, nullptr, &outSurface)); }
 		inline bool WasResized() const { return m_FramebufferResized; }
 		inline void ResetResizedFlag() { m_FramebufferResized = false; }
 		inline i32 GetWidth() const { return m_Width; }
 		inline i32 GetHeight() const { return m_Height; }
 		inline VkExtent2D GetExtent() const { return { static_cast<u32>(m_Width), static_cast<u32>(m_Height) }; }
-		inline bool IsKeyPressed(i32 key) const { return glfwGetKey(m_Handle, key) == GLFW_PRESS; }
+		inline bool IsKeyPressed(i32 key) const { return !m_Headless && glfwGetKey(m_Handle, key) == GLFW_PRESS; }
+
+		// Seconds since window initialization.
+		f64 GetTime() const;
+		void GetFramebufferSize(i32& outw, i32& outh) const;
 
 		void GetInstanceExtensions(std::vector<const char*>& outExtensions) const;
 		void WaitSizeless() const;
@@ -41,12 +46,14 @@ namespace vge
 		i32 m_Width = 0; 
 		i32 m_Height = 0;
 		bool m_FramebufferResized = false;
+		bool m_Headless = false;
+		std::chrono::steady_clock::time_point m_StartTime = {};	// not glfw timer, as glfw is not initialized in headless mode
 	};
 
-	inline Window* CreateWindow(const char* name, const i32 width, const i32 height)
+	inline Window* CreateWindow(const char* name, const i32 width, const i32 height, bool headless = false)
 	{
 		if (GWindow) return GWindow;
-		return (GWindow = new Window(name, width, height));
+		return (GWindow = new Window(name, width, height, headless));
 	}
 
 	inline bool DestroyWindow()
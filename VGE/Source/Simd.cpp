@@ -0,0 +1,378 @@
+#include "Simd.h"
+
+#if SIMD_X86
+	#include <tmmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define SIMD_TARGET_SSSE3
+		#define SIMD_TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		#define SIMD_TARGET_SSSE3 __attribute__((target("ssse3")))
+		#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace
+{
+	void ExpandRgbToRgbaScalar(const vge::u8* src, vge::u8* dst, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; ++i)
+		{
+			dst[i * 4 + 0] = src[i * 3 + 0];
+			dst[i * 4 + 1] = src[i * 3 + 1];
+			dst[i * 4 + 2] = src[i * 3 + 2];
+			dst[i * 4 + 3] = 255;
+		}
+	}
+
+#if SIMD_X86
+	// 16 rgba pixels per iteration from 48 source bytes.
+	SIMD_TARGET_SSSE3 void ExpandRgbToRgbaSSSE3(const vge::u8* src, vge::u8* dst, size_t pixelCount)
+	{
+		const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+		size_t i = 0;
+		for (; i + 16 <= pixelCount; i += 16)
+		{
+			const __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 0));
+			const __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 16));
+			const __m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 32));
+
+			const __m128i p0 = s0;									// pixels 0-3 (+ 4 bytes unused)
+			const __m128i p1 = _mm_alignr_epi8(s1, s0, 12);			// pixels 4-7
+			const __m128i p2 = _mm_alignr_epi8(s2, s1, 8);			// pixels 8-11
+			const __m128i p3 = _mm_srli_si128(s2, 4);				// pixels 12-15
+
+			__m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+			_mm_storeu_si128(out + 0, _mm_or_si128(_mm_shuffle_epi8(p0, shuffle), alpha));
+			_mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), alpha));
+			_mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), alpha));
+			_mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), alpha));
+		}
+
+		ExpandRgbToRgbaScalar(src + i * 3, dst + i * 4, pixelCount - i);
+	}
+#endif
+
+	void ComputeTransformMatrixScalar(const vge::simd::TransformArrays& transforms, size_t index, glm::mat4& outMatrix)
+	{
+		const vge::f32 c1 = glm::cos(glm::radians(transforms.Rotation[1][index]));
+		const vge::f32 s1 = glm::sin(glm::radians(transforms.Rotation[1][index]));
+		const vge::f32 c2 = glm::cos(glm::radians(transforms.Rotation[0][index]));
+		const vge::f32 s2 = glm::sin(glm::radians(transforms.Rotation[0][index]));
+		const vge::f32 c3 = glm::cos(glm::radians(transforms.Rotation[2][index]));
+		const vge::f32 s3 = glm::sin(glm::radians(transforms.Rotation[2][index]));
+
+		const vge::f32 sx = transforms.Scale[0][index];
+		const vge::f32 sy = transforms.Scale[1][index];
+		const vge::f32 sz = transforms.Scale[2][index];
+
+		outMatrix[0] = glm::vec4(sx * (c1 * c3 + s1 * s2 * s3), sx * (c2 * s3), sx * (c1 * s2 * s3 - c3 * s1), 0.0f);
+		outMatrix[1] = glm::vec4(sy * (c3 * s1 * s2 - c1 * s3), sy * (c2 * c3), sy * (c1 * c3 * s2 + s1 * s3), 0.0f);
+		outMatrix[2] = glm::vec4(sz * (c2 * s1), sz * (-s2), sz * (c1 * c2), 0.0f);
+		outMatrix[3] = glm::vec4(transforms.Translation[0][index], transforms.Translation[1][index], transforms.Translation[2][index], 1.0f);
+	}
+
+#if SIMD_X86
+	// Cephes sinf and cosf: reduce to [-pi/4, pi/4] by multiple of pi/2, the quadrant selects polynomial and signs.
+	void SinCosSSE2(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		// Quadrant rounded up to even, so that reduced angle is symmetric around 0.
+		__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f))); // 4 / pi
+		quadrant = _mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		const __m128 y = _mm_cvtepi32_ps(quadrant);
+
+		signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(4)), 29)));
+		const __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		const __m128 sinPolyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+		// Extended precision subtraction of y * pi / 4.
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+		cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		__m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+		const __m128 sinValue = _mm_or_ps(_mm_and_ps(sinPolyMask, sinPoly), _mm_andnot_ps(sinPolyMask, cosPoly));
+		const __m128 cosValue = _mm_or_ps(_mm_and_ps(sinPolyMask, cosPoly), _mm_andnot_ps(sinPolyMask, sinPoly));
+
+		outSin = _mm_xor_ps(sinValue, signSin);
+		outCos = _mm_xor_ps(cosValue, signCos);
+	}
+
+	// 4 transforms per call, matrix elements are computed in lanes and transposed to column major matrices.
+	void ComputeTransformMatricesSSE2(const vge::simd::TransformArrays& transforms, size_t index, glm::mat4* outMatrices)
+	{
+		const __m128 degreesToRadians = _mm_set1_ps(glm::pi<vge::f32>() / 180.0f);
+
+		__m128 s1, c1, s2, c2, s3, c3;
+		SinCosSSE2(_mm_mul_ps(_mm_loadu_ps(transforms.Rotation[1] + index), degreesToRadians), s1, c1);
+		SinCosSSE2(_mm_mul_ps(_mm_loadu_ps(transforms.Rotation[0] + index), degreesToRadians), s2, c2);
+		SinCosSSE2(_mm_mul_ps(_mm_loadu_ps(transforms.Rotation[2] + index), degreesToRadians), s3, c3);
+
+		const __m128 sx = _mm_loadu_ps(transforms.Scale[0] + index);
+		const __m128 sy = _mm_loadu_ps(transforms.Scale[1] + index);
+		const __m128 sz = _mm_loadu_ps(transforms.Scale[2] + index);
+
+		const __m128 s1s2 = _mm_mul_ps(s1, s2);
+		const __m128 c1s2 = _mm_mul_ps(c1, s2);
+
+		__m128 columns[4][4] =
+		{
+			{
+				_mm_mul_ps(sx, _mm_add_ps(_mm_mul_ps(c1, c3), _mm_mul_ps(s1s2, s3))),
+				_mm_mul_ps(sx, _mm_mul_ps(c2, s3)),
+				_mm_mul_ps(sx, _mm_sub_ps(_mm_mul_ps(c1s2, s3), _mm_mul_ps(c3, s1))),
+				_mm_setzero_ps(),
+			},
+			{
+				_mm_mul_ps(sy, _mm_sub_ps(_mm_mul_ps(c3, s1s2), _mm_mul_ps(c1, s3))),
+				_mm_mul_ps(sy, _mm_mul_ps(c2, c3)),
+				_mm_mul_ps(sy, _mm_add_ps(_mm_mul_ps(c1s2, c3), _mm_mul_ps(s1, s3))),
+				_mm_setzero_ps(),
+			},
+			{
+				_mm_mul_ps(sz, _mm_mul_ps(c2, s1)),
+				_mm_mul_ps(sz, _mm_xor_ps(s2, _mm_set1_ps(-0.0f))),
+				_mm_mul_ps(sz, _mm_mul_ps(c1, c2)),
+				_mm_setzero_ps(),
+			},
+			{
+				_mm_loadu_ps(transforms.Translation[0] + index),
+				_mm_loadu_ps(transforms.Translation[1] + index),
+				_mm_loadu_ps(transforms.Translation[2] + index),
+				_mm_set1_ps(1.0f),
+			},
+		};
+
+		for (size_t column = 0; column < 4; ++column)
+		{
+			__m128* rows = columns[column];
+			_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				_mm_storeu_ps(&outMatrices[index + lane][column][0], rows[lane]);
+			}
+		}
+	}
+
+	SIMD_TARGET_AVX2 void SinCosAVX2(__m256 x, __m256& outSin, __m256& outCos)
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+		__m256 signSin = _mm256_and_ps(x, signMask);
+		x = _mm256_andnot_ps(signMask, x);
+
+		__m256i quadrant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+		quadrant = _mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+		const __m256 y = _mm256_cvtepi32_ps(quadrant);
+
+		signSin = _mm256_xor_ps(signSin, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(4)), 29)));
+		const __m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(quadrant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+		const __m256 sinPolyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(0.78515625f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(3.77489497744594108e-8f)));
+
+		const __m256 z = _mm256_mul_ps(x, x);
+
+		__m256 cosPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.443315711809948e-5f), z), _mm256_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+		cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+		__m256 sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.9515295891e-4f), z), _mm256_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, z), x), x);
+
+		const __m256 sinValue = _mm256_blendv_ps(cosPoly, sinPoly, sinPolyMask);
+		const __m256 cosValue = _mm256_blendv_ps(sinPoly, cosPoly, sinPolyMask);
+
+		outSin = _mm256_xor_ps(sinValue, signSin);
+		outCos = _mm256_xor_ps(cosValue, signCos);
+	}
+
+	// 8 transforms per call, lower and upper halves of lanes are transposed as in SSE2 version.
+	SIMD_TARGET_AVX2 void ComputeTransformMatricesAVX2(const vge::simd::TransformArrays& transforms, size_t index, glm::mat4* outMatrices)
+	{
+		const __m256 degreesToRadians = _mm256_set1_ps(glm::pi<vge::f32>() / 180.0f);
+
+		__m256 s1, c1, s2, c2, s3, c3;
+		SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(transforms.Rotation[1] + index), degreesToRadians), s1, c1);
+		SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(transforms.Rotation[0] + index), degreesToRadians), s2, c2);
+		SinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(transforms.Rotation[2] + index), degreesToRadians), s3, c3);
+
+		const __m256 sx = _mm256_loadu_ps(transforms.Scale[0] + index);
+		const __m256 sy = _mm256_loadu_ps(transforms.Scale[1] + index);
+		const __m256 sz = _mm256_loadu_ps(transforms.Scale[2] + index);
+
+		const __m256 s1s2 = _mm256_mul_ps(s1, s2);
+		const __m256 c1s2 = _mm256_mul_ps(c1, s2);
+
+		const __m256 columns[4][4] =
+		{
+			{
+				_mm256_mul_ps(sx, _mm256_add_ps(_mm256_mul_ps(c1, c3), _mm256_mul_ps(s1s2, s3))),
+				_mm256_mul_ps(sx, _mm256_mul_ps(c2, s3)),
+				_mm256_mul_ps(sx, _mm256_sub_ps(_mm256_mul_ps(c1s2, s3), _mm256_mul_ps(c3, s1))),
+				_mm256_setzero_ps(),
+			},
+			{
+				_mm256_mul_ps(sy, _mm256_sub_ps(_mm256_mul_ps(c3, s1s2), _mm256_mul_ps(c1, s3))),
+				_mm256_mul_ps(sy, _mm256_mul_ps(c2, c3)),
+				_mm256_mul_ps(sy, _mm256_add_ps(_mm256_mul_ps(c1s2, c3), _mm256_mul_ps(s1, s3))),
+				_mm256_setzero_ps(),
+			},
+			{
+				_mm256_mul_ps(sz, _mm256_mul_ps(c2, s1)),
+				_mm256_mul_ps(sz, _mm256_xor_ps(s2, _mm256_set1_ps(-0.0f))),
+				_mm256_mul_ps(sz, _mm256_mul_ps(c1, c2)),
+				_mm256_setzero_ps(),
+			},
+			{
+				_mm256_loadu_ps(transforms.Translation[0] + index),
+				_mm256_loadu_ps(transforms.Translation[1] + index),
+				_mm256_loadu_ps(transforms.Translation[2] + index),
+				_mm256_set1_ps(1.0f),
+			},
+		};
+
+		for (size_t column = 0; column < 4; ++column)
+		{
+			for (size_t half = 0; half < 2; ++half)
+			{
+				__m128 rows[4];
+				for (size_t row = 0; row < 4; ++row)
+				{
+					rows[row] = half == 0 ? _mm256_castps256_ps128(columns[column][row]) : _mm256_extractf128_ps(columns[column][row], 1);
+				}
+
+				_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+				for (size_t lane = 0; lane < 4; ++lane)
+				{
+					_mm_storeu_ps(&outMatrices[index + half * 4 + lane][column][0], rows[lane]);
+				}
+			}
+		}
+	}
+#endif
+}
+
+bool vge::simd::HasSSSE3()
+{
+#if SIMD_X86
+	static const bool hasSSSE3 = []()
+	{
+	#ifdef _MSC_VER
+		i32 cpuInfo[4] = {};
+		__cpuid(cpuInfo, 1);
+		return (cpuInfo[2] & (1 << 9)) != 0;
+	#else
+		u32 eax = 0, ebx = 0, ecx = 0, edx = 0;
+		return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 9)) != 0;
+	#endif
+	}();
+
+	return hasSSSE3;
+#else
+	return false;
+#endif
+}
+
+bool vge::simd::HasAVX2()
+{
+#if SIMD_X86
+	static const bool hasAVX2 = []()
+	{
+		// AVX needs OS support of ymm registers (osxsave and xcr0 bits of sse and avx state) besides cpu one.
+	#ifdef _MSC_VER
+		i32 cpuInfo[4] = {};
+		__cpuid(cpuInfo, 1);
+		const bool hasAVX = (cpuInfo[2] & (1 << 27)) != 0 && (cpuInfo[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+		__cpuidex(cpuInfo, 7, 0);
+		return hasAVX && (cpuInfo[1] & (1 << 5)) != 0;
+	#else
+		u32 eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & (1 << 27)) == 0 || (ecx & (1 << 28)) == 0)
+		{
+			return false;
+		}
+
+		u32 xcr0 = 0, xcr0High = 0;
+		__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+		if ((xcr0 & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1 << 5)) != 0;
+	#endif
+	}();
+
+	return hasAVX2;
+#else
+	return false;
+#endif
+}
+
+void vge::simd::ExpandRgbToRgba(const u8* src, u8* dst, size_t pixelCount)
+{
+#if SIMD_X86
+	if (HasSSSE3())
+	{
+		ExpandRgbToRgbaSSSE3(src, dst, pixelCount);
+		return;
+	}
+#endif
+
+	ExpandRgbToRgbaScalar(src, dst, pixelCount);
+}
+
+void vge::simd::ComputeTransformMatrices(const TransformArrays& transforms, size_t first, size_t count, glm::mat4* outMatrices)
+{
+	const size_t end = first + count;
+	size_t i = first;
+
+#if SIMD_X86
+	if (HasAVX2())
+	{
+		for (; i + 8 <= end; i += 8)
+		{
+			ComputeTransformMatricesAVX2(transforms, i, outMatrices);
+		}
+	}
+	else
+	{
+		for (; i + 4 <= end; i += 4)
+		{
+			ComputeTransformMatricesSSE2(transforms, i, outMatrices);
+		}
+	}
+#endif
+
+	// Remaining transforms, or all of them without simd.
+	for (; i < end; ++i)
+	{
+		ComputeTransformMatrixScalar(transforms, i, outMatrices[i]);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Common.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+	#define SIMD_X86 1
+#else
+	#define SIMD_X86 0
+#endif
+
+namespace vge::simd
+{
+	// Whether SSSE3 (pshufb) is available on running CPU, checked once.
+	bool HasSSSE3();
+	// Whether AVX2 is available on running CPU and its registers are saved by OS, checked once.
+	bool HasAVX2();
+
+	// Expand tightly packed rgb pixels to rgba with opaque alpha. Source and destination must not overlap.
+	void ExpandRgbToRgba(const u8* src, u8* dst, size_t pixelCount);
+
+	// Transforms in structure of arrays layout, indexed by x, y, z. Rotation is in degrees, as in TransformComponent.
+	struct TransformArrays
+	{
+		const f32* Translation[3] = {};
+		const f32* Rotation[3] = {};
+		const f32* Scale[3] = {};
+	};
+
+	// Compute the same matrices as TransformComponent::GetMat4 for transforms [first, first + count) into outMatrices[first...].
+	// 8 transforms per iteration with AVX2, 4 with SSE2. Sine and cosine are approximated, accurate to few ulp for angles below 8192 radians.
+	void ComputeTransformMatrices(const TransformArrays& transforms, size_t first, size_t count, glm::mat4* outMatrices);
+}
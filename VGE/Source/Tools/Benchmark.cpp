@@ -0,0 +1,463 @@
+#include "Benchmark.h"
+#include "Application.h"
+#include "Game/Camera.h"
+#include "ECS/Coordinator.h"
+#include "ECS/GameSystem.h"
+#include "ECS/RenderSystem.h"
+#include "Renderer/Window.h"
+#include "Renderer/Device.h"
+#include "Renderer/Renderer.h"
+#include "Components/RenderComponent.h"
+#include "Components/TransformComponent.h"
+
+namespace vge::bench
+{
+	inline constexpr const char* GBenchModelFilename = "Models/cottage/Cottage_FREE.obj";
+
+	// Camera position and target in units of scene radius.
+	struct CameraKey
+	{
+		glm::vec3 Position;
+		glm::vec3 Target;
+	};
+
+	struct BenchmarkScene
+	{
+		const char* Name = nullptr;
+		const char* Description = nullptr;
+		u32 InstanceCount = 0;			// placed on square grid
+		bool UniqueModels = false;		// every instance loads own copy of model, so no buffers are shared between draws
+		const CameraKey* CameraPath = nullptr;
+		u32 CameraKeyCount = 0;
+	};
+
+	namespace
+	{
+		constexpr CameraKey GOrbitPath[] =
+		{
+			{ {  1.6f, 0.6f,  0.0f }, { 0.0f, 0.0f, 0.0f } },
+			{ {  0.0f, 0.6f,  1.6f }, { 0.0f, 0.0f, 0.0f } },
+			{ { -1.6f, 0.6f,  0.0f }, { 0.0f, 0.0f, 0.0f } },
+			{ {  0.0f, 0.6f, -1.6f }, { 0.0f, 0.0f, 0.0f } },
+			{ {  1.6f, 0.6f,  0.0f }, { 0.0f, 0.0f, 0.0f } },
+		};
+
+		// Dive from above into the grid, fly low across it and look back at the whole scene.
+		constexpr CameraKey GFlythroughPath[] =
+		{
+			{ { -1.5f, 0.8f, -1.5f }, {  0.0f, 0.0f,  0.0f } },
+			{ { -0.8f, 0.2f, -0.8f }, {  0.5f, 0.0f,  0.5f } },
+			{ {  0.0f, 0.1f,  0.0f }, {  1.0f, 0.0f,  1.0f } },
+			{ {  0.8f, 0.2f,  0.8f }, {  1.5f, 0.1f,  1.5f } },
+			{ {  1.5f, 0.8f,  1.5f }, {  0.0f, 0.0f,  0.0f } },
+		};
+
+		const BenchmarkScene GScenes[] =
+		{
+			{ "cottage",		"Single cottage, orbiting camera",					1,		false,	GOrbitPath,			C_ARRAY_NUM(GOrbitPath) },
+			{ "cottages_100",	"10x10 cottages sharing one model, flythrough",		100,	false,	GFlythroughPath,	C_ARRAY_NUM(GFlythroughPath) },
+			{ "cottages_1000",	"32x32 cottages sharing one model, flythrough",		1000,	false,	GFlythroughPath,	C_ARRAY_NUM(GFlythroughPath) },
+			{ "unique_64",		"8x8 unique cottage models, flythrough",			64,		true,	GFlythroughPath,	C_ARRAY_NUM(GFlythroughPath) },
+		};
+
+		const BenchmarkScene* FindScene(const char* name)
+		{
+			for (const BenchmarkScene& scene : GScenes)
+			{
+				if (std::strcmp(scene.Name, name) == 0)
+				{
+					return &scene;
+				}
+			}
+
+			return nullptr;
+		}
+
+		struct MetricSummary
+		{
+			f64 Avg = 0.0;
+			f64 P50 = 0.0;
+			f64 P95 = 0.0;
+			f64 P99 = 0.0;
+			f64 Max = 0.0;
+		};
+
+		using Metric = std::pair<std::string, f64>;
+
+		// Nearest rank percentile of sorted values.
+		f64 Percentile(const std::vector<f64>& sorted, f64 percent)
+		{
+			const size_t rank = static_cast<size_t>(std::ceil(percent * static_cast<f64>(sorted.size())));
+			return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+		}
+
+		MetricSummary Summarize(std::vector<f64> values)
+		{
+			MetricSummary summary = {};
+			if (values.empty())
+			{
+				return summary;
+			}
+
+			std::sort(values.begin(), values.end());
+
+			f64 total = 0.0;
+			for (f64 value : values)
+			{
+				total += value;
+			}
+
+			summary.Avg = total / static_cast<f64>(values.size());
+			summary.P50 = Percentile(values, 0.50);
+			summary.P95 = Percentile(values, 0.95);
+			summary.P99 = Percentile(values, 0.99);
+			summary.Max = values.back();
+
+			return summary;
+		}
+
+		void AddSummary(std::vector<Metric>& metrics, const char* name, const MetricSummary& summary)
+		{
+			const std::string prefix = name;
+			metrics.emplace_back(prefix + "_avg", summary.Avg);
+			metrics.emplace_back(prefix + "_p50", summary.P50);
+			metrics.emplace_back(prefix + "_p95", summary.P95);
+			metrics.emplace_back(prefix + "_p99", summary.P99);
+			metrics.emplace_back(prefix + "_max", summary.Max);
+		}
+
+		// Reads "name": value lines of metrics object written by benchmark, other json is not supported.
+		bool ReadMetrics(const char* filename, std::vector<Metric>& outMetrics)
+		{
+			std::ifstream file(filename);
+			if (!file.is_open())
+			{
+				std::printf("Failed to open %s\n", filename);
+				return false;
+			}
+
+			bool inMetrics = false;
+			std::string line;
+			while (std::getline(file, line))
+			{
+				if (line.find("\"metrics\"") != std::string::npos)
+				{
+					inMetrics = true;
+					continue;
+				}
+
+				char name[128] = {};
+				f64 value = 0.0;
+				if (inMetrics && std::sscanf(line.c_str(), " \"%127[^\"]\": %lf", name, &value) == 2)
+				{
+					outMetrics.emplace_back(name, value);
+				}
+			}
+
+			return !outMetrics.empty();
+		}
+	}
+}
+
+void vge::bench::Benchmark::Initialize(const ApplicationSpecs& specs)
+{
+	m_Scene = FindScene(specs.Benchmark.Scene);
+	ENSURE_MSG(m_Scene, "Unknown benchmark scene.");
+
+	m_OutputPath = specs.Benchmark.Output;
+	m_Frames.resize(specs.Headless.FrameCount);
+
+	LOG(Log, "Benchmark scene %s: %s, %u frames.", m_Scene->Name, m_Scene->Description, specs.Headless.FrameCount);
+}
+
+void vge::bench::Benchmark::Destroy()
+{
+	m_Frames.clear();
+	m_Scene = nullptr;
+}
+
+void vge::bench::Benchmark::CreateScene(GameSystem* gameSystem, RenderSystem* renderSystem)
+{
+	const u32 gridSize = static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(m_Scene->InstanceCount))));
+
+	i32 sharedModelId = INDEX_NONE;
+	f32 spacing = 0.0f;
+
+	for (u32 i = 0; i < m_Scene->InstanceCount; ++i)
+	{
+		RenderComponent renderComponent = {};
+		renderComponent.ModelId = (m_Scene->UniqueModels || sharedModelId == INDEX_NONE) ? GRenderer->CreateModel(GBenchModelFilename) : sharedModelId;
+		sharedModelId = renderComponent.ModelId;
+
+		// Grid is sized by first model, so scene scale does not depend on model units.
+		const f32 modelRadius = GRenderer->FindModel(renderComponent.ModelId)->GetBoundsRadius();
+		if (i == 0)
+		{
+			spacing = modelRadius * 2.5f;
+			m_SceneRadius = static_cast<f32>(gridSize - 1) * spacing * 0.5f + modelRadius;
+		}
+
+		const f32 gridOffset = static_cast<f32>(gridSize - 1) * 0.5f;
+
+		TransformComponent transform = {};
+		transform.Translation.x = (static_cast<f32>(i % gridSize) - gridOffset) * spacing;
+		transform.Translation.z = (static_cast<f32>(i / gridSize) - gridOffset) * spacing;
+
+		const Entity entity = GCoordinator->CreateEntity();
+
+		gameSystem->Add(entity);
+		GCoordinator->AddComponent(entity, transform);
+
+		renderSystem->Add(entity);
+		GCoordinator->AddComponent(entity, renderComponent);
+	}
+
+	const DeviceMemoryStats memoryStats = GDevice->GetMemoryStats();
+	LOG(Log, "Benchmark scene created: %u instances, radius %.2f, %u allocations (%.1f MiB).", m_Scene->InstanceCount, m_SceneRadius,
+		memoryStats.AllocationCount, static_cast<f64>(memoryStats.AllocationBytes) / (1024.0 * 1024.0));
+
+	GRenderer->SetFrameStatsEnabled(true);
+}
+
+void vge::bench::Benchmark::Tick()
+{
+	const f64 now = GWindow->GetTime();
+	const u64 frame = GAppFrame;
+
+	if (frame > 0 && frame <= m_Frames.size())
+	{
+		m_Frames[frame - 1].CpuTimeMs = (now - m_LastTickTime) * 1000.0;
+	}
+	m_LastTickTime = now;
+
+	CollectRetiredFrames();
+
+	if (frame >= m_Frames.size())
+	{
+		return;
+	}
+
+	// Camera moves by frame index instead of time, so every run renders the same images.
+	const f32 progress = m_Frames.size() > 1 ? static_cast<f32>(frame) / static_cast<f32>(m_Frames.size() - 1) : 0.0f;
+	UpdateCamera(progress);
+
+	const DeviceMemoryStats memoryStats = GDevice->GetMemoryStats();
+	m_Frames[frame].AllocationCount = memoryStats.AllocationCount;
+	m_Frames[frame].AllocationBytes = memoryStats.AllocationBytes;
+	m_Frames[frame].MemoryBytes = memoryStats.BlockBytes;
+}
+
+void vge::bench::Benchmark::Finish()
+{
+	// Last frame ends here, as there is no next tick.
+	const u64 lastFrame = GAppFrame;
+	if (lastFrame > 0 && lastFrame <= m_Frames.size())
+	{
+		m_Frames[lastFrame - 1].CpuTimeMs = (GWindow->GetTime() - m_LastTickTime) * 1000.0;
+	}
+
+	GRenderer->RetireAllFrames();
+	CollectRetiredFrames();
+
+	const std::string csvFilename = std::string(m_OutputPath) + ".csv";
+	const std::string jsonFilename = std::string(m_OutputPath) + ".json";
+
+	if (WriteCsv(csvFilename.c_str()) && WriteJson(jsonFilename.c_str()))
+	{
+		LOG(Log, "Benchmark results written to %s and %s.", csvFilename.c_str(), jsonFilename.c_str());
+	}
+}
+
+void vge::bench::Benchmark::UpdateCamera(f32 progress) const
+{
+	const u32 segmentCount = m_Scene->CameraKeyCount - 1;
+	const f32 segmentProgress = progress * static_cast<f32>(segmentCount);
+	const u32 segment = std::min(static_cast<u32>(segmentProgress), segmentCount - 1);
+	const f32 alpha = segmentProgress - static_cast<f32>(segment);
+
+	const CameraKey& from = m_Scene->CameraPath[segment];
+	const CameraKey& to = m_Scene->CameraPath[segment + 1];
+
+	const glm::vec3 position = glm::mix(from.Position, to.Position, alpha) * m_SceneRadius;
+	const glm::vec3 target = glm::mix(from.Target, to.Target, alpha) * m_SceneRadius;
+
+	// Renderer view is not updated from camera by render system.
+	GCamera->SetViewTarget(position, target);
+	GRenderer->SetView(GCamera->GetViewMatrix());
+}
+
+void vge::bench::Benchmark::CollectRetiredFrames()
+{
+	FrameStats stats = {};
+	while (GRenderer->PopRetiredFrameStats(stats))
+	{
+		if (stats.AppFrame < m_Frames.size())
+		{
+			m_Frames[stats.AppFrame].GpuTimeMs = stats.GpuTimeMs;
+			m_Frames[stats.AppFrame].DrawCallCount = stats.DrawCallCount;
+		}
+	}
+}
+
+bool vge::bench::Benchmark::WriteCsv(const char* filename) const
+{
+#ifdef _MSC_VER
+#pragma warning(suppress : 4996)
+#endif
+	FILE* file = fopen(filename, "w");
+	if (!file)
+	{
+		LOG(Error, "Failed to open a file for writing: %s.", filename);
+		return false;
+	}
+
+	std::fprintf(file, "frame,cpu_ms,gpu_ms,draw_calls,allocations,allocation_bytes,memory_bytes\n");
+	for (size_t i = 0; i < m_Frames.size(); ++i)
+	{
+		const BenchmarkFrame& frame = m_Frames[i];
+		std::fprintf(file, "%zu,%.4f,%.4f,%u,%u,%llu,%llu\n", i, frame.CpuTimeMs, frame.GpuTimeMs, frame.DrawCallCount, frame.AllocationCount,
+			static_cast<unsigned long long>(frame.AllocationBytes), static_cast<unsigned long long>(frame.MemoryBytes));
+	}
+
+	fclose(file);
+	return true;
+}
+
+bool vge::bench::Benchmark::WriteJson(const char* filename) const
+{
+	constexpr f64 bytesInMiB = 1024.0 * 1024.0;
+
+	std::vector<f64> cpuTimes, gpuTimes, drawCalls, allocations, allocationMiB, memoryMiB;
+	for (size_t i = GBenchWarmupFrames; i < m_Frames.size(); ++i)
+	{
+		const BenchmarkFrame& frame = m_Frames[i];
+		cpuTimes.push_back(frame.CpuTimeMs);
+		gpuTimes.push_back(frame.GpuTimeMs);
+		drawCalls.push_back(static_cast<f64>(frame.DrawCallCount));
+		allocations.push_back(static_cast<f64>(frame.AllocationCount));
+		allocationMiB.push_back(static_cast<f64>(frame.AllocationBytes) / bytesInMiB);
+		memoryMiB.push_back(static_cast<f64>(frame.MemoryBytes) / bytesInMiB);
+	}
+
+	const MetricSummary cpuSummary = Summarize(cpuTimes);
+	const MetricSummary gpuSummary = Summarize(gpuTimes);
+	const MetricSummary drawCallSummary = Summarize(drawCalls);
+
+	std::vector<Metric> metrics;
+	AddSummary(metrics, "cpu_frame_ms", cpuSummary);
+	AddSummary(metrics, "gpu_frame_ms", gpuSummary);
+	metrics.emplace_back("draw_calls_avg", drawCallSummary.Avg);
+	metrics.emplace_back("draw_calls_max", drawCallSummary.Max);
+	metrics.emplace_back("allocations_max", Summarize(allocations).Max);
+	metrics.emplace_back("allocation_mib_max", Summarize(allocationMiB).Max);
+	metrics.emplace_back("memory_mib_max", Summarize(memoryMiB).Max);
+
+#ifdef _MSC_VER
+#pragma warning(suppress : 4996)
+#endif
+	FILE* file = fopen(filename, "w");
+	if (!file)
+	{
+		LOG(Error, "Failed to open a file for writing: %s.", filename);
+		return false;
+	}
+
+	const VkExtent2D extent = GRenderer->GetSwapchainExtent();
+
+	std::fprintf(file, "{\n");
+	std::fprintf(file, "\t\"scene\": \"%s\",\n", m_Scene->Name);
+	std::fprintf(file, "\t\"frames\": %zu,\n", m_Frames.size());
+	std::fprintf(file, "\t\"warmup_frames\": %u,\n", GBenchWarmupFrames);
+	std::fprintf(file, "\t\"frames_in_flight\": %d,\n", GMaxDrawFrames);
+	std::fprintf(file, "\t\"width\": %u,\n", extent.width);
+	std::fprintf(file, "\t\"height\": %u,\n", extent.height);
+	std::fprintf(file, "\t\"gpu_timestamps\": %s,\n", GDevice->IsTimestampSupported() ? "true" : "false");
+	std::fprintf(file, "\t\"metrics\": {\n");
+	for (size_t i = 0; i < metrics.size(); ++i)
+	{
+		std::fprintf(file, "\t\t\"%s\": %.4f%s\n", metrics[i].first.c_str(), metrics[i].second, i + 1 < metrics.size() ? "," : "");
+	}
+	std::fprintf(file, "\t}\n");
+	std::fprintf(file, "}\n");
+
+	fclose(file);
+
+	LOG(Log, "Benchmark %s: cpu p50 %.2fms p95 %.2fms p99 %.2fms, gpu p50 %.2fms p95 %.2fms p99 %.2fms.", m_Scene->Name,
+		cpuSummary.P50, cpuSummary.P95, cpuSummary.P99, gpuSummary.P50, gpuSummary.P95, gpuSummary.P99);
+
+	return true;
+}
+
+bool vge::bench::ParseBenchmarkArgs(int argc, const char** argv, ApplicationSpecs& specs)
+{
+	const BenchmarkScene* scene = argc > 2 ? FindScene(argv[2]) : nullptr;
+	if (!scene)
+	{
+		std::printf("Usage: %s %s <scene> [frame count] [output path]\nScenes:\n", argv[0], GBenchSceneArg);
+		for (const BenchmarkScene& availableScene : GScenes)
+		{
+			std::printf(" %-16s %s\n", availableScene.Name, availableScene.Description);
+		}
+		return false;
+	}
+
+	// Optional positional arguments end at first switch, e.g. -frames=2.
+	const bool hasFrameCount = argc > 3 && argv[3][0] != '-';
+	const bool hasOutput = hasFrameCount && argc > 4 && argv[4][0] != '-';
+
+	specs.Headless.Enabled = true;
+	specs.Headless.FrameCount = hasFrameCount ? static_cast<u32>(std::atoi(argv[3])) : GBenchDefaultFrameCount;
+	specs.Benchmark.Scene = scene->Name;
+	specs.Benchmark.Output = hasOutput ? argv[4] : scene->Name;
+
+	if (specs.Headless.FrameCount <= GBenchWarmupFrames)
+	{
+		std::printf("Frame count must be greater than %u warmup frames.\n", GBenchWarmupFrames);
+		return false;
+	}
+
+	return true;
+}
+
+vge::i32 vge::bench::BenchmarkCompareMain(int argc, const char** argv)
+{
+	if (argc < 4)
+	{
+		std::printf("Usage: %s %s <baseline json> <current json> [threshold percent]\n", argv[0], GBenchCompareArg);
+		return EXIT_FAILURE;
+	}
+
+	const f64 threshold = argc > 4 ? std::atof(argv[4]) / 100.0 : GBenchDefaultThreshold;
+
+	std::vector<Metric> baseline, current;
+	if (!ReadMetrics(argv[2], baseline) || !ReadMetrics(argv[3], current))
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::printf("%-24s %12s %12s %9s\n", "Metric", "Baseline", "Current", "Change");
+
+	// All metrics are better when lower.
+	u32 regressionCount = 0;
+	for (const Metric& baseMetric : baseline)
+	{
+		const auto it = std::find_if(current.begin(), current.end(), [&baseMetric](const Metric& metric) { return metric.first == baseMetric.first; });
+		if (it == current.end())
+		{
+			std::printf("%-24s %12.4f %12s\n", baseMetric.first.c_str(), baseMetric.second, "missing");
+			continue;
+		}
+
+		const f64 change = baseMetric.second > 0.0 ? (it->second - baseMetric.second) / baseMetric.second : (it->second > 0.0 ? 1.0 : 0.0);
+		const bool regression = change > threshold;
+		const bool improvement = change < -threshold;
+		regressionCount += regression ? 1 : 0;
+
+		std::printf("%-24s %12.4f %12.4f %+8.1f%% %s\n", baseMetric.first.c_str(), baseMetric.second, it->second, change * 100.0,
+			regression ? "REGRESSION" : (improvement ? "improved" : ""));
+	}
+
+	std::printf("%u regression(s) above %.1f%% threshold.\n", regressionCount, threshold * 100.0);
+
+	return regressionCount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
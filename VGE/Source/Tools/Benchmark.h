@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge
+{
+	struct ApplicationSpecs;
+	class GameSystem;
+	class RenderSystem;
+}
+
+namespace vge::bench
+{
+	inline class Benchmark* GBenchmark = nullptr;
+
+	// Command line switches that run scripted scene benchmark and compare its results.
+	inline constexpr const char* GBenchSceneArg = "-bench-scene";
+	inline constexpr const char* GBenchCompareArg = "-bench-compare";
+
+	inline constexpr u32 GBenchDefaultFrameCount = 1000;
+	// First frames compile pipelines and fill caches, they are written to csv but excluded from statistics.
+	inline constexpr u32 GBenchWarmupFrames = 16;
+	// Relative increase of metric reported as regression by default.
+	inline constexpr f64 GBenchDefaultThreshold = 0.05;
+
+	struct BenchmarkFrame
+	{
+		f64 CpuTimeMs = 0.0;		// from start of frame tick to start of the next one
+		f64 GpuTimeMs = 0.0;		// 0 if timestamps are not supported
+		u32 DrawCallCount = 0;
+		u32 AllocationCount = 0;	// device memory allocations of all resources
+		u64 AllocationBytes = 0;
+		u64 MemoryBytes = 0;		// device memory blocks allocated from driver
+	};
+
+	struct BenchmarkScene;
+
+	// Spawns scripted scene, moves camera along its path and collects per frame statistics.
+	// Application runs headless for fixed frame count, results are written when it finishes.
+	class Benchmark
+	{
+	public:
+		Benchmark() = default;
+		NOT_COPYABLE(Benchmark);
+
+		void Initialize(const ApplicationSpecs& specs);
+		void Destroy();
+
+		// Replaces default test entity, renderer must be initialized.
+		void CreateScene(GameSystem* gameSystem, RenderSystem* renderSystem);
+		// Call at the start of each frame, before input and rendering.
+		void Tick();
+		// Wait for frames in flight, write csv with every frame and json with statistics.
+		void Finish();
+
+	private:
+		const BenchmarkScene* m_Scene = nullptr;
+		const char* m_OutputPath = nullptr;
+		std::vector<BenchmarkFrame> m_Frames = {};
+		f32 m_SceneRadius = 0.0f;
+		f64 m_LastTickTime = 0.0;
+
+	private:
+		void UpdateCamera(f32 progress) const;
+		void CollectRetiredFrames();
+		bool WriteCsv(const char* filename) const;
+		bool WriteJson(const char* filename) const;
+	};
+
+	// Usage: -bench-scene <scene> [frame count] [output path without extension]
+	// Fills specs to run given scene headless, returns false and prints available scenes if arguments are invalid.
+	bool ParseBenchmarkArgs(int argc, const char** argv, ApplicationSpecs& specs);
+
+	// Usage: -bench-compare <baseline json> <current json> [threshold percent]
+	// Returns failure if any metric of current run is worse than baseline by more than threshold.
+	i32 BenchmarkCompareMain(int argc, const char** argv);
+
+	inline Benchmark* CreateBenchmark()
+	{
+		if (GBenchmark) return GBenchmark;
+		return (GBenchmark = new Benchmark());
+	}
+
+	inline bool DestroyBenchmark()
+	{
+		if (!GBenchmark) return false;
+		GBenchmark->Destroy();
+		delete GBenchmark;
+		GBenchmark = nullptr;
+		return true;
+	}
+}
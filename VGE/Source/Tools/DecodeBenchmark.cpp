@@ -0,0 +1,128 @@
+#include "DecodeBenchmark.h"
+#include "File.h"
+#include "Simd.h"
+#include "JobSystem.h"
+#include <filesystem>
+
+namespace
+{
+	struct DecodeTarget
+	{
+		std::string Filename;
+		size_t FileSize = 0;
+		size_t DecodedSize = 0;
+		std::vector<vge::u8> Pixels;
+	};
+
+	bool IsDecodableTexture(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+		return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+	}
+
+	// Returns decode time in seconds.
+	vge::f32 DecodeAll(std::vector<DecodeTarget>& targets, vge::JobSystem* jobSystem)
+	{
+		auto decodeTarget = [&targets](vge::u32 i)
+		{
+			DecodeTarget& target = targets[i];
+			vge::file::DecodeTexture(target.Filename.c_str(), target.Pixels.data(), target.Pixels.size());
+		};
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		if (jobSystem)
+		{
+			jobSystem->ParallelFor(static_cast<vge::u32>(targets.size()), decodeTarget);
+		}
+		else
+		{
+			for (vge::u32 i = 0; i < static_cast<vge::u32>(targets.size()); ++i)
+			{
+				decodeTarget(i);
+			}
+		}
+
+		const auto endTime = std::chrono::steady_clock::now();
+		return std::chrono::duration<vge::f32>(endTime - startTime).count();
+	}
+}
+
+vge::i32 vge::bench::DecodeBenchmarkMain(int argc, const char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf("Usage: %s %s <directory> [thread count]\n", argv[0], GBenchDecodeArg);
+		return EXIT_FAILURE;
+	}
+
+	const char* directory = argv[2];
+	const u32 threadCount = argc > 3 ? static_cast<u32>(std::atoi(argv[3])) : std::thread::hardware_concurrency();
+
+	std::vector<DecodeTarget> targets;
+	size_t totalFileSize = 0;
+	size_t totalDecodedSize = 0;
+
+	std::error_code error;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+	{
+		if (!entry.is_regular_file() || !IsDecodableTexture(entry.path()))
+		{
+			continue;
+		}
+
+		DecodeTarget target = {};
+		target.Filename = entry.path().string();
+
+		i32 width = 0, height = 0, channels = 0;
+		if (!file::GetTextureInfo(target.Filename.c_str(), width, height, channels))
+		{
+			continue;
+		}
+
+		target.FileSize = static_cast<size_t>(entry.file_size());
+		target.DecodedSize = static_cast<size_t>(width) * height * 4;
+		target.Pixels.resize(target.DecodedSize);
+
+		totalFileSize += target.FileSize;
+		totalDecodedSize += target.DecodedSize;
+		targets.push_back(std::move(target));
+	}
+
+	if (targets.empty())
+	{
+		std::printf("No textures found in %s\n", directory);
+		return EXIT_FAILURE;
+	}
+
+	constexpr f32 MB = 1024.0f * 1024.0f;
+	std::printf("Decoding %zu textures: %.2f MB compressed, %.2f MB decoded, SSSE3: %s\n",
+		targets.size(), totalFileSize / MB, totalDecodedSize / MB, simd::HasSSSE3() ? "yes" : "no");
+
+	// Warm up file cache so that both runs measure decoding rather than disk.
+	DecodeAll(targets, nullptr);
+
+	const f32 singleTime = DecodeAll(targets, nullptr);
+	const f32 singleRate = totalDecodedSize / MB / singleTime;
+	std::printf(" 1 thread:   %8.2fms, %8.2f MB/s, %8.2f MB/s per core\n", singleTime * 1000.0f, singleRate, singleRate);
+
+	// Calling thread decodes too, so it is not counted as worker. Job system with 0 workers would take hardware default instead.
+	const u32 workerCount = threadCount > 1 ? threadCount - 1 : 0;
+
+	JobSystem jobSystem;
+	if (workerCount > 0)
+	{
+		jobSystem.Initialize(workerCount);
+	}
+
+	const u32 decodeThreadCount = workerCount + 1;
+	const f32 parallelTime = DecodeAll(targets, workerCount > 0 ? &jobSystem : nullptr);
+	const f32 parallelRate = totalDecodedSize / MB / parallelTime;
+	std::printf(" %u threads: %8.2fms, %8.2f MB/s, %8.2f MB/s per core, %.2fx speedup\n", decodeThreadCount,
+		parallelTime * 1000.0f, parallelRate, parallelRate / decodeThreadCount, singleTime / parallelTime);
+
+	jobSystem.Destroy();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge::bench
+{
+	// Command line switch that runs texture decode benchmark instead of the application.
+	inline constexpr const char* GBenchDecodeArg = "-bench-decode";
+
+	// Usage: -bench-decode <directory> [thread count]
+	// Decode all textures from directory single threaded and on job system, report MB/s total and per core.
+	i32 DecodeBenchmarkMain(int argc, const char** argv);
+}
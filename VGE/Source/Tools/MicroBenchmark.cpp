@@ -0,0 +1,531 @@
+#include "MicroBenchmark.h"
+#include "JobSystem.h"
+#include "Game/Camera.h"
+#include "Game/TransformBatch.h"
+#include "Game/TransformHierarchy.h"
+#include "ECS/Coordinator.h"
+#include "ECS/ComponentArray.h"
+#include "ECS/EntityManager.h"
+#include "ECS/SystemManager.h"
+#include "Components/TransformComponent.h"
+#include "Components/HierarchyComponent.h"
+#include <chrono>
+#include <random>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr vge::u32 GRepetitionCount = 5;
+	constexpr vge::f64 GDefaultMinTimeMs = 50.0;
+
+	// Timer of single benchmark run, body starts and stops it around measured code so setup is excluded.
+	struct MicroBenchmarkContext
+	{
+		vge::u64 Iterations = 0;	// operations to run in total
+		Clock::duration Elapsed = {};
+		Clock::time_point StartTime = {};
+
+		inline void Start() { StartTime = Clock::now(); }
+		inline void Stop() { Elapsed += Clock::now() - StartTime; }
+	};
+
+	using MicroBenchmarkFunc = void(*)(MicroBenchmarkContext& context);
+
+	struct MicroBenchmark
+	{
+		const char* Name = nullptr;	// also metric name in json
+		MicroBenchmarkFunc Func = nullptr;
+	};
+
+#if defined(_MSC_VER)
+	volatile const void* GSink = nullptr;
+#endif
+
+	// Keeps compiler from removing computation of value which is not used otherwise.
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER)
+		GSink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// The same shuffled entities on every run.
+	std::vector<vge::Entity> MakeShuffledEntities()
+	{
+		std::vector<vge::Entity> entities(vge::GMaxEntities);
+		for (vge::Entity entity = 0; entity < vge::GMaxEntities; ++entity)
+		{
+			entities[entity] = entity;
+		}
+
+		std::mt19937 random(42);
+		std::shuffle(entities.begin(), entities.end(), random);
+
+		return entities;
+	}
+
+	// Entity count is limited, so container benchmarks run in batches of at most all entities.
+	template<typename Functor>
+	void ForEachBatch(MicroBenchmarkContext& context, Functor functor)
+	{
+		for (vge::u64 done = 0; done < context.Iterations; done += vge::GMaxEntities)
+		{
+			functor(static_cast<vge::u32>(std::min<vge::u64>(context.Iterations - done, vge::GMaxEntities)));
+		}
+	}
+
+	void ComponentArrayAdd(MicroBenchmarkContext& context)
+	{
+		const std::vector<vge::Entity> entities = MakeShuffledEntities();
+		auto components = std::make_unique<vge::ComponentArray<vge::TransformComponent>>();
+
+		ForEachBatch(context, [&](vge::u32 count)
+		{
+			context.Start();
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				components->Add(entities[i], vge::TransformComponent());
+			}
+			context.Stop();
+
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				components->Remove(entities[i]);
+			}
+		});
+	}
+
+	void ComponentArrayRemove(MicroBenchmarkContext& context)
+	{
+		const std::vector<vge::Entity> entities = MakeShuffledEntities();
+		auto components = std::make_unique<vge::ComponentArray<vge::TransformComponent>>();
+
+		ForEachBatch(context, [&](vge::u32 count)
+		{
+			// Added in order and removed shuffled, so removal moves components from the end.
+			for (vge::Entity entity = 0; entity < count; ++entity)
+			{
+				components->Add(entity, vge::TransformComponent());
+			}
+
+			context.Start();
+			for (const vge::Entity entity : entities)
+			{
+				if (entity < count)
+				{
+					components->Remove(entity);
+				}
+			}
+			context.Stop();
+		});
+	}
+
+	void ComponentArrayGet(MicroBenchmarkContext& context)
+	{
+		const std::vector<vge::Entity> entities = MakeShuffledEntities();
+		auto components = std::make_unique<vge::ComponentArray<vge::TransformComponent>>();
+
+		for (const vge::Entity entity : entities)
+		{
+			components->Add(entity, vge::TransformComponent());
+		}
+
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			DoNotOptimize(components->Get(entities[i % vge::GMaxEntities]));
+		}
+		context.Stop();
+	}
+
+	void EntityManagerCreate(MicroBenchmarkContext& context)
+	{
+		auto entityManager = std::make_unique<vge::EntityManager>();
+		std::vector<vge::Entity> created(vge::GMaxEntities);
+
+		ForEachBatch(context, [&](vge::u32 count)
+		{
+			context.Start();
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				created[i] = entityManager->Create();
+			}
+			context.Stop();
+
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				entityManager->Destroy(created[i]);
+			}
+		});
+	}
+
+	void EntityManagerDestroy(MicroBenchmarkContext& context)
+	{
+		auto entityManager = std::make_unique<vge::EntityManager>();
+		std::vector<vge::Entity> created(vge::GMaxEntities);
+
+		ForEachBatch(context, [&](vge::u32 count)
+		{
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				created[i] = entityManager->Create();
+			}
+
+			context.Start();
+			for (vge::u32 i = 0; i < count; ++i)
+			{
+				entityManager->Destroy(created[i]);
+			}
+			context.Stop();
+		});
+	}
+
+	template<vge::u32 Index>
+	class MicroBenchmarkSystem : public vge::System {};
+
+	void SystemManagerEntitySignatureChanged(MicroBenchmarkContext& context)
+	{
+		constexpr vge::u32 systemCount = 4;
+
+		vge::SystemManager systemManager;
+		systemManager.RegisterSystem<MicroBenchmarkSystem<0>>();
+		systemManager.RegisterSystem<MicroBenchmarkSystem<1>>();
+		systemManager.RegisterSystem<MicroBenchmarkSystem<2>>();
+		systemManager.RegisterSystem<MicroBenchmarkSystem<3>>();
+
+		// Every system requires own component and the first one, like render and game systems require transform.
+		vge::Signature systemSignatures[systemCount] = {};
+		for (vge::u32 i = 0; i < systemCount; ++i)
+		{
+			systemSignatures[i].set(0);
+			systemSignatures[i].set(i + 1);
+		}
+
+		systemManager.SetSignature<MicroBenchmarkSystem<0>>(systemSignatures[0]);
+		systemManager.SetSignature<MicroBenchmarkSystem<1>>(systemSignatures[1]);
+		systemManager.SetSignature<MicroBenchmarkSystem<2>>(systemSignatures[2]);
+		systemManager.SetSignature<MicroBenchmarkSystem<3>>(systemSignatures[3]);
+
+		// Entity signatures alternate, so every change adds entity to some systems and removes from others.
+		const std::vector<vge::Entity> entities = MakeShuffledEntities();
+		const vge::Signature entitySignatures[] = { systemSignatures[0] | systemSignatures[1], systemSignatures[2], systemSignatures[3] | systemSignatures[1] };
+
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			systemManager.EntitySignatureChanged(entities[i % vge::GMaxEntities], entitySignatures[i % C_ARRAY_NUM(entitySignatures)]);
+		}
+		context.Stop();
+	}
+
+	void TransformComponentGetMat4(MicroBenchmarkContext& context)
+	{
+		constexpr vge::u32 transformCount = 1024;
+
+		std::vector<vge::TransformComponent> transforms(transformCount);
+		for (vge::u32 i = 0; i < transformCount; ++i)
+		{
+			transforms[i].Translation = glm::vec3(static_cast<vge::f32>(i), 1.0f, -static_cast<vge::f32>(i));
+			transforms[i].Rotation = glm::vec3(static_cast<vge::f32>(i % 360), static_cast<vge::f32>(i * 7 % 360), static_cast<vge::f32>(i * 13 % 360));
+			transforms[i].Scale = glm::vec3(1.0f + static_cast<vge::f32>(i % 4));
+		}
+
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			DoNotOptimize(transforms[i % transformCount].GetMat4());
+		}
+		context.Stop();
+	}
+
+	void FillTransformBatch(vge::TransformBatch& batch, vge::u32 count)
+	{
+		for (vge::u32 i = 0; i < count; ++i)
+		{
+			vge::TransformComponent transform = {};
+			transform.Translation = glm::vec3(static_cast<vge::f32>(i), 1.0f, -static_cast<vge::f32>(i));
+			transform.Rotation = glm::vec3(static_cast<vge::f32>(i % 360), static_cast<vge::f32>(i * 7 % 360), static_cast<vge::f32>(i * 13 % 360));
+			transform.Scale = glm::vec3(1.0f + static_cast<vge::f32>(i % 4));
+			batch.Add(transform);
+		}
+	}
+
+	void TransformBatchCompute(MicroBenchmarkContext& context)
+	{
+		vge::TransformBatch batch;
+		FillTransformBatch(batch, vge::GMaxEntities);
+
+		context.Start();
+		for (vge::u64 done = 0; done < context.Iterations; done += batch.GetCount())
+		{
+			batch.Compute();
+			DoNotOptimize(batch.GetMatrices());
+		}
+		context.Stop();
+	}
+
+	void TransformBatchComputeParallel(MicroBenchmarkContext& context)
+	{
+		// Enough chunks to keep every thread busy.
+		vge::JobSystem jobSystem;
+		jobSystem.Initialize();
+
+		vge::TransformBatch batch;
+		FillTransformBatch(batch, vge::GTransformBatchChunkSize * jobSystem.GetThreadCount() * 4);
+
+		context.Start();
+		for (vge::u64 done = 0; done < context.Iterations; done += batch.GetCount())
+		{
+			batch.Compute(&jobSystem);
+			DoNotOptimize(batch.GetMatrices());
+		}
+		context.Stop();
+
+		jobSystem.Destroy();
+	}
+
+	void TransformHierarchyPropagate(MicroBenchmarkContext& context)
+	{
+		vge::CreateCoordinator();
+		vge::GCoordinator->Initialize();
+		vge::GCoordinator->RegisterComponent<vge::TransformComponent>();
+		vge::GCoordinator->RegisterComponent<vge::HierarchyComponent>();
+
+		// Every entity has four children, so moving the root moves the whole tree.
+		std::vector<vge::Entity> entities(vge::GMaxEntities);
+		for (vge::u32 i = 0; i < vge::GMaxEntities; ++i)
+		{
+			entities[i] = vge::GCoordinator->CreateEntity();
+
+			vge::TransformComponent transform = {};
+			transform.Translation = glm::vec3(1.0f, 0.0f, static_cast<vge::f32>(i % 4));
+			transform.Rotation = glm::vec3(0.0f, static_cast<vge::f32>(i % 360), 0.0f);
+			vge::GCoordinator->AddComponent(entities[i], transform);
+
+			if (i > 0)
+			{
+				vge::HierarchyComponent hierarchy = {};
+				hierarchy.Parent = entities[(i - 1) / 4];
+				vge::GCoordinator->AddComponent(entities[i], hierarchy);
+			}
+		}
+
+		vge::TransformHierarchy hierarchy;
+		hierarchy.Initialize();
+		hierarchy.Update();
+
+		context.Start();
+		for (vge::u64 done = 0; done < context.Iterations; done += hierarchy.GetEntityCount())
+		{
+			vge::GCoordinator->GetComponent<vge::TransformComponent>(entities[0])->Translation.x += 1.0f;
+			vge::GCoordinator->MarkComponentChanged<vge::TransformComponent>(entities[0]);
+			hierarchy.Update();
+			DoNotOptimize(hierarchy.GetWorldMatrix(entities.back()));
+		}
+		context.Stop();
+
+		hierarchy.Destroy();
+		vge::DestroyCoordinator();
+	}
+
+	void CameraSetViewYXZ(MicroBenchmarkContext& context)
+	{
+		vge::Camera camera;
+
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			const vge::f32 value = static_cast<vge::f32>(i % 1024);
+			camera.SetViewYXZ(glm::vec3(value, 2.0f, -value), glm::vec3(value * 0.01f, value * 0.02f, 0.0f));
+			DoNotOptimize(camera.GetViewMatrix());
+		}
+		context.Stop();
+	}
+
+	void MemoryAllocFree(MicroBenchmarkContext& context)
+	{
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			vge::TransformComponent* transform = vge::memory::Alloc<vge::TransformComponent>();
+			DoNotOptimize(transform);
+			vge::memory::Free(transform);
+		}
+		context.Stop();
+	}
+
+	void MemoryAllocAlignedFree(MicroBenchmarkContext& context)
+	{
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			void* data = vge::memory::AllocAligned(sizeof(glm::mat4), 64);
+			DoNotOptimize(data);
+			vge::memory::FreeAligned(data);
+		}
+		context.Stop();
+	}
+
+	void MemoryMemcopy4K(MicroBenchmarkContext& context)
+	{
+		constexpr size_t size = 4096;
+
+		std::vector<vge::u8> src(size, 1);
+		std::vector<vge::u8> dst(size);
+
+		context.Start();
+		for (vge::u64 i = 0; i < context.Iterations; ++i)
+		{
+			vge::memory::Memcopy(dst.data(), src.data(), size);
+			DoNotOptimize(dst[i % size]);
+		}
+		context.Stop();
+	}
+
+	constexpr MicroBenchmark GMicroBenchmarks[] =
+	{
+		{ "component_array_add",						ComponentArrayAdd },
+		{ "component_array_remove",						ComponentArrayRemove },
+		{ "component_array_get",						ComponentArrayGet },
+		{ "entity_manager_create",						EntityManagerCreate },
+		{ "entity_manager_destroy",						EntityManagerDestroy },
+		{ "system_manager_entity_signature_changed",	SystemManagerEntitySignatureChanged },
+		{ "transform_component_get_mat4",				TransformComponentGetMat4 },
+		{ "transform_batch_compute",					TransformBatchCompute },
+		{ "transform_batch_compute_parallel",			TransformBatchComputeParallel },
+		{ "transform_hierarchy_propagate",				TransformHierarchyPropagate },
+		{ "camera_set_view_yxz",						CameraSetViewYXZ },
+		{ "memory_alloc_free",							MemoryAllocFree },
+		{ "memory_alloc_aligned_free",					MemoryAllocAlignedFree },
+		{ "memory_memcopy_4k",							MemoryMemcopy4K },
+	};
+
+	vge::f64 RunOnce(const MicroBenchmark& benchmark, vge::u64 iterations)
+	{
+		MicroBenchmarkContext context = {};
+		context.Iterations = iterations;
+		benchmark.Func(context);
+		return std::chrono::duration<vge::f64, std::nano>(context.Elapsed).count();
+	}
+
+	// Grows iteration count until run takes at least min time, so timer resolution and call overhead are negligible.
+	vge::u64 CalibrateIterations(const MicroBenchmark& benchmark, vge::f64 minTimeNs)
+	{
+		vge::u64 iterations = 64;
+		while (true)
+		{
+			const vge::f64 elapsedNs = RunOnce(benchmark, iterations);
+			if (elapsedNs >= minTimeNs)
+			{
+				return iterations;
+			}
+
+			// Aim a bit above min time, but grow at most 10 times per step in case first runs were too fast to measure.
+			const vge::f64 scale = elapsedNs > 0.0 ? std::clamp(minTimeNs * 1.2 / elapsedNs, 2.0, 10.0) : 10.0;
+			iterations = static_cast<vge::u64>(static_cast<vge::f64>(iterations) * scale);
+		}
+	}
+}
+
+vge::i32 vge::bench::MicroBenchmarkMain(int argc, const char** argv)
+{
+	const char* filter = nullptr;
+	const char* output = nullptr;
+	f64 minTimeMs = GDefaultMinTimeMs;
+
+	for (i32 argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const char* arg = argv[argIndex];
+
+		if (std::strncmp(arg, "-filter=", 8) == 0)
+		{
+			filter = arg + 8;
+		}
+		else if (std::strncmp(arg, "-output=", 8) == 0)
+		{
+			output = arg + 8;
+		}
+		else if (std::strncmp(arg, "-min_time=", 10) == 0)
+		{
+			minTimeMs = std::atof(arg + 10);
+		}
+	}
+
+	using Metric = std::pair<const char*, f64>;
+	std::vector<Metric> metrics;
+
+	std::printf("%-40s %12s %12s %12s %12s\n", "Benchmark", "Iterations", "Median ns", "Min ns", "Ops/ms");
+
+	for (const MicroBenchmark& benchmark : GMicroBenchmarks)
+	{
+		if (filter && !std::strstr(benchmark.Name, filter))
+		{
+			continue;
+		}
+
+		const u64 iterations = CalibrateIterations(benchmark, minTimeMs * 1'000'000.0);
+
+		std::array<f64, GRepetitionCount> timesPerOp = {};
+		for (f64& timePerOp : timesPerOp)
+		{
+			timePerOp = RunOnce(benchmark, iterations) / static_cast<f64>(iterations);
+		}
+
+		// Median is reported as it is less affected by other processes than mean.
+		std::sort(timesPerOp.begin(), timesPerOp.end());
+		const f64 median = timesPerOp[GRepetitionCount / 2];
+
+		std::printf("%-40s %12llu %12.2f %12.2f %12.0f\n", benchmark.Name, static_cast<unsigned long long>(iterations), median, timesPerOp.front(), 1'000'000.0 / median);
+		metrics.emplace_back(benchmark.Name, median);
+	}
+
+	if (!output)
+	{
+		return EXIT_SUCCESS;
+	}
+
+	const std::string jsonFilename = std::string(output) + ".json";
+
+#ifdef _MSC_VER
+#pragma warning(suppress : 4996)
+#endif
+	FILE* file = fopen(jsonFilename.c_str(), "w");
+	if (!file)
+	{
+		std::printf("Failed to open %s for writing\n", jsonFilename.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::fprintf(file, "{\n");
+	std::fprintf(file, "\t\"repetitions\": %u,\n", GRepetitionCount);
+	std::fprintf(file, "\t\"metrics\": {\n");
+	for (size_t i = 0; i < metrics.size(); ++i)
+	{
+		std::fprintf(file, "\t\t\"%s_ns\": %.4f%s\n", metrics[i].first, metrics[i].second, i + 1 < metrics.size() ? "," : "");
+	}
+	std::fprintf(file, "\t}\n");
+	std::fprintf(file, "}\n");
+
+	fclose(file);
+
+	std::printf("Results written to %s\n", jsonFilename.c_str());
+
+	return EXIT_SUCCESS;
+}
+
+#if MICROBENCH_MAIN
+// Entry of standalone cpu only build.
+int main(int argc, const char** argv)
+{
+	return vge::bench::MicroBenchmarkMain(argc, argv);
+}
+#endif
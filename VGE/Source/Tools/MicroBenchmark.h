@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Common.h"
+
+namespace vge::bench
+{
+	// Command line switch that runs cpu microbenchmarks instead of the application.
+	inline constexpr const char* GBenchMicroArg = "-bench-micro";
+
+	// Usage: -bench-micro [-filter=substring] [-output=path without extension] [-min_time=ms]
+	// Times ecs, math and memory primitives, prints ns and operations (e.g. matrices) per ms and optionally writes json comparable with -bench-compare.
+	// Depends only on cpu code, so it is also built standalone without Vulkan and GLFW by build_microbench.sh.
+	i32 MicroBenchmarkMain(int argc, const char** argv);
+}
@@ -0,0 +1,119 @@
+#include "TextureCooker.h"
+#include "File.h"
+
+vge::bc::BlockFormat vge::cook::ChooseFormat(const u8* rgba, u32 width, u32 height)
+{
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+	for (size_t i = 0; i < pixelCount; ++i)
+	{
+		if (rgba[i * 4 + 3] != 255)
+		{
+			return bc::BlockFormat::BC3;
+		}
+	}
+
+	return bc::BlockFormat::BC1;
+}
+
+bool vge::cook::CookTexture(const char* filename, bc::BlockFormat format, TextureCookStats* outStats /*= nullptr*/)
+{
+	i32 width = 0, height = 0;
+	VkDeviceSize textureSize = 0;
+	stbi_uc* textureData = file::LoadTexture(filename, width, height, textureSize);
+
+	if (!textureData)
+	{
+		return false;
+	}
+
+	if (format == bc::BlockFormat::None)
+	{
+		format = ChooseFormat(textureData, static_cast<u32>(width), static_cast<u32>(height));
+	}
+
+	const auto startTime = std::chrono::steady_clock::now();
+
+	std::vector<u8> blocks;
+	bc::CompressImage(format, textureData, static_cast<u32>(width), static_cast<u32>(height), blocks);
+
+	const auto endTime = std::chrono::steady_clock::now();
+
+	file::FreeTexture(textureData);
+
+	bc::CookedTextureHeader header = {};
+	header.Format = format;
+	header.Width = static_cast<u32>(width);
+	header.Height = static_cast<u32>(height);
+	header.MipCount = 1;
+	header.DataSize = blocks.size();
+
+	const std::string cookedPath = file::GetCookedTexturePath(filename);
+	if (!file::SaveCookedTexture(cookedPath.c_str(), header, blocks.data()))
+	{
+		return false;
+	}
+
+	if (outStats)
+	{
+		outStats->SourceSize = static_cast<size_t>(textureSize);
+		outStats->CookedSize = blocks.size();
+		outStats->Milliseconds = std::chrono::duration<f32, std::chrono::milliseconds::period>(endTime - startTime).count();
+	}
+
+	return true;
+}
+
+vge::i32 vge::cook::CookTexturesMain(int argc, const char** argv)
+{
+	// argv[0] - executable, argv[1] - cook switch.
+	i32 argIndex = 2;
+
+	bc::BlockFormat format = bc::BlockFormat::None;
+	if (argIndex < argc)
+	{
+		const bc::BlockFormat requested = bc::FormatFromString(argv[argIndex]);
+		if (requested != bc::BlockFormat::None || std::strcmp(argv[argIndex], "auto") == 0)
+		{
+			format = requested;
+			++argIndex;
+		}
+	}
+
+	if (argIndex >= argc)
+	{
+		std::printf("Usage: %s %s [auto|bc1|bc3|bc5|bc7] <files...>\n", argv[0], GCookTexturesArg);
+		return EXIT_FAILURE;
+	}
+
+	TextureCookStats totalStats = {};
+	i32 failedCount = 0;
+
+	for (; argIndex < argc; ++argIndex)
+	{
+		const char* filename = argv[argIndex];
+
+		TextureCookStats stats = {};
+		if (!CookTexture(filename, format, &stats))
+		{
+			std::printf("Failed to cook %s\n", filename);
+			++failedCount;
+			continue;
+		}
+
+		const f32 mbPerSec = stats.Milliseconds > 0.0f ? (stats.SourceSize / (1024.0f * 1024.0f)) / (stats.Milliseconds / 1000.0f) : 0.0f;
+		std::printf("%s: %zu -> %zu bytes (%.2f:1), %.2fms, %.1f MB/s\n", filename, stats.SourceSize, stats.CookedSize,
+			static_cast<f32>(stats.SourceSize) / stats.CookedSize, stats.Milliseconds, mbPerSec);
+
+		totalStats.SourceSize += stats.SourceSize;
+		totalStats.CookedSize += stats.CookedSize;
+		totalStats.Milliseconds += stats.Milliseconds;
+	}
+
+	if (totalStats.CookedSize > 0)
+	{
+		std::printf("Total: %zu -> %zu bytes (%.2f:1), %.2fms\n", totalStats.SourceSize, totalStats.CookedSize,
+			static_cast<f32>(totalStats.SourceSize) / totalStats.CookedSize, totalStats.Milliseconds);
+	}
+
+	return failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
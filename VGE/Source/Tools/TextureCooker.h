@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Common.h"
+#include "Renderer/BlockCompression.h"
+
+namespace vge::cook
+{
+	// Command line switch that runs texture cooker instead of the application.
+	inline constexpr const char* GCookTexturesArg = "-cook";
+
+	struct TextureCookStats
+	{
+		size_t SourceSize = 0;
+		size_t CookedSize = 0;
+		f32 Milliseconds = 0.0f;
+	};
+
+	// Pick BC1 for opaque textures and BC3 for textures with alpha.
+	bc::BlockFormat ChooseFormat(const u8* rgba, u32 width, u32 height);
+
+	// Load source texture, compress it and save next to the source as *.vtex file.
+	bool CookTexture(const char* filename, bc::BlockFormat format, TextureCookStats* outStats = nullptr);
+
+	// Usage: -cook [auto|bc1|bc3|bc5|bc7] <files...>
+	i32 CookTexturesMain(int argc, const char** argv);
+}
@@ -7,6 +7,7 @@ namespace vge
 	using ptr_size = std::uintptr_t;
 
 	using f32	= float;
+	using f64	= double;
 
 	using i8	= std::int8_t;
 	using i16	= std::int16_t;
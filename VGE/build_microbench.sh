@@ -0,0 +1,22 @@
+#!/bin/sh
+# Standalone build of cpu microbenchmarks for non Windows platforms, Vulkan SDK and GLFW are not required.
+# Usage: ./build_microbench.sh && Bin/microbench [-filter=substring] [-output=path] [-min_time=ms]
+set -e
+cd "$(dirname "$0")"
+
+CXX="${CXX:-c++}"
+
+mkdir -p Bin
+
+"$CXX" -std=c++17 -O2 -Wall -DNDEBUG -DWITH_VULKAN=0 -DMICROBENCH_MAIN=1 \
+	-ISource -ISource/Game -IVendor \
+	Source/Logging.cpp \
+	Source/Simd.cpp \
+	Source/JobSystem.cpp \
+	Source/Game/Camera.cpp \
+	Source/Game/TransformBatch.cpp \
+	Source/Game/TransformHierarchy.cpp \
+	Source/Game/ECS/EntityManager.cpp \
+	Source/Game/Components/TransformComponent.cpp \
+	Source/Tools/MicroBenchmark.cpp \
+	-pthread -o Bin/microbench
@@ -1,4 +1,10 @@
-C:\VulkanSDK\1.3.250.1\Bin\glslangValidator.exe -o Shaders/Bin/first_vert.spv  -V Shaders/first.vert
-C:\VulkanSDK\1.3.250.1\Bin\glslangValidator.exe -o Shaders/Bin/first_frag.spv  -V Shaders/first.frag
-C:\VulkanSDK\1.3.250.1\Bin\glslangValidator.exe -o Shaders/Bin/second_vert.spv -V Shaders/second.vert
-C:\VulkanSDK\1.3.250.1\Bin\glslangValidator.exe -o Shaders/Bin/second_frag.spv -V Shaders/second.frag
+@echo off
+rem Manual shader build, VGE.vcxproj compiles shaders as custom build step. Keep in sync with GShaderBuilds.
+if not exist Shaders\Bin mkdir Shaders\Bin
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/first_vert.spv  -V Shaders/first.vert
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/first_normal_vert.spv -V -DVERTEX_NORMAL Shaders/first.vert
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/first_normal_float_vert.spv -V -DVERTEX_NORMAL -DVERTEX_NORMAL_FLOAT Shaders/first.vert
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/first_frag.spv  -V Shaders/first.frag
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/first_bindless_frag.spv -V -DBINDLESS Shaders/first.frag
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/second_vert.spv -V Shaders/second.vert
+"%VULKAN_SDK%\Bin\glslangValidator.exe" -o Shaders/Bin/second_frag.spv -V Shaders/second.frag
@@ -0,0 +1,35 @@
+#!/bin/sh
+# Offline shader build for non Windows platforms, keep in sync with GShaderBuilds.
+# Shader is recompiled only when hash of its source and defines differs from the stored one.
+set -e
+cd "$(dirname "$0")"
+
+if [ -n "$VULKAN_SDK" ]; then
+	GLSLANG="$VULKAN_SDK/bin/glslangValidator"
+else
+	GLSLANG="glslangValidator"
+fi
+
+mkdir -p Shaders/Bin
+
+compile() {
+	source="$1"
+	output="$2"
+	defines="$3"
+
+	hash=$( (cat "$source"; echo "$defines") | sha1sum | cut -d ' ' -f 1)
+	if [ -f "$output" ] && [ -f "$output.sha1" ] && [ "$(cat "$output.sha1")" = "$hash" ]; then
+		return
+	fi
+
+	"$GLSLANG" -V $defines -o "$output" "$source"
+	echo "$hash" > "$output.sha1"
+}
+
+compile Shaders/first.vert Shaders/Bin/first_vert.spv ""
+compile Shaders/first.vert Shaders/Bin/first_normal_vert.spv "-DVERTEX_NORMAL"
+compile Shaders/first.vert Shaders/Bin/first_normal_float_vert.spv "-DVERTEX_NORMAL -DVERTEX_NORMAL_FLOAT"
+compile Shaders/first.frag Shaders/Bin/first_frag.spv ""
+compile Shaders/first.frag Shaders/Bin/first_bindless_frag.spv "-DBINDLESS"
+compile Shaders/second.vert Shaders/Bin/second_vert.spv ""
+compile Shaders/second.frag Shaders/Bin/second_frag.spv ""